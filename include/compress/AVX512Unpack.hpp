@@ -0,0 +1,119 @@
+/*-----------------------------------------------------------------------------
+ *  AVX512Unpack.hpp - Unpacking kernels with AVX-512 VBMI for any width.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef AVX512UNPACK_HPP
+#define AVX512UNPACK_HPP
+
+#include <immintrin.h>
+
+#include "open_coders.hpp"
+
+/* The same as BMI2Unpack, the kernels are compiled regardless of -march */
+#define __avx512_target \
+        __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+
+/*
+ * A value is gathered from 4 bytes with vpermb, so the max width is
+ * 25 bits for any bit offset in a byte.
+ */
+#define AVX512_MAXWIDTH 25
+
+/* # of 32-bit lanes in a zmm register */
+#define AVX512_LANES    16
+
+class AVX512Unpack {
+        public:
+                /*
+                 * True if a CPU has AVX-512F/BW/VBMI, e.g., Ice Lake or
+                 * later. Setting OPEN_CODERS_NO_AVX512 in the environment
+                 * disables the kernels for comparison.
+                 */
+                static bool available(void);
+
+                /*
+                 * Byte indices for vpermb and shift counts for vpsrlvd to
+                 * extract 16 values of B bits at the bit offset of 0 or 16
+                 * in a first word.
+                 */
+                static uint8_t          perm[AVX512_MAXWIDTH + 1][2][64]
+                        __attribute__((aligned(64)));
+                static uint32_t         shift[AVX512_MAXWIDTH + 1][2][AVX512_LANES]
+                        __attribute__((aligned(64)));
+
+                /*
+                 * Unpack n (<= 16) values of B bits from the bit offset
+                 * pos into lanes. The offset should be a multiple of 16,
+                 * and no word out of n values is touched.
+                 */
+                template <uint32_t B>
+                static inline __m512i unpack16(uint32_t *in,
+                                uint64_t pos, uint32_t n)
+                        __avx512_target __attribute__((always_inline));
+
+                /*
+                 * Unpack n values of B bits as the other unpackers, but
+                 * neither a word nor a value out of n is touched with
+                 * masked loads and stores.
+                 */
+                template <uint32_t B>
+                static inline void unpack(uint32_t *out,
+                                uint32_t *in, uint32_t n)
+                        __avx512_target __attribute__((always_inline));
+};
+
+template <uint32_t B>
+inline __m512i
+AVX512Unpack::unpack16(uint32_t *in, uint64_t pos, uint32_t n)
+{
+        uint32_t        o;
+        uint32_t        nw;
+        __mmask64       ki;
+        __m512i         v;
+
+        /*
+         * The words that hold n values are loaded, and the 4 bytes holding
+         * each value are permuted into its lane, with the MSB first as
+         * 32-bit integers. Then, the lane is shifted and masked.
+         */
+        o = (pos >> 4) & 1;
+        nw = (16 * o + n * B + 31) >> 5;
+        ki = (nw >= 16)? ~0ULL : (1ULL << (4 * nw)) - 1;
+
+        v = _mm512_maskz_loadu_epi8(ki, in + (pos >> 5));
+
+        /* The maskz forms avoid -Wuninitialized in GCC's headers */
+        v = _mm512_maskz_permutexvar_epi8(~0ULL,
+                        _mm512_load_si512(perm[B][o]), v);
+        v = _mm512_maskz_srlv_epi32(0xffff, v,
+                        _mm512_load_si512(shift[B][o]));
+
+        return _mm512_and_si512(v, _mm512_set1_epi32((1U << B) - 1));
+}
+
+template <uint32_t B>
+inline void
+AVX512Unpack::unpack(uint32_t *out, uint32_t *in, uint32_t n)
+{
+        uint32_t        i;
+
+        for (i = 0; i + AVX512_LANES <= n; i += AVX512_LANES)
+                _mm512_storeu_si512(out + i,
+                                unpack16<B>(in, (uint64_t)i * B, AVX512_LANES));
+
+        if (i < n)
+                _mm512_mask_storeu_epi32(out + i, (1U << (n - i)) - 1,
+                                unpack16<B>(in, (uint64_t)i * B, n - i));
+}
+
+#endif /* AVX512UNPACK_HPP */
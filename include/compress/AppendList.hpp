@@ -0,0 +1,130 @@
+/*-----------------------------------------------------------------------------
+ *  AppendList.hpp - A compressed list growing by appended docIDs.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef APPENDLIST_HPP
+#define APPENDLIST_HPP
+
+#include <pthread.h>
+#include <boost/shared_array.hpp>
+
+#include "open_coders.hpp"
+#include "compress/BatchDecoder.hpp"
+
+/*
+ * # of d-gaps in a sealed block. A block is encoded by itself, so
+ * coders (e.g., VSE) only run over a block when it is sealed.
+ */
+#define APPEND_BLOCKSZ          1024
+
+/*
+ * A word in place of a compressed size, which is followed by
+ * TAIL_MERGIN words skipped over (See AppendList::snapshot()).
+ */
+#define APPEND_SLACK            UINT32_MAX
+
+typedef void (*pt2Enc)(uint32_t *, uint32_t, uint32_t *, uint32_t &);
+
+/*
+ * Sealed blocks, each headed by its compressed size as chunks of a
+ * long list, and slack records in between. An area is shared with
+ * snapshots, and it is replaced with a larger copy to grow, so
+ * snapshots keep an old one.
+ */
+typedef boost::shared_array<uint32_t>   AppendArea;
+
+/*
+ * A consistent view of a list at a time. It has sealed blocks up to
+ * the time and a copy of a tail, so it stays valid while the list
+ * grows and is read without locks.
+ */
+class AppendSnapshot {
+        friend class AppendList;
+
+        private:
+                pt2Dec          dec;
+                AppendArea      cmp;
+                uint64_t        cmplen;
+                uint32_t        num;
+                uint32_t        first;
+                uint32_t        ntail;
+                uint32_t        tail[APPEND_BLOCKSZ];
+
+        public:
+                AppendSnapshot();
+
+                /* # of docIDs, and a first one */
+                uint32_t size() {
+                        return num;
+                }
+
+                uint32_t firstDoc() {
+                        return first;
+                }
+
+                /* # of words in sealed blocks with slack records, and a tail */
+                uint64_t sizeInWords() {
+                        return cmplen + ntail;
+                }
+
+                /*
+                 * Decode num - 1 d-gaps following a first docID into
+                 * out, as decodeArray() of a coder does for a list.
+                 */
+                void decodeArray(uint32_t *out);
+};
+
+/*
+ * A list of docIDs to which new docIDs are appended in increasing
+ * order. They are kept as d-gaps in an uncompressed tail, and a tail
+ * of APPEND_BLOCKSZ d-gaps is sealed and appended to sealed blocks
+ * with a coder of d-gaps, so a list is never encoded again as a whole.
+ * A writer and readers taking snapshots may be in other threads.
+ *
+ * NOTICE: A list only lives in memory, and it is not written into a
+ * TOC and a compressed file. Sealed blocks are not a layout that
+ * decoders read, because they expect chunks only in lists longer
+ * than CHUNKLEN.
+ */
+class AppendList {
+        private:
+                pt2Enc          enc;
+                pt2Dec          dec;
+                AppendArea      cmp;
+                uint64_t        cmpcap;
+                uint64_t        cmplen;
+                uint32_t        num;
+                uint32_t        first;
+                uint32_t        last;
+                uint32_t        ntail;
+                uint32_t        tail[APPEND_BLOCKSZ + TAIL_MERGIN];
+                bool            slack;
+                pthread_mutex_t mtx;
+
+                void reserve(uint64_t need);
+                void seal();
+
+        public:
+                AppendList(pt2Enc enc, pt2Dec dec, uint32_t first);
+                ~AppendList();
+
+                /* docIDs must be larger than a last one */
+                void append(uint32_t docid);
+                void append(uint32_t *docs, uint32_t n);
+
+                void snapshot(AppendSnapshot &snap);
+
+                uint32_t size();
+};
+
+#endif /* APPENDLIST_HPP */
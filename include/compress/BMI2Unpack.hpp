@@ -0,0 +1,113 @@
+/*-----------------------------------------------------------------------------
+ *  BMI2Unpack.hpp - Unpacking kernels with BMI2 for odd bit widths.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef BMI2UNPACK_HPP
+#define BMI2UNPACK_HPP
+
+#include <immintrin.h>
+
+#include "open_coders.hpp"
+
+/*
+ * The kernels are compiled for BMI2 regardless of -march, and callers
+ * that inline them must have the same target. They are only used if
+ * BMI2Unpack::available() says yes.
+ */
+#define __bmi2_target   __attribute__((target("bmi2")))
+
+/* # of values expanded by a single pdep, i.e., byte or 16-bit lanes */
+#define __bmi2_lanes(b) (((b) <= 8)? 8 : 4)
+
+#define __bmi2_mask(b)  \
+        ((((b) <= 8)? 0x0101010101010101ULL : 0x0001000100010001ULL) * \
+                ((1ULL << (b)) - 1))
+
+class BMI2Unpack {
+        public:
+                /*
+                 * True if a CPU has a fast pdep, i.e., Haswell or later
+                 * Intel and Zen3 or later AMD. Setting OPEN_CODERS_NO_BMI2
+                 * in the environment disables the kernels for comparison.
+                 */
+                static bool available(void);
+
+                /*
+                 * Unpack 32 values of B bits from B words, and the values
+                 * are MSB-first in each word as the other unpackers. hb
+                 * is ORed with all the values, e.g., for implicit leading
+                 * ones in VSE-R.
+                 */
+                template <uint32_t B>
+                static inline void unpack32(uint32_t *out,
+                                uint32_t *in, uint32_t hb)
+                        __bmi2_target __attribute__((always_inline));
+};
+
+template <uint32_t B>
+inline void
+BMI2Unpack::unpack32(uint32_t *out, uint32_t *in, uint32_t hb)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        s;
+        uint64_t        w;
+        __m128i         v;
+        __m128i         zero;
+        __m128i         hbs;
+
+        zero = _mm_setzero_si128();
+        hbs = _mm_set1_epi32(hb);
+
+        /*
+         * Each step takes a window of __bmi2_lanes(B) values in the top
+         * bits, and deposits them into lanes with pdep. Since the first
+         * value comes in the highest lane, the lanes are reversed before
+         * zero-extended into 32-bit integers. All the offsets are constant
+         * after the loop is unrolled, and no word out of a group is read.
+         */
+        for (i = 0; i < 32 / __bmi2_lanes(B); i++) {
+                k = (i * __bmi2_lanes(B) * B) >> 5;
+                s = (i * __bmi2_lanes(B) * B) & 31;
+
+                w = (uint64_t)in[k] << 32;
+
+                if (s + __bmi2_lanes(B) * B > 32)
+                        w |= in[k + 1];
+
+                w <<= s;
+
+                if (s + __bmi2_lanes(B) * B > 64)
+                        w |= in[k + 2] >> (32 - s);
+
+                w = _pdep_u64(w >> (64 - __bmi2_lanes(B) * B), __bmi2_mask(B));
+
+                if (__bmi2_lanes(B) == 8) {
+                        v = _mm_cvtsi64_si128(__builtin_bswap64(w));
+                        v = _mm_unpacklo_epi8(v, zero);
+
+                        _mm_storeu_si128((__m128i *)(out + 8 * i),
+                                        _mm_or_si128(_mm_unpacklo_epi16(v, zero), hbs));
+                        _mm_storeu_si128((__m128i *)(out + 8 * i + 4),
+                                        _mm_or_si128(_mm_unpackhi_epi16(v, zero), hbs));
+                } else {
+                        v = _mm_cvtsi64_si128(w);
+                        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+
+                        _mm_storeu_si128((__m128i *)(out + 4 * i),
+                                        _mm_or_si128(_mm_unpacklo_epi16(v, zero), hbs));
+                }
+        }
+}
+
+#endif /* BMI2UNPACK_HPP */
@@ -0,0 +1,77 @@
+/*-----------------------------------------------------------------------------
+ *  BatchDecoder.hpp - A decoder for a batch of lists hiding memory latency.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef BATCHDECODER_HPP
+#define BATCHDECODER_HPP
+
+#include "open_coders.hpp"
+#include "compress/PostingCursor.hpp"
+
+/* # of lists ahead whose heads are prefetched */
+#define BATCH_PFDIST            4
+
+/* # of cache lines prefetched at the head of a list */
+#define BATCH_PFLINES           4
+
+/* # of lists decoded in turn a block at a time */
+#define BATCH_NWAYS             8
+#define BATCH_MAXWAYS           64
+
+#define BATCH_LINESZ            64
+
+typedef void (*pt2Dec)(uint32_t *, uint32_t, uint32_t *, uint32_t);
+
+/*
+ * A compressed list (or a chunk of CHUNKLEN at most) in a batch, where
+ * num d-gaps in csize words at *in are decoded into *out. As with
+ * decodeArray(), out needs TAIL_MERGIN more integers.
+ */
+struct BatchList {
+        uint32_t        *in;
+        uint32_t        csize;
+        uint32_t        num;
+        uint32_t        *out;
+};
+
+class BatchDecoder {
+        public:
+                /* Prefetch nlines cache lines from addr */
+                static void prefetch(uint32_t *addr, uint32_t nlines) {
+                        uint32_t        i;
+
+                        for (i = 0; i < nlines; i++)
+                                __builtin_prefetch((char *)addr +
+                                                i * BATCH_LINESZ, 0, 3);
+                }
+
+                /*
+                 * Lists are decoded one by one, and the head of a list
+                 * dist lists ahead is prefetched while decoding a list,
+                 * so that it is in cache when the list comes.
+                 */
+                static void decodeLists(pt2Dec dec, BatchList *lists,
+                                uint32_t n, uint32_t dist);
+
+                /*
+                 * Up to nways lists are decoded in turn a block at a
+                 * time with a block decoder of PostingCursor. A next
+                 * block of a list is prefetched when switching to the
+                 * next list, and it is loaded while the other lists
+                 * are decoded. nways is up to BATCH_MAXWAYS.
+                 */
+                static void decodeInterleaved(pt2Block dec, BatchList *lists,
+                                uint32_t n, uint32_t nways);
+};
+
+#endif /* BATCHDECODER_HPP */
@@ -0,0 +1,83 @@
+/*-----------------------------------------------------------------------------
+ *  CompactTOC.hpp - A compressed TOC with random access to its entries.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef COMPACTTOC_HPP
+#define COMPACTTOC_HPP
+
+#include "open_coders.hpp"
+#include "compress/EliasFano.hpp"
+
+/* # of entries whose fields and positions are packed together */
+#define CTOC_BLOCKSZ    64
+
+/*
+ * A block of CTOC_BLOCKSZ entries. Their fields are packed from data
+ * at off, and then Elias-Fano positions relative to base follow.
+ */
+struct __ctoc_block {
+        uint64_t        base;
+        uint32_t        off;
+        uint32_t        minNum;
+        uint32_t        minFirst;
+        uint32_t        widths;
+};
+
+/*
+ * Entries of a TOC in memory, where each entry takes 20 bytes in a
+ * file. Block positions of lists (i.e., __toc_blkpos() of entries)
+ * are non-decreasing, so they are stored with Elias-Fano relative to
+ * the head of every CTOC_BLOCKSZ entries. The num and first doc of
+ * each entry are bit-packed with a minimum and widths in the block,
+ * and so is an offset + 1 in a shared block for a short list (0 for
+ * a long one). Any entry is read in O(1) from a block and words of
+ * data next to each other. A last doc is left out, which decoders do
+ * not read.
+ */
+class CompactTOC {
+        private:
+                uint32_t        numHeaders;
+                uint32_t        nblocks;
+
+                struct __ctoc_block     *blks;
+                uint32_t        *data;
+                uint64_t        datalen;
+
+        public:
+                /*
+                 * Build from numHeaders entries of a TOC following its
+                 * header. cmplen is the length of a compressed file in
+                 * words, which ends a last list.
+                 */
+                CompactTOC(uint32_t *toc, uint32_t numHeaders,
+                                uint64_t cmplen);
+                ~CompactTOC();
+
+                uint32_t size() {
+                        return numHeaders;
+                }
+
+                uint64_t sizeInBytes();
+
+                /* The j-th entry as it is in a TOC, except for a last doc */
+                void get(uint32_t j, uint32_t &num,
+                                uint32_t &first, uint64_t &pos);
+
+                /*
+                 * The block position of the j-th entry, and cmplen for
+                 * j = numHeaders, so a long list ends at blkPos(j + 1).
+                 */
+                uint64_t blkPos(uint32_t j);
+};
+
+#endif /* COMPACTTOC_HPP */
@@ -0,0 +1,71 @@
+/*-----------------------------------------------------------------------------
+ *  EliasFano.hpp - A coder based on Elias-Fano representation.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef ELIASFANO_HPP
+#define ELIASFANO_HPP
+
+#include "open_coders.hpp"
+
+/* Every EF_QUANTUM-th 1s and 0s in upper bits are sampled for select */
+#define EF_QUANTUM      256
+
+/*
+ * A list of d-gaps is transformed into a strictly increasing sequence,
+ * i.e., v[i] = v[i - 1] + in[i] + 1 with v[-1] = -1, and v[] is encoded
+ * with Elias-Fano. So, v[i] + 1 is a docID relative to the head of the
+ * list, and access() and nextGEQ() work on v[] directly.
+ *
+ * The layout of a block is as follows:
+ *      [max value][select1 samples][select0 samples][lower bits][upper bits]
+ */
+class EliasFano {
+        public:
+                /*
+                 * Encode/decode a non-decreasing sequence of values, and
+                 * they are used by PartitionedEliasFano as well.
+                 */
+                static void encodeEF(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &size);
+
+                static void decodeEF(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t base, uint32_t &prev);
+
+                static uint32_t accessEF(uint32_t *in, uint32_t len,
+                                uint32_t idx);
+
+                static uint32_t nextGEQEF(uint32_t *in, uint32_t len,
+                                uint32_t val, uint32_t &idx);
+
+                /* A cost in bits to encode len values less than univ */
+                static uint64_t costEF(uint64_t len, uint64_t univ);
+
+                static void encodeArray(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t nvalue);
+
+                /*
+                 * Random access on compressed data. nextGEQ() returns the
+                 * first value not less than val, and its index in idx. If
+                 * no such value exists, idx is set to nvalue.
+                 */
+                static uint32_t access(uint32_t *in,
+                                uint32_t nvalue, uint32_t idx);
+
+                static uint32_t nextGEQ(uint32_t *in, uint32_t nvalue,
+                                uint32_t val, uint32_t &idx);
+};
+
+#endif /* ELIASFANO_HPP */
@@ -0,0 +1,108 @@
+/*-----------------------------------------------------------------------------
+ *  ListMerger.hpp - Merge two compressed lists without encoding them again.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef LISTMERGER_HPP
+#define LISTMERGER_HPP
+
+#include "open_coders.hpp"
+#include "compress/PForDelta.hpp"
+#include "compress/PostingCursor.hpp"
+#include "compress/AppendList.hpp"
+
+/*
+ * How compressed lists of a coder are merged:
+ *      MERGE_WORDS:    self-delimiting words of greedy coders (e.g.,
+ *                      Simple9/16). Words from a boundary are encoded
+ *                      again until they fall on a word of a next list.
+ *      MERGE_BLOCKS:   a # of blocks followed by blocks of
+ *                      PFORDELTA_BLOCKSZ integers (e.g., PForDelta).
+ *                      A last partial block of A is encoded again with
+ *                      val into a short block, and blocks of B follow.
+ *      MERGE_PARTS:    partitions whose descriptors lead a list (e.g.,
+ *                      VSEncodingSimpleV1/V2). A last partition of A is
+ *                      encoded again with val, and mc.merge of a coder
+ *                      copies codewords and descriptors of the others.
+ *      MERGE_REENCODE: the others, which are decoded and encoded again.
+ *                      VSEncodingBlocks and its variants group integers
+ *                      by widths over a whole list, so they have no tail
+ *                      partition to be encoded again alone.
+ */
+#define MERGE_REENCODE  0
+#define MERGE_WORDS     1
+#define MERGE_BLOCKS    2
+#define MERGE_PARTS     3
+
+/*
+ * A skipper of a coder, which passes over blocks (or words) as pt2Block
+ * does, but reads only their headers without decoding integers.
+ */
+typedef uint32_t (*pt2Skip)(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data);
+
+/* A merger of a coder for MERGE_PARTS, as mergeArray() below */
+typedef uint64_t (*pt2Merge)(uint32_t *inA, uint32_t lenA, uint32_t numA,
+                uint32_t val, uint32_t *inB, uint32_t lenB, uint32_t numB,
+                uint32_t *out, uint32_t &nvalue);
+
+/*
+ * A coder of merged lists, where blk and skip are needed for
+ * MERGE_WORDS and MERGE_BLOCKS, and merge for MERGE_PARTS.
+ */
+struct MergeCoder {
+        int             type;
+        pt2Enc          enc;
+        pt2Dec          dec;
+        pt2Block        blk;
+        pt2Skip         skip;
+        pt2Merge        merge;
+};
+
+class ListMerger {
+        private:
+                static uint64_t mergeWords(MergeCoder &mc,
+                                uint32_t *inA, uint32_t lenA, uint32_t numA,
+                                uint32_t val,
+                                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                                uint32_t *out, uint32_t &nvalue);
+                static uint64_t mergeBlocks(MergeCoder &mc,
+                                uint32_t *inA, uint32_t lenA, uint32_t numA,
+                                uint32_t val,
+                                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                                uint32_t *out, uint32_t &nvalue);
+                static uint64_t reencode(MergeCoder &mc,
+                                uint32_t *inA, uint32_t lenA, uint32_t numA,
+                                uint32_t val,
+                                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                                uint32_t *out, uint32_t &nvalue);
+
+        public:
+                /*
+                 * Encode numA integers of list A, val, and numB integers
+                 * of list B into out, where A and B are encoded by mc in
+                 * lenA and lenB words. For lists of d-gaps, val is a gap
+                 * between a last docID of A and a first one of B. Output
+                 * is the same as mc.enc does for these integers except
+                 * MERGE_BLOCKS and MERGE_PARTS, which leave a short block
+                 * or partitions decoded by mc.dec to the same. out needs
+                 * lenA + lenB + __cmp_bound(numA + numB + 1) words. It
+                 * returns the number of integers encoded again.
+                 */
+                static uint64_t mergeArray(MergeCoder &mc,
+                                uint32_t *inA, uint32_t lenA, uint32_t numA,
+                                uint32_t val,
+                                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                                uint32_t *out, uint32_t &nvalue);
+};
+
+#endif /* LISTMERGER_HPP */
@@ -34,6 +34,11 @@ class OPTPForDelta {
                                 uint32_t *out, uint32_t &nvalue);
                 static void decodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t nvalue);
+
+                /* A block decoder as the same as PForDelta */
+                static uint32_t decodeBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p,
+                                uint32_t *&data, uint32_t *out);
 };
 
 #endif /* OPTPFORDELTAV1_HPP */
@@ -17,6 +17,8 @@
 
 #include "open_coders.hpp"
 #include "compress/Simple16.hpp"
+#include "compress/BMI2Unpack.hpp"
+#include "compress/AVX512Unpack.hpp"
 #include "io/BitsWriter.hpp"
 
 #define PFORDELTA_NBLOCK        1
@@ -26,6 +28,29 @@
 //#define PFORDELTA_BLOCKSZ       (128 * PFORDELTA_NBLOCK)
 
 class PForDelta {
+        private:
+                /*
+                 * 32-bit and 64-bit integers share the codes below.
+                 * For 64-bit integers, b is still up to 32, and the
+                 * upper bits are stored as exceptions.
+                 */
+                template <class T>
+                static uint32_t tryB(uint32_t b, T *in, uint32_t len);
+                template <class T>
+                static uint32_t findBestB(T *in, uint32_t len);
+                template <class T>
+                static void encodeBlock(T *in,
+                                uint32_t len, uint32_t *out,
+                                uint32_t &nvalue,
+                                uint32_t (*find)(T *in, uint32_t len));
+
+                template <class T>
+                static void encode(T *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                template <class T>
+                static void decode(uint32_t *in, uint32_t len,
+                                T *out, uint32_t nvalue);
+
         public:
                 static uint32_t tryB(uint32_t b, uint32_t *in,
                                 uint32_t len);
@@ -41,6 +66,35 @@ class PForDelta {
                                 uint32_t *out, uint32_t &nvalue);
                 static void decodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t nvalue);
+
+                /*
+                 * A block decoder for PostingCursor, which decodes
+                 * PFORDELTA_BLOCKSZ integers a block, or fewer in a
+                 * short block.
+                 */
+                static uint32_t decodeBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p,
+                                uint32_t *&data, uint32_t *out);
+
+                /*
+                 * It passes over blocks as decodeBlock() does, but only
+                 * reads their headers.
+                 */
+                static uint32_t skipBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p, uint32_t *&data);
+
+                /*
+                 * A block encoded from PFORDELTA_BLOCKSZ integers, e.g.,
+                 * padded with zeros, is marked to have only the first n
+                 * of them, so that other blocks can follow it.
+                 */
+                static void shortenBlock(uint32_t *head, uint32_t n);
+
+                /* For a sequence of 64-bit integers */
+                static void encodeArray(uint64_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint64_t *out, uint32_t nvalue);
 };
 
 #endif /* PFORDELTA_HPP */
@@ -0,0 +1,97 @@
+/*-----------------------------------------------------------------------------
+ *  ParallelList.hpp - Encode and decode sub-blocks of a long list in parallel.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef PARALLELLIST_HPP
+#define PARALLELLIST_HPP
+
+#include "open_coders.hpp"
+#include "compress/AppendList.hpp"
+#include "compress/BatchDecoder.hpp"
+#include "compress/VSEncodingBlocks.hpp"
+
+#include <pthread.h>
+
+/*
+ * # of integers in a sub-block, which is a block of VSEncodingBlocks
+ * and a multiple of PFORDELTA_BLOCKSZ, so sub-blocks are encoded just
+ * like blocks inside a list.
+ */
+#define PLIST_SUBLEN    VSENCODING_BLOCKSZ
+
+/*
+ * A list is split into sub-blocks of PLIST_SUBLEN integers, and each
+ * is encoded independently by a coder. A directory heads the list:
+ *      [# of sub-blocks][offset, base] x # of sub-blocks [sub-blocks]
+ * where an offset is the position of a sub-block in words after the
+ * directory, and a base is a sum of (d-gap + 1) before the sub-block,
+ * i.e., its docID previous to the first one relative to the head of
+ * the list. Sub-blocks are processed by a pool of threads.
+ */
+class ParallelList {
+        private:
+                uint32_t        nthreads;
+                pthread_t       *ths;
+                pthread_mutex_t mtx;
+                pthread_cond_t  start;
+                pthread_cond_t  done;
+                uint64_t        gen;
+                uint32_t        nbusy;
+                bool            quit;
+
+                /* A current job, whose tasks are taken by threads */
+                void            (*task)(void *job, uint32_t i);
+                void            *job;
+                uint32_t        ntasks;
+                uint32_t        next;
+
+                static void *worker(void *arg);
+                void run(void (*task)(void *job, uint32_t i),
+                                void *job, uint32_t ntasks);
+                void runTasks();
+                void decode(pt2Dec dec, uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t nvalue,
+                                bool docs, uint32_t first);
+
+        public:
+                /* nthreads includes a caller, which also runs tasks */
+                ParallelList(uint32_t nthreads);
+                ~ParallelList();
+
+                /* A size of *out needed for len integers */
+                static uint64_t bound(uint32_t len);
+
+                static uint32_t numSubBlocks(uint32_t len) {
+                        return int_utils::div_roundup(len, PLIST_SUBLEN);
+                }
+
+                /*
+                 * A coder needs to be thread-safe, and integers are
+                 * d-gaps so that bases are sums of them.
+                 */
+                void encodeArray(pt2Enc enc, uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+
+                void decodeArray(pt2Dec dec, uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t nvalue);
+
+                /*
+                 * The same as above, but docIDs are restored from
+                 * first, i.e., a docID previous to the list, as well.
+                 */
+                void decodeDocs(pt2Dec dec, uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t nvalue,
+                                uint32_t first);
+};
+
+#endif /* PARALLELLIST_HPP */
@@ -0,0 +1,56 @@
+/*-----------------------------------------------------------------------------
+ *  PartitionedEliasFano.hpp - Elias-Fano with optimal partitioning.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef PARTITIONEDELIASFANO_HPP
+#define PARTITIONEDELIASFANO_HPP
+
+#include "open_coders.hpp"
+#include "compress/VSEncoding.hpp"
+#include "compress/EliasFano.hpp"
+
+/*
+ * A sequence is split into units of PEF_UNIT values, and partitions
+ * are formed by 1 to PEF_MAXUNITS units with VSEncoding's DP.
+ */
+#define PEF_UNIT        128
+#define PEF_MAXUNITS    32
+
+/*
+ * The layout is as follows, where values in each partition are
+ * encoded by EliasFano::encodeEF() relative to the previous upper bound:
+ *      [# of partitions][ends][upper bounds][offsets][EF blocks]
+ */
+class PartitionedEliasFano {
+        public:
+                static void encodeArray(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t nvalue);
+
+                /* The semantics are the same with EliasFano */
+                static uint32_t access(uint32_t *in,
+                                uint32_t nvalue, uint32_t idx);
+
+                static uint32_t nextGEQ(uint32_t *in, uint32_t nvalue,
+                                uint32_t val, uint32_t &idx);
+
+                /*
+                 * Partitions are scanned in a fast mode of VSEncoding,
+                 * i.e., of 1, 2, 4, ..., PEF_MAXUNITS units only.
+                 */
+                static void setFastPartition(bool fast);
+};
+
+#endif /* PARTITIONEDELIASFANO_HPP */
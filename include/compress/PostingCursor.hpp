@@ -0,0 +1,93 @@
+/*-----------------------------------------------------------------------------
+ *  PostingCursor.hpp - A cursor to decode a list a block at a time.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef POSTINGCURSOR_HPP
+#define POSTINGCURSOR_HPP
+
+#include "open_coders.hpp"
+
+/* # of integers that a cursor asks a coder to decode at a time */
+#define PCURSOR_BLOCKSZ         64
+
+/*
+ * Coders might decode more than asked by a block or a partition, and
+ * the largest is a partition of 256 integers in VSEncodingSimpleV2.
+ */
+#define PCURSOR_BUFSZ           (PCURSOR_BLOCKSZ + 256 + TAIL_MERGIN)
+
+/* A docID returned past the end of a list */
+#define PCURSOR_END             UINT32_MAX
+
+/*
+ * A block decoder of a coder for the cursor below. It decodes d-gaps
+ * from the p-th block (or partition) at *data into out until n or more,
+ * or the rest of rest ones are decoded, and advances p and data. It
+ * returns # of decoded ones up to rest. p is 0 at the head of a list
+ * *in, where data is set by the decoder.
+ */
+typedef uint32_t (*pt2Block)(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data, uint32_t *out);
+
+/*
+ * A cursor over docIDs in a compressed list. Lists are decoded a block
+ * at a time into a small buffer, so the buffer stays in L1 and a query
+ * that stops early does not pay for the rest of a list. As the list
+ * has no skip pointers, nextGEQ() still decodes blocks on the way, but
+ * it does not scan ones whose last docIDs are too small.
+ */
+class PostingCursor {
+        private:
+                pt2Block        dec;
+                uint32_t        *in;
+                uint32_t        *next_chunk;
+                uint32_t        *data;
+                uint32_t        p;
+                bool            chunked;
+
+                /* # of d-gaps in a current chunk and the following */
+                uint32_t        rest;
+                uint32_t        nrest;
+
+                /* A last docID in a buffer, which a next block follows */
+                uint32_t        last;
+
+                uint32_t        cur;
+                uint32_t        pos;
+                uint32_t        nbuf;
+                uint32_t        buf[PCURSOR_BUFSZ];
+
+                bool fill();
+
+        public:
+                /*
+                 * A cursor is on the first docID of a list of num docIDs,
+                 * where *in is the compressed d-gaps following it, i.e.,
+                 * a list as pointed by TOC. Chunks are followed as well.
+                 */
+                PostingCursor(pt2Block dec, uint32_t *in,
+                                uint32_t num, uint32_t first);
+
+                /* A current docID, or PCURSOR_END past the end */
+                uint32_t docid() {
+                        return cur;
+                }
+
+                /* Move to a next docID, and return it */
+                uint32_t next();
+
+                /* Move to a first docID not less than d, and return it */
+                uint32_t nextGEQ(uint32_t d);
+};
+
+#endif /* POSTINGCURSOR_HPP */
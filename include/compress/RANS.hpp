@@ -0,0 +1,58 @@
+/*-----------------------------------------------------------------------------
+ *  RANS.hpp - A table-based rANS coder for small alphabets of bytes.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef RANS_HPP
+#define RANS_HPP
+
+#include "open_coders.hpp"
+#include "io/BitsWriter.hpp"
+#include "io/BitsReader.hpp"
+
+/*
+ * Frequencies are scaled to 2^S (S <= RANS_MAXSCALE), and a state in
+ * [RANS_L, 2^32) is renormalized with 16-bit units.
+ */
+#define RANS_MAXSCALE   12
+#define RANS_L          (1U << 16)
+
+/*
+ * # of interleaved states. Symbols are assigned to these states in
+ * a round-robin way, so decoding steps of states are independent.
+ */
+#define RANS_NSTATES    4
+
+/* The max # of words for n symbols */
+#define __rans_bound(n) \
+        (2 + (256 * (8 + RANS_MAXSCALE) + 31) / 32 +    \
+                RANS_NSTATES + ((n) + 1) / 2 + 1)
+
+class RANS {
+        public:
+                /*
+                 * A frequency table is written first, and then final
+                 * states and units in the order of decoding.
+                 *  - *in: n symbols to be encoded
+                 *  - *out: points to the first int of the output
+                 * It returns the compress size in number of int.
+                 *
+                 * Note: *out must be as large as __rans_bound(n).
+                 */
+                static void encode(uint8_t *in, uint32_t n,
+                                uint32_t *out, uint32_t &size);
+
+                /* Decode n symbols from a stream written above */
+                static void decode(uint32_t *in, uint8_t *out, uint32_t n);
+};
+
+#endif /* RANS_HPP */
@@ -0,0 +1,54 @@
+/*-----------------------------------------------------------------------------
+ *  SIMDBP128.hpp - A SIMD-BP128 coder with 4-wide deltas of docIDs.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef SIMDBP128_HPP
+#define SIMDBP128_HPP
+
+#include <emmintrin.h>
+
+#include "open_coders.hpp"
+
+#define SIMDBP128_BLOCKSZ       128
+
+/* # of 32-bit lanes in a xmm register */
+#define SIMDBP128_LANES         4
+
+/*
+ * Integers are packed 128 at a time with one width per block, where
+ * the i-th one goes to the (i % 4)-th lane of 32-bit words. So, a row
+ * of 4 integers is unpacked with a xmm register at once.
+ *
+ * As BinaryInterpolative, it takes increasing values, e.g., docIDs,
+ * and stores D4 deltas, i.e., differences from the values 4 positions
+ * earlier, minus 4. A prefix sum over rows is a SIMD add per row, so
+ * docIDs are restored while unpacking.
+ */
+class SIMDBP128 {
+        public:
+                /*
+                 * It assumes that values are increasing.
+                 *  - *in: points to the first docID to be encoded
+                 *  - *out: points to the first int that will countain the compress
+                 * It returns the compress size in number of int
+                 *
+                 * Note: *out must be large enough to contain the compress.
+                 */
+                static void encodeArray(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t nvalue);
+};
+
+#endif /* SIMDBP128_HPP */
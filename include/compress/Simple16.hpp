@@ -21,37 +21,42 @@
 class Simple16 {
         private:
                 /*
-                 * These functions judging how many constant-size
-                 * integers to include in a single 32-bit area
-                 * based on Simple9 coders.
+                 * 32-bit and 64-bit integers share the codes below,
+                 * and integers must be less than 2^28 in both cases.
                  */
-                static bool try28_1bit (uint32_t *n, uint32_t nvalue);
-                static bool try14_2bit (uint32_t *n, uint32_t nvalue);
-                static bool try7_4bit (uint32_t *n, uint32_t nvalue);
-                static bool try4_7bit (uint32_t *n, uint32_t nvalue);
-                static bool try2_14bit (uint32_t *n, uint32_t nvalue);
-
-                 /*
-                 * Simple16 appends more functions to deal with
-                 * variable-size integers in as single 32-bit areas.
-                 */
-                static bool try7_2bit_14_1bit(uint32_t *n, uint32_t nvalue);
-                static bool try14_1bit_7_2bit(uint32_t *n, uint32_t nvalue);
-                static bool try1_4bit_8_3bit(uint32_t *n, uint32_t nvalue);
-                static bool try4_5bit_2_4bit(uint32_t *n, uint32_t nvalue);
-                static bool try2_4bit_4_5bit(uint32_t *n, uint32_t nvalue);
-                static bool try3_6bit_2_5bit(uint32_t *n, uint32_t nvalue);
-                static bool try2_5bit_3_6bit(uint32_t *n, uint32_t nvalue);
-                static bool try1_10bit_2_9bit(uint32_t *n, uint32_t nvalue);
-
-                static bool try7_1bit_7_2bit_7_1bit(uint32_t *n, uint32_t nvalue);
-                static bool try1_3bit_4_4bit_3_3bit(uint32_t *n, uint32_t nvalue);
+                template <class T>
+                static void encode(T *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                template <class T>
+                static void decode(uint32_t *in, uint32_t len,
+                                T *out, uint32_t nvalue);
 
         public:
                 static void encodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t &nvalue);
                 static void decodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t nvalue);
+
+                /*
+                 * A block decoder for PostingCursor, which decodes
+                 * words until n or more integers are decoded.
+                 */
+                static uint32_t decodeBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p,
+                                uint32_t *&data, uint32_t *out);
+
+                /*
+                 * It passes over words as decodeBlock() does, but only
+                 * reads their descriptors.
+                 */
+                static uint32_t skipBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p, uint32_t *&data);
+
+                /* For a sequence of 64-bit integers */
+                static void encodeArray(uint64_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint64_t *out, uint32_t nvalue);
 };
 
 #endif /* SIMPLE16_HPP */
@@ -24,20 +24,60 @@ class Simple9 {
                  * These functions judging how many integers to
                  * include in a single 32-bit area.
                  */
-                static bool try28_1bit (uint32_t *n, uint32_t nvalue);
-                static bool try14_2bit (uint32_t *n, uint32_t nvalue);
-                static bool try9_3bit (uint32_t *n, uint32_t nvalue);
-                static bool try7_4bit (uint32_t *n, uint32_t nvalue);
-                static bool try5_5bit (uint32_t *n, uint32_t nvalue);
-                static bool try4_7bit (uint32_t *n, uint32_t nvalue);
-                static bool try3_9bit (uint32_t *n, uint32_t nvalue);
-                static bool try2_14bit (uint32_t *n, uint32_t nvalue);
+                template <class T>
+                static bool try28_1bit(T *n, uint32_t nvalue);
+                template <class T>
+                static bool try14_2bit(T *n, uint32_t nvalue);
+                template <class T>
+                static bool try9_3bit(T *n, uint32_t nvalue);
+                template <class T>
+                static bool try7_4bit(T *n, uint32_t nvalue);
+                template <class T>
+                static bool try5_5bit(T *n, uint32_t nvalue);
+                template <class T>
+                static bool try4_7bit(T *n, uint32_t nvalue);
+                template <class T>
+                static bool try3_9bit(T *n, uint32_t nvalue);
+                template <class T>
+                static bool try2_14bit(T *n, uint32_t nvalue);
+
+                /*
+                 * 32-bit and 64-bit integers share the codes below,
+                 * and integers must be less than 2^28 in both cases.
+                 */
+                template <class T>
+                static void encode(T *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                template <class T>
+                static void decode(uint32_t *in, uint32_t len,
+                                T *out, uint32_t nvalue);
 
         public:
                 static void encodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t &nvalue);
                 static void decodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t nvalue);
+
+                /*
+                 * A block decoder for PostingCursor, which decodes
+                 * words until n or more integers are decoded.
+                 */
+                static uint32_t decodeBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p,
+                                uint32_t *&data, uint32_t *out);
+
+                /*
+                 * It passes over words as decodeBlock() does, but only
+                 * reads their descriptors.
+                 */
+                static uint32_t skipBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p, uint32_t *&data);
+
+                /* For a sequence of 64-bit integers */
+                static void encodeArray(uint64_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint64_t *out, uint32_t nvalue);
 };
 
 #endif /* SIMPLE9_HPP */
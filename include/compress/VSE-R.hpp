@@ -17,6 +17,7 @@
 
 #include "open_coders.hpp"
 #include "compress/Delta.hpp"
+#include "compress/BMI2Unpack.hpp"
 #include "compress/VSEncoding.hpp"
 #include "compress/VSEncodingNaive.hpp"
 #include "io/BitsReader.hpp"
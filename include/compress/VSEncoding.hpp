@@ -25,6 +25,29 @@
  */
 #define VSENCODING_BLOCKSZ      65536U
 
+/*
+ * A cost function in bits for a block [head, tail) in seq[]. This is
+ * used instead of (tail - head) * max(seq[head..tail)) for coders
+ * whose costs are not determined by the max value, e.g., Elias-Fano.
+ */
+typedef uint64_t (*pt2Cost)(uint32_t *seq, uint32_t head, uint32_t tail);
+
+/*
+ * Decoding costs are kept in 1/VSENCODING_COSTSCALE of a unit of sizes,
+ * i.e., a bit, or a word if aligned, so that small costs are not lost.
+ */
+#define VSENCODING_COSTSCALE    256U
+
+/* The max value in seq[] that has a decoding cost per integer */
+#define VSENCODING_MAXLOG       64
+
+/*
+ * Lengths tried in a fast mode have VSENCODING_FASTBITS significant
+ * bits at most, e.g., 4, 5, 6, and 7 times 2^k for 3 bits.
+ */
+#define VSENCODING_FASTBITS     3
+#define VSENCODING_MAXFAST      (32 << (VSENCODING_FASTBITS - 1))
+
 class VSEncoding {
         private:
                 /*
@@ -37,9 +60,32 @@ class VSEncoding {
                 uint32_t        *posszLens;
                 uint32_t        poss_sz;
                 uint32_t        maxBlk;
+                pt2Cost         costFunc;
+                uint64_t        partCost;
+                uint64_t        intCost[VSENCODING_MAXLOG + 1];
+
+                /*
+                 * In a fast mode, only fastLens[] are tried, and
+                 * fastLogs[] has the msb of each. lenFlags[n] tells if
+                 * a length of n is possible for blocks of larger
+                 * numbers(bit 0) and zeros(bit 1).
+                 */
+                bool            fast;
+                uint32_t        nfast;
+                uint32_t        fastLens[VSENCODING_MAXFAST];
+                uint32_t        fastLogs[VSENCODING_MAXFAST];
+                uint8_t         *lenFlags;
+
+                void setFastLens();
+                uint64_t blockCost(uint32_t *seq, uint32_t head,
+                                uint32_t tail, uint32_t maxB, uint32_t fixCost);
+                void computeFastPaths(uint32_t *seq, uint32_t len,
+                                uint32_t fixCost, int *SSSP, uint64_t *cost);
                 
         public:
                 VSEncoding(uint32_t *lens, uint32_t *zlens, uint32_t size, bool cflag);
+                VSEncoding(uint32_t *lens, uint32_t size, pt2Cost cost);
+                ~VSEncoding();
 
                 /*
                  * Compute the optimal sub-lists from lists.
@@ -48,6 +94,37 @@ class VSEncoding {
                  */
                 uint32_t *compute_OptPartition(uint32_t *seq,
                                 uint32_t len, uint32_t fixCost, uint32_t &pSize);
+
+                /*
+                 * Add decoding time to sizes in the partitioning above,
+                 * weighted by lambda in bits per ns. A block costs partNs,
+                 * and an integer in a block of the max value logs[k] costs
+                 * intNs[k]. lambda = 0 means sizes only, as default.
+                 *
+                 * Note: it is ignored if a cost function is given.
+                 */
+                void setDecodeCost(double lambda, double partNs,
+                                double *intNs, uint32_t *logs, uint32_t n);
+
+                /*
+                 * A fast mode for fresh data, which are encoded again by
+                 * the exact one later, e.g., in merges. It only tries
+                 * lengths with a few significant bits, and adjacent blocks
+                 * are merged if smaller, in O(len * log(maxBlk)) time.
+                 * It is the exact one if a block of 1 is impossible.
+                 * If every power of 2 up to the max length is possible,
+                 * as in the coders, an optimal block is split into ones
+                 * of powers of 2 with no larger max value, so sizes in
+                 * bits are at most (1 + log(maxBlk)) times as large as
+                 * the optimal ones, i.e., fixCost (plus a word if
+                 * aligned) at most for each extra block.
+                 *
+                 * Note: decoding costs or a cost function are minimized
+                 * over the blocks as well, but out of the bound above.
+                 */
+                void setFastMode(bool fast) {
+                        this->fast = fast;
+                }
 };
 
 #ifdef USE_BOOST_SHAREDPTR
@@ -17,16 +17,74 @@
 
 #include "open_coders.hpp"
 #include "compress/VSEncoding.hpp"
+#include "compress/BMI2Unpack.hpp"
+#include "compress/AVX512Unpack.hpp"
 #include "io/BitsWriter.hpp"
 
+/* # of buckets of integers grouped by width in a block */
+#define VSEBLOCKS_NBUCKETS      16
+
+/*
+ * # of words in *aux to decode a block of len integers, where each
+ * bucket may be unpacked up to 31 integers over.
+ */
+#define __vseblocks_auxlen(len) \
+        ((len) + 32 * VSEBLOCKS_NBUCKETS + TAIL_MERGIN)
+
 class VSEncodingBlocks {
         public:
                 static void encodeVS(uint32_t len, uint32_t *in,
                                 uint32_t &size, uint32_t *out);
 
+                /* *aux has __vseblocks_auxlen(len) words at least */
                 static void decodeVS(uint32_t len, uint32_t *in,
                                 uint32_t *out, uint32_t *aux);
 
+                /*
+                 * The same as above, but descriptors of partitions are
+                 * read from *desc instead of the tail of *in.
+                 */
+                static void decodeVS(uint32_t len, uint32_t *in,
+                                uint32_t *desc, uint32_t *out, uint32_t *aux);
+
+                /* # of words before descriptors in a block by encodeVS() */
+                static uint32_t descOffset(uint32_t *in);
+
+                /*
+                 * The two stages of decodeVS(). Integers are unpacked
+                 * into buckets per width in *aux, which pblk[] point to,
+                 * and descriptors following them are returned. Then,
+                 * they are permuted into *out along descriptors, where
+                 * pblk[] are advanced. test/permbench times each.
+                 */
+                static uint32_t *unpackVS(uint32_t *in, uint32_t *aux,
+                                uint32_t **pblk);
+
+                static void permuteVS(uint32_t len, uint32_t *desc,
+                                uint32_t **pblk, uint32_t *out);
+
+                /*
+                 * Partitions trade space for decoding time with a weight
+                 * of lambda in bits per ns, based on costs measured by
+                 * test/partbench. lambda = 0 means sizes only, as default.
+                 */
+                static void setDecodeCost(double lambda);
+
+                /*
+                 * The same as above with costs measured elsewhere, where
+                 * intNs[] has costs per integer of widths in the order
+                 * printed by test/partbench.
+                 */
+                static void setDecodeCost(double lambda,
+                                double partNs, double *intNs);
+
+                /*
+                 * Partitions are scanned in a fast mode of VSEncoding,
+                 * and its loss is bounded as described there. Exact
+                 * partitions are scanned by default.
+                 */
+                static void setFastPartition(bool fast);
+
                 /*
                  * It assumes that values start form 0.
                  *  - *in: points to the first d-gap to be encoded
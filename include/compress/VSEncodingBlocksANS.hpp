@@ -0,0 +1,58 @@
+/*-----------------------------------------------------------------------------
+ *  VSEncodingBlocksANS.hpp - VSEncodingBlocks with rANS-coded descriptors.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef VSENCODINGBLOCKSANS_HPP
+#define VSENCODINGBLOCKSANS_HPP
+
+#include "open_coders.hpp"
+#include "compress/VSEncoding.hpp"
+#include "compress/VSEncodingBlocks.hpp"
+#include "compress/RANS.hpp"
+
+/*
+ * # of words in *aux to decode a block of len integers, where its
+ * descriptors follow buckets of VSEncodingBlocks.
+ */
+#define __vseans_auxlen(len)    \
+        (__vseblocks_auxlen(len) + (len) / 4 + 1 + TAIL_MERGIN)
+
+/*
+ * Integers are packed in the same way as VSEncodingBlocks, but the 8-bit
+ * descriptors (B, K) of partitions are coded with RANS, where they are
+ * highly skewed. Descriptors are kept as they are if not smaller.
+ */
+class VSEncodingBlocksANS {
+        public:
+                static void encodeVS(uint32_t len, uint32_t *in,
+                                uint32_t &size, uint32_t *out);
+
+                /* *aux has __vseans_auxlen(len) words at least */
+                static void decodeVS(uint32_t len, uint32_t *in,
+                                uint32_t *out, uint32_t *aux);
+
+                /*
+                 * Decoding costs in partitioning as VSEncodingBlocks, with
+                 * ones measured for this coder. They are shared with
+                 * VSEncodingBlocks, because so is the partitioning.
+                 */
+                static void setDecodeCost(double lambda);
+
+                static void encodeArray(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t nvalue);
+};
+
+#endif /* VSENCODINGBLOCKSANS_HPP */
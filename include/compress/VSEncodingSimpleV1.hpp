@@ -19,12 +19,61 @@
 #include "compress/VSEncoding.hpp"
 #include "io/BitsWriter.hpp"
 
+/* A sampling rate of partitions in an index for random access */
+#define VSESIMPLEV1_SAMPLING    16
+
 class VSEncodingSimpleV1 {
         public:
                 static void encodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t &nvalue);
                 static void decodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t nvalue);
+
+                /*
+                 * A block decoder for PostingCursor, which decodes
+                 * partitions until n or more integers are decoded.
+                 */
+                static uint32_t decodeBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p,
+                                uint32_t *&data, uint32_t *out);
+
+                /*
+                 * Partitions trade space for decoding time with a weight
+                 * of lambda in bits per ns, based on costs measured by
+                 * test/partbench. lambda = 0 means sizes only, as default.
+                 */
+                static void setDecodeCost(double lambda);
+
+                /*
+                 * The same as above with costs measured elsewhere, where
+                 * intNs[] has costs per integer of widths in the order
+                 * printed by test/partbench.
+                 */
+                static void setDecodeCost(double lambda,
+                                double partNs, double *intNs);
+
+                /*
+                 * Partitions are scanned in a fast mode of VSEncoding,
+                 * and its loss is bounded as described there. Exact
+                 * partitions are scanned by default.
+                 */
+                static void setFastPartition(bool fast);
+
+                /* Random access as the same as VSEncodingSimpleV2 */
+                static uint32_t *buildIndex(uint32_t *in,
+                                uint32_t nvalue, uint32_t &isize);
+
+                static uint32_t get(uint32_t *in,
+                                uint32_t *idx, uint32_t isize, uint32_t i);
+
+                static void decodeRange(uint32_t *in, uint32_t *idx,
+                                uint32_t isize, uint32_t i, uint32_t j, uint32_t *out);
+
+                /* Merge lists as the same as VSEncodingSimpleV2 */
+                static uint64_t mergeArray(uint32_t *inA, uint32_t lenA,
+                                uint32_t numA, uint32_t val,
+                                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                                uint32_t *out, uint32_t &nvalue);
 };
 
 #endif /* VSENCODING_SIMPLE_V1_HPP */
@@ -17,14 +17,96 @@
 
 #include "open_coders.hpp"
 #include "compress/VSEncoding.hpp"
+#include "compress/BMI2Unpack.hpp"
+#include "compress/AVX512Unpack.hpp"
 #include "io/BitsWriter.hpp"
 
+/* A sampling rate of partitions in an index for random access */
+#define VSESIMPLEV2_SAMPLING    16
+
 class VSEncodingSimpleV2 {
+        private:
+                /*
+                 * 32-bit and 64-bit integers share the codes below.
+                 * For 64-bit integers, the 4-bit B of a partition is
+                 * mapped into 0-12, 16, 32, and 64 bits.
+                 */
+                template <class T>
+                static void encode(T *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                template <class T>
+                static void decode(uint32_t *in, uint32_t len,
+                                T *out, uint32_t nvalue);
+
         public:
                 static void encodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t &nvalue);
                 static void decodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t nvalue);
+
+                /* For a sequence of 64-bit integers */
+                static void encodeArray(uint64_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint64_t *out, uint32_t nvalue);
+
+                /*
+                 * A block decoder for PostingCursor, which decodes
+                 * partitions until n or more integers are decoded.
+                 */
+                static uint32_t decodeBlock(uint32_t *in, uint32_t n,
+                                uint32_t rest, uint32_t &p,
+                                uint32_t *&data, uint32_t *out);
+
+                /*
+                 * Partitions trade space for decoding time with a weight
+                 * of lambda in bits per ns, based on costs measured by
+                 * test/partbench. lambda = 0 means sizes only, as default.
+                 * 64-bit integers wider than 32 bits have no cost.
+                 */
+                static void setDecodeCost(double lambda);
+
+                /*
+                 * The same as above with costs measured elsewhere, where
+                 * intNs[] has costs per integer of widths in the order
+                 * printed by test/partbench.
+                 */
+                static void setDecodeCost(double lambda,
+                                double partNs, double *intNs);
+
+                /*
+                 * Partitions are scanned in a fast mode of VSEncoding,
+                 * and its loss is bounded as described there. Exact
+                 * partitions are scanned by default.
+                 */
+                static void setFastPartition(bool fast);
+
+                /*
+                 * Random access with a sampled index. For every
+                 * VSESIMPLEV2_SAMPLING-th partition, the index holds the
+                 * number of integers and the offset of compressed data
+                 * preceding the partition. It is built from compressed
+                 * data, and callers might keep it with the data.
+                 */
+                static uint32_t *buildIndex(uint32_t *in,
+                                uint32_t nvalue, uint32_t &isize);
+
+                static uint32_t get(uint32_t *in,
+                                uint32_t *idx, uint32_t isize, uint32_t i);
+
+                /* Decode integers in [i, j) into out */
+                static void decodeRange(uint32_t *in, uint32_t *idx,
+                                uint32_t isize, uint32_t i, uint32_t j, uint32_t *out);
+
+                /*
+                 * Merge lists A and B with val between them for
+                 * ListMerger, where only a last partition of A is
+                 * encoded again. It returns # of integers encoded again.
+                 */
+                static uint64_t mergeArray(uint32_t *inA, uint32_t lenA,
+                                uint32_t numA, uint32_t val,
+                                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                                uint32_t *out, uint32_t &nvalue);
 };
 
 #endif /* VSENCODING_SIMPLE_V2_HPP */
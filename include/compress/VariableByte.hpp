@@ -20,11 +20,26 @@
 #include "io/BitsReader.hpp"
 
 class VariableByte {
+        private:
+                /* 32-bit and 64-bit integers share the codes below */
+                template <class T>
+                static void encode(T *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                template <class T>
+                static void decode(uint32_t *in, uint32_t len,
+                                T *out, uint32_t nvalue);
+
         public:
                 static void encodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t &nvalue);
                 static void decodeArray(uint32_t *in, uint32_t len,
                                 uint32_t *out, uint32_t nvalue);
+
+                /* For a sequence of 64-bit integers */
+                static void encodeArray(uint64_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+                static void decodeArray(uint32_t *in, uint32_t len,
+                                uint64_t *out, uint32_t nvalue);
 };
 
 #endif /* VARIABLEBYTE_HPP */
@@ -16,6 +16,8 @@
 #define DECODERS_HPP
 
 #include "open_coders.hpp"
+#include "io/BulkWriter.hpp"
+#include "io/TOCReader.hpp"
 
 /* Header files for a variety of compressions */
 #include "compress/Gamma.hpp"
@@ -32,8 +34,15 @@
 #include "compress/VSEncodingBlocksHybrid.hpp"
 #include "compress/VSEncodingSimpleV1.hpp"
 #include "compress/VSEncodingSimpleV2.hpp"
+#include "compress/EliasFano.hpp"
+#include "compress/PartitionedEliasFano.hpp"
+#include "compress/VSEncodingBlocksANS.hpp"
+#include "compress/SIMDBP128.hpp"
+#include "compress/PostingCursor.hpp"
+#include "compress/BatchDecoder.hpp"
+#include "compress/ParallelList.hpp"
 
-#define NUMDECODERS     19
+#define NUMDECODERS     23
 
 /* DecoderID */
 #define D_GAMMA         0
@@ -55,8 +64,20 @@
 #define D_VSEHYB        16
 #define D_VSESIMPLEV1   17
 #define D_VSESIMPLEV2   18
+#define D_EF            19
+#define D_PEF           20
+#define D_VSEBLOCKSANS  21
+#define D_SIMDBP128     22
 
-typedef void (*pt2Dec)(uint32_t *, uint32_t, uint32_t *, uint32_t);
+/* Decoders restoring increasing docIDs instead of d-gaps */
+#define __dec_absolute(id)      ((id) == D_BINARYIPL || (id) == D_SIMDBP128)
+
+/* Decoders for lists in sub-blocks by ParallelList */
+#define __dec_parallel(id)      \
+        ((id) == D_P4D || (id) == D_OPTP4D || (id) == D_VSEBLOCKS)
+
+/* A decoder for shared blocks of short lists, used by ShortBlock */
+#define D_SHORT         D_VARIABLEBYTE
 
 static pt2Dec decoders[NUMDECODERS] = {
         Gamma::decodeArray,
@@ -77,7 +98,41 @@ static pt2Dec decoders[NUMDECODERS] = {
         VSEncodingRest::decodeArray,
         VSEncodingBlocksHybrid::decodeArray,
         VSEncodingSimpleV1::decodeArray,
-        VSEncodingSimpleV2::decodeArray
+        VSEncodingSimpleV2::decodeArray,
+        EliasFano::decodeArray,
+        PartitionedEliasFano::decodeArray,
+        VSEncodingBlocksANS::decodeArray,
+        SIMDBP128::decodeArray
+};
+
+/*
+ * Block decoders for PostingCursor, or NULL if lists are not decoded
+ * a block at a time.
+ */
+static pt2Block blockDecoders[NUMDECODERS] __attribute__((unused)) = {
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        Simple9::decodeBlock,
+        Simple16::decodeBlock,
+        PForDelta::decodeBlock,
+        OPTPForDelta::decodeBlock,
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        VSEncodingSimpleV1::decodeBlock,
+        VSEncodingSimpleV2::decodeBlock,
+        NULL,
+        NULL,
+        NULL,
+        NULL
 };
 
 /* Extensions for these coresspinding indices */
@@ -100,7 +155,11 @@ const char *dec_ext[] = {
         ".VSERest",
         ".VSEH",
         ".VSESimpleV1",
-        ".VSESimpleV2"
+        ".VSESimpleV2",
+        ".EF",
+        ".PEF",
+        ".VSEANS",
+        ".SIMDBP128"
 };
 
 #endif /* DECODERS_HPP */
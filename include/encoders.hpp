@@ -16,6 +16,8 @@
 #define ENCODERS_HPP
 
 #include "open_coders.hpp"
+#include "io/BulkReader.hpp"
+#include "io/TOCWriter.hpp"
 
 /* Header files for a variety of compressions */
 #include "compress/Gamma.hpp"
@@ -32,8 +34,14 @@
 #include "compress/VSEncodingBlocksHybrid.hpp"
 #include "compress/VSEncodingSimpleV1.hpp"
 #include "compress/VSEncodingSimpleV2.hpp"
+#include "compress/EliasFano.hpp"
+#include "compress/PartitionedEliasFano.hpp"
+#include "compress/VSEncodingBlocksANS.hpp"
+#include "compress/SIMDBP128.hpp"
+#include "compress/AppendList.hpp"
+#include "compress/ParallelList.hpp"
 
-#define NUMENCODERS     14
+#define NUMENCODERS     18
 
 /* EncoderID */
 #define E_GAMMA         0
@@ -50,8 +58,68 @@
 #define E_VSEHYB        11
 #define E_VSESIMPLEV1   12
 #define E_VSESIMPLEV2   13
+#define E_EF            14
+#define E_PEF           15
+#define E_VSEBLOCKSANS  16
+#define E_SIMDBP128     17
 
-typedef void (*pt2Enc)(uint32_t *, uint32_t, uint32_t *, uint32_t &);
+/* Coders taking increasing docIDs instead of d-gaps */
+#define __enc_absolute(id)      ((id) == E_BINARYIPL || (id) == E_SIMDBP128)
+
+/* Coders whose blocks are independent, so sub-blocks are encoded in parallel */
+#define __enc_parallel(id)      \
+        ((id) == E_P4D || (id) == E_OPTP4D || (id) == E_VSEBLOCKS)
+
+/*
+ * Partitions of VSE coders trade space for decoding time with a weight
+ * of lambda in bits per ns. VSEncodingBlocks and VSEncodingBlocksANS
+ * share a partitioner, so it is set for each coder before encoding.
+ */
+static inline void
+__enc_decode_cost(int id, double lambda)
+{
+        switch (id) {
+        case E_VSEBLOCKS:
+                VSEncodingBlocks::setDecodeCost(lambda);
+                break;
+        case E_VSEBLOCKSANS:
+                VSEncodingBlocksANS::setDecodeCost(lambda);
+                break;
+        case E_VSESIMPLEV1:
+                VSEncodingSimpleV1::setDecodeCost(lambda);
+                break;
+        case E_VSESIMPLEV2:
+                VSEncodingSimpleV2::setDecodeCost(lambda);
+                break;
+        }
+}
+
+/* VSE coders scan partitions in a fast mode, or the exact one */
+static inline void
+__enc_fast_partition(int id, bool fast)
+{
+        switch (id) {
+        case E_VSEBLOCKS:
+        case E_VSEBLOCKSANS:
+                VSEncodingBlocks::setFastPartition(fast);
+                break;
+        case E_VSESIMPLEV1:
+                VSEncodingSimpleV1::setFastPartition(fast);
+                break;
+        case E_VSESIMPLEV2:
+                VSEncodingSimpleV2::setFastPartition(fast);
+                break;
+        case E_PEF:
+                PartitionedEliasFano::setFastPartition(fast);
+                break;
+        }
+}
+
+/*
+ * A coder for shared blocks of short lists, which has no per-block
+ * overhead. TOCWriter encodes these blocks with it.
+ */
+#define E_SHORT         E_VARIABLEBYTE
 
 pt2Enc encoders[NUMENCODERS] = {
         Gamma::encodeArray,
@@ -67,7 +135,11 @@ pt2Enc encoders[NUMENCODERS] = {
         VSEncodingRest::encodeArray,
         VSEncodingBlocksHybrid::encodeArray,
         VSEncodingSimpleV1::encodeArray,
-        VSEncodingSimpleV2::encodeArray
+        VSEncodingSimpleV2::encodeArray,
+        EliasFano::encodeArray,
+        PartitionedEliasFano::encodeArray,
+        VSEncodingBlocksANS::encodeArray,
+        SIMDBP128::encodeArray
 };	
 
 /* Extensions for these coresspinding indices */
@@ -85,7 +157,11 @@ const char *enc_ext[] = {
         ".VSERest",
         ".VSEH",
         ".VSESimpleV1",
-        ".VSESimpleV2"
+        ".VSESimpleV2",
+        ".EF",
+        ".PEF",
+        ".VSEANS",
+        ".SIMDBP128"
 };
 
 #endif /* ENCODERS_HPP */
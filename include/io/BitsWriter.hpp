@@ -32,6 +32,10 @@ class BitsWriter {
 
                 void bit_flush();
                 void bit_writer(uint32_t value, uint32_t bits);
+                void bit_writer64(uint64_t value, uint32_t bits);
+
+                /* First nbits of in, written MSB first, are copied */
+                void bit_copy(uint32_t *in, uint64_t nbits);
 
                 uint32_t *ret_pos();
 
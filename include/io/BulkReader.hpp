@@ -0,0 +1,76 @@
+/*-----------------------------------------------------------------------------
+ *  BulkReader.hpp - A double-buffered reader to input integers in bulk.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef BULKREADER_HPP
+#define BULKREADER_HPP
+
+#include <pthread.h>
+
+#include "open_coders.hpp"
+
+/* The default size of each buffer in 32-bit words, i.e., 16MiB */
+#define BULKREADER_BUFSZ        (1U << 22)
+
+/*
+ * A background thread fills one buffer with pread() while the other
+ * one is consumed, and pages already copied are dropped from the page
+ * cache. So, inputs larger than RAM are read without fault storms.
+ */
+class BulkReader {
+        private:
+                int             fd;
+                uint64_t        fsz;
+                uint64_t        bufsz;
+                uint32_t        *buf[2];
+                uint64_t        filled[2];
+                bool            ready[2];
+                bool            quit;
+                pthread_t       th;
+                pthread_mutex_t mtx;
+                pthread_cond_t  cond;
+
+                /* Current buffer being consumed */
+                uint32_t        *cur;
+                uint64_t        pos;
+                uint64_t        len;
+                uint64_t        base;
+                uint32_t        idx;
+
+                void fetch();
+                void release();
+                void prefetcher();
+
+                static void *__prefetcher(void *arg);
+
+        public:
+                BulkReader(const char *filen, uint64_t bufsz);
+                ~BulkReader();
+
+                /* The number of 32-bit integers in the file */
+                uint64_t size() const { return fsz >> 2; }
+
+                /* The number of integers consumed so far */
+                uint64_t tell() const { return base + pos; }
+
+                uint32_t next() {
+                        if (__unlikely(pos == len))
+                                fetch();
+
+                        return cur[pos++];
+                }
+
+                void skip(uint64_t n);
+};
+
+#endif /* BULKREADER_HPP */
@@ -0,0 +1,49 @@
+/*-----------------------------------------------------------------------------
+ *  BulkWriter.hpp - A buffered writer to output decoded integers in bulk.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef BULKWRITER_HPP
+#define BULKWRITER_HPP
+
+#include <sys/uio.h>
+
+#include "open_coders.hpp"
+
+/* The default size of a buffer in 32-bit words, i.e., 4MiB */
+#define BULKWRITER_BUFSZ        (1U << 20)
+
+class BulkWriter {
+        private:
+                int             fd;
+                uint32_t        *buf;
+                uint64_t        pos;
+                uint64_t        size;
+
+                void writev_all(struct iovec *iov, int iovcnt);
+
+        public:
+                uint64_t        written;
+
+                BulkWriter(const char *filen, uint64_t bufsz);
+                ~BulkWriter();
+
+                /*
+                 * Integers are copied into the buffer, and an array
+                 * larger than the buffer is written with a single
+                 * writev() together with buffered data.
+                 */
+                void write(uint32_t *in, uint64_t len);
+                void flush();
+};
+
+#endif /* BULKWRITER_HPP */
@@ -0,0 +1,126 @@
+/*-----------------------------------------------------------------------------
+ *  TOCReader.hpp - A reader of a compressed file and its TOC.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef TOCREADER_HPP
+#define TOCREADER_HPP
+
+#include "open_coders.hpp"
+
+/*
+ * A compressed file and its TOC mapped in memory, where a header of
+ * the TOC is validated first. Entries are read by an index of lists.
+ */
+class TOCReader {
+        private:
+                uint32_t        *cmp_addr;
+                uint32_t        *toc_addr;
+                uint64_t        cmpsz;
+                uint64_t        tocsz;
+                uint32_t        *toc;
+
+        public:
+                uint32_t        flags;
+                uint32_t        numHeaders;
+
+                /*
+                 * The TOC is the file name + TOCEXT. A compressed file
+                 * is mapped writable for decoders modifying it, and
+                 * opts are options of int_utils::open_and_mmap_file().
+                 */
+                TOCReader(const char *filen, bool write, uint32_t opts = 0);
+                ~TOCReader();
+
+                /* A TOC is unmapped if its entries are no longer read */
+                void closeTOC();
+
+                uint32_t *cmpAddr() {
+                        return cmp_addr;
+                }
+
+                /* The end of a last list in words */
+                uint64_t cmpLen() {
+                        return __cmp_len(cmpsz);
+                }
+
+                uint64_t tocSize() {
+                        return tocsz;
+                }
+
+                /* Entries following the header */
+                uint32_t *entries() {
+                        return toc;
+                }
+
+                uint32_t num(uint32_t j) {
+                        return __toc_num(toc, j);
+                }
+
+                uint32_t first(uint32_t j) {
+                        return __toc_first(toc, j);
+                }
+
+                uint32_t last(uint32_t j) {
+                        return __toc_last(toc, j);
+                }
+
+                uint64_t pos(uint32_t j) {
+                        return __toc_pos(toc, j);
+                }
+
+                /* The position where the j-th list ends */
+                uint64_t nextPos(uint32_t j) {
+                        if (__likely(j != numHeaders - 1))
+                                return __toc_blkpos(__toc_pos(toc, j + 1));
+
+                        return cmpLen();
+                }
+
+                /* The largest # of integers in a list (or chunk) */
+                uint32_t maxNum();
+};
+
+/*
+ * A shared block of short lists last decoded. A block is decoded as a
+ * whole, and kept until a list in other blocks is read.
+ */
+class ShortBlock {
+        private:
+                uint64_t        pos;
+                uint32_t        vals[SHRBLKLEN + TAIL_MERGIN];
+
+        public:
+                ShortBlock() : pos(UINT64_MAX) {}
+
+                /* A short list at p of a TOC entry is in the block */
+                bool cached(uint64_t p) {
+                        return __toc_blkpos(p) == pos;
+                }
+
+                /* It returns the # of words read from cmp_addr */
+                uint32_t decode(uint32_t *cmp_addr, uint64_t p);
+
+                /* Values of a short list at p, whose block is decoded */
+                uint32_t *values(uint64_t p) {
+                        return vals + __toc_blkoff(p);
+                }
+
+                uint32_t *read(uint32_t *cmp_addr, uint64_t p) {
+                        if (!cached(p))
+                                decode(cmp_addr, p);
+
+                        return values(p);
+                }
+};
+
+#endif /* TOCREADER_HPP */
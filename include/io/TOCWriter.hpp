@@ -0,0 +1,75 @@
+/*-----------------------------------------------------------------------------
+ *  TOCWriter.hpp - A writer of a compressed file and its TOC.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef TOCWRITER_HPP
+#define TOCWRITER_HPP
+
+#include "open_coders.hpp"
+#include "compress/ParallelList.hpp"
+
+/*
+ * Lists are written into a compressed file, and an entry of each list
+ * is written into its TOC, which is the file name + TOCEXT. A list is
+ * either a long one, whose chunks are written between beginList() and
+ * endList(), or a short one packed into a pending shared block.
+ */
+class TOCWriter {
+        private:
+                FILE            *cmp;
+                FILE            *toc;
+                uint64_t        cmp_pos;
+                uint64_t        list_pos;
+                uint32_t        *cmp_array;
+                uint64_t        cmp_cap;
+
+                /* A pending block of short lists */
+                uint32_t        *blk;
+                uint32_t        blk_n;
+
+                void putEntry(uint32_t num, uint32_t first,
+                                uint32_t last, uint64_t p);
+                void flushShort();
+
+        public:
+                /* A header with flags is written in the TOC first */
+                TOCWriter(const char *filen, uint32_t flags);
+
+                /* A pending block and padding are written before closing */
+                ~TOCWriter();
+
+                /*
+                 * A long list starts at the current position, and its
+                 * entry is written at the end, where a last docID is
+                 * known after its chunks are read.
+                 */
+                void beginList();
+                void endList(uint32_t num, uint32_t first, uint32_t last);
+
+                /* A short list with n values of at most SHRBLKLEN */
+                void writeShort(uint32_t num, uint32_t first, uint32_t last,
+                                uint32_t *vals, uint32_t n);
+
+                /*
+                 * A chunk of a long list is encoded by enc, or in
+                 * sub-blocks by par if not NULL. A chunked list needs
+                 * the size of each chunk.
+                 */
+                void encodeChunk(pt2Enc enc, ParallelList *par,
+                                uint32_t *list, uint32_t nchunk, bool chunked);
+
+                /* Words already compressed follow a long list */
+                void write(uint32_t *in, uint64_t len);
+};
+
+#endif /* TOCWRITER_HPP */
@@ -44,17 +44,44 @@
 #include "utils/int_utils.hpp"
 
 /* Configure parameters */
-#define MAXLEN          200000000
 #define SKIP            32
 
-/* Magic numbers */
+/*
+ * Lists longer than CHUNKLEN are split into chunks, and each chunk
+ * is encoded separately so that encoders/decoders work in bounded
+ * memory. In a compressed file, each chunk of these lists is headed
+ * by its compressed size in 32-bit words.
+ */
+#define CHUNKLEN        (1U << 24)
+
+/*
+ * Magic numbers, which head a TOC with flags of its compressed file:
+ *      [MAGIC_NUM][VMAJOR][VMINOR][flags]
+ */
 #define MAGIC_NUM       0x0f823cb4
 #define VMAJOR          0
-#define VMINOR          2
+#define VMINOR          8
+
+/*
+ * Lists (or chunks) longer than PLIST_SUBLEN are in sub-blocks by
+ * ParallelList, which only encoders -t writes for docIDs.
+ */
+#define TOC_SUBBLOCKS   0x01
+#define TOC_FLAGS       TOC_SUBBLOCKS
 
 /* A extension for a location file */
 #define TOCEXT          ".TOC"
 #define DECEXT          ".DEC"
+
+/*
+ * Term-frequency and position streams are optionally stored in their
+ * own compressed files next to docIDs, each with a TOC of the same
+ * layout, e.g., "in.FRQ.VSE" and "in.FRQ.VSE.TOC". Entries in these
+ * TOCs are parallel to those of docIDs.
+ */
+#define FRQEXT          ".FRQ"
+#define POSEXT          ".POS"
+
 #define NFILENAME       256
 #define NEXTNAME        32
 
@@ -65,47 +92,94 @@
  */
 #define TAIL_MERGIN     128
 
+/*
+ * The upper bound of compressed size for n integers. Bit-oriented
+ * coders (e.g., Gamma and Delta) could take about 64 bits for a
+ * large integer.
+ */
+#define __cmp_bound(n)  (2 * (uint64_t)(n) + TAIL_MERGIN)
+
+/*
+ * Decoders read up to TAIL_MERGIN words past a list as well, so a
+ * compressed file ends with TAIL_MERGIN zero words after the last
+ * list. __cmp_len() is the end of the last list for a file of sz
+ * bytes, which is checked by __cmp_validate() first.
+ */
+#define __cmp_len(sz)   (((sz) >> 2) - TAIL_MERGIN)
+
+#define __cmp_validate(sz)      \
+        do {                    \
+                if ((sz) < TAIL_MERGIN * sizeof(uint32_t))      \
+                        eoutput("Not support input format");    \
+        } while (0)
+
 /*
  * Macros for reading files. A header for each compressed list
- * is composed of three etnries: the total of integers, a first
- * integer, and the next posision of a list.
+ * is composed of four etnries: the total of integers, a first
+ * integer, a last integer, and the next posision of a list. A
+ * last integer is a last docID, which merger reads instead of
+ * decoding a list, and 0 in TOCs of frequencies and positions.
  *
  * NOTICE: We assume that the size of each entry is 4B, and 
  * the alignment follows little-endian.
  */
-#define EACH_HEADER_TOC_SZ      4
+#define EACH_HEADER_TOC_SZ      5
+
+/*
+ * Lists with at most SKIP integers are packed into shared blocks of
+ * up to SHRBLKLEN integers, and a pending block is placed in a
+ * compressed file before a next long list. A block is headed by
+ * (compressed size << SHR_OFFBITS | # of integers). The TOC entry of
+ * a packed list has the same layout, and its pointer is flagged by
+ * TOC_SHORT with the position of a block and its offset in the block.
+ */
+#define SHRBLKLEN       128
+#define SHR_OFFBITS     8
+#define TOC_SHORT       (1ULL << 63)
+
+#define __toc_short(blk, off)   \
+        (TOC_SHORT | ((uint64_t)(blk) << SHR_OFFBITS) | (off))
+
+#define __toc_blkpos(p) \
+        (((p) & TOC_SHORT)? ((p) & ~TOC_SHORT) >> SHR_OFFBITS : (p))
+
+#define __toc_blkoff(p) ((p) & ((1U << SHR_OFFBITS) - 1))
 
 #define __next_read32(addr, len)  addr[len++]
 
-#define __next_read64(addr, len)        \
-        ({      \
-                uint64_t        ret;    \
-\
-                ret = addr[len + 1];    \
-                ret = (ret << 32) | addr[len];  \
-                len += 2;               \
-\
-                ret;                    \
-         })
+/*
+ * Fields of the j-th entry in TOC entries following a header. A list
+ * ends at the block position of a next entry, or at __cmp_len() for
+ * a last list. __toc_put() builds the j-th entry in this layout.
+ */
+#define __toc_num(toc, j)       ((toc)[(uint64_t)(j) * EACH_HEADER_TOC_SZ])
+#define __toc_first(toc, j)     ((toc)[(uint64_t)(j) * EACH_HEADER_TOC_SZ + 1])
+#define __toc_last(toc, j)      ((toc)[(uint64_t)(j) * EACH_HEADER_TOC_SZ + 2])
 
-#define __next_pos64(addr, len)         \
-        ({      \
-                uint64_t        nxlen;  \
-                uint64_t        ret;    \
-\
-                nxlen = len + EACH_HEADER_TOC_SZ - 2;   \
-\
-                ret = addr[nxlen + 1];  \
-                ret = (ret << 32) | addr[nxlen];        \
-\
-                ret;                    \
-         })
+#define __toc_pos(toc, j)       \
+        ((toc)[(uint64_t)(j) * EACH_HEADER_TOC_SZ + 3] |        \
+         ((uint64_t)(toc)[(uint64_t)(j) * EACH_HEADER_TOC_SZ + 4] << 32))
 
-#if HAVE_DECL_POSIX_FADVISE && defined(HAVE_POSIX_FADVISE)
+#define __toc_put(toc, j, num, first, last, pos)        \
+        do {                    \
+                uint32_t        *__ent; \
+\
+                __ent = (toc) + (uint64_t)(j) * EACH_HEADER_TOC_SZ;     \
+                __ent[0] = (num);       \
+                __ent[1] = (first);     \
+                __ent[2] = (last);      \
+                __ent[3] = (uint64_t)(pos) & UINT32_MAX;        \
+                __ent[4] = (uint64_t)(pos) >> 32;       \
+        } while (0)
+
+#if (HAVE_DECL_POSIX_FADVISE && defined(HAVE_POSIX_FADVISE)) || defined(__linux__)
  #define __fadvise_sequential(fd, len)   \
         posix_fadvise(fd, 0, len, POSIX_FADV_SEQUENTIAL)
+ #define __fadvise_dontneed(fd, off, len)        \
+        posix_fadvise(fd, off, len, POSIX_FADV_DONTNEED)
 #else
  #define __fadvise_sequential(fd, len)
+ #define __fadvise_dontneed(fd, off, len)
 #endif
 
 /* Support for over 4GiB files on 32-bit platform */
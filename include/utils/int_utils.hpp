@@ -24,16 +24,43 @@
                 d;                      \
         })
 
+#define __log2_uint64(_arg1)            \
+        ({                              \
+                uint64_t        d;      \
+                __asm__("bsrq %1, %0;" :"=r"(d) :"r"(_arg1));   \
+                d;                      \
+        })
+
 #define __array_size(x)         (sizeof(x) / sizeof(x[0]))
 
+/* Options for open_and_mmap_file() */
+#define MMAP_HUGEPAGE   0x01    /* Aligned to 2MiB, and madvise(MADV_HUGEPAGE) */
+#define MMAP_PREFAULT   0x02    /* Mapped with MAP_POPULATE */
+#define MMAP_MLOCK      0x04    /* Locked with mlock() */
+#define MMAP_WARMUP     0x08    /* Touch every page once after mapping */
+
+#define HUGEPAGE_SZ     (1ULL << 21)
+
 class int_utils {
         public:
                 static int get_msb(uint32_t v);
+                static int get_msb(uint64_t v);
                 static uint32_t div_roundup(uint32_t v, uint32_t div);
                 static double get_time(void);
+
+                /* Elapsed time, as get_time() sums CPU time of threads */
+                static double get_wall_time(void);
                 static uint32_t *open_and_mmap_file(char *filen,
-                                bool write, uint64_t &len);
+                                bool write, uint64_t &len, uint32_t opts = 0);
                 static void close_file(uint32_t *adr, uint64_t len);
+
+                /*
+                 * Make sure that *adr has a room for need integers. If
+                 * not, it is re-allocated by doubling its capacity, and
+                 * previous contents are discarded.
+                 */
+                static uint32_t *reserve_array(uint32_t *adr,
+                                uint64_t &cap, uint64_t need);
 };
 
 #endif  /* INT_UTILS_HPP */
@@ -0,0 +1,53 @@
+/*-----------------------------------------------------------------------------
+ *  numa_utils.hpp - Utilities to place memory and threads on NUMA nodes
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef NUMA_UTILS_HPP
+#define NUMA_UTILS_HPP
+
+#include "open_coders.hpp"
+
+/*
+ * Nodes are read from sysfs, and memory is bound with the mbind()
+ * syscall, so that libnuma is not needed. On a machine without NUMA,
+ * there is a single node 0, and binding is a no-op.
+ */
+#define NUMA_SYSFS      "/sys/devices/system/node"
+#define NUMA_MAXNODES   64
+
+class numa_utils {
+        public:
+                /* # of online nodes, or 1 if unknown */
+                static uint32_t num_nodes(void);
+
+                /*
+                 * Pin a calling thread to CPUs of a node. It returns
+                 * false if the node has no CPU or the pinning fails.
+                 */
+                static bool pin_thread(uint32_t node);
+
+                /*
+                 * Allocate len bytes of anonymous memory whose pages
+                 * are placed on a node when first touched, so a copy
+                 * of a mapped file in it is local to the node. If
+                 * binding fails, it falls back to the first-touch
+                 * policy of a calling thread.
+                 */
+                static uint32_t *alloc_on_node(uint64_t len, uint32_t node);
+                static void free_on_node(uint32_t *adr, uint64_t len);
+
+                /* A node where a page at adr is, or -1 if unknown */
+                static int node_of(void *adr);
+};
+
+#endif  /* NUMA_UTILS_HPP */
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Number of integers in a list: a few blocks, and long lists
+T="128 1024 1048576"
+
+if [ ! -x ./test/unpackbench ]; then
+        echo 'Exception: unpackbench not existed'
+        exit 1
+fi
+
+# Output headers
+echo "Unpacking Benchmarks:"
+echo "/* --- Show Decoding Time(ns/int) per Width --- */"
+echo
+
+for t in $T; do
+        # Run the original unpacking functions, BMI2 ones, and AVX-512 ones
+        OPEN_CODERS_NO_BMI2=1 OPEN_CODERS_NO_AVX512=1 \
+                ./test/unpackbench $t > orig.output || exit 1
+        OPEN_CODERS_NO_AVX512=1 ./test/unpackbench $t > bmi2.output || exit 1
+        ./test/unpackbench $t > avx512.output || exit 1
+
+        echo "N=$t"
+        grep -h '^# [A-Z]' bmi2.output avx512.output | sort -u
+        echo -e 'coder\t\twidth\torig\tbmi2\tavx512'
+        echo '============'
+
+        # Join results by lines, all in the same order
+        paste <(grep -v '^#' orig.output) <(grep -v '^#' bmi2.output) \
+                <(grep -v '^#' avx512.output) | \
+                awk '{ printf "%-16s%s\t%s\t%s\t%s\n", $1, $2, $3, $6, $9 }'
+
+        echo
+done
+
+# Remove
+rm -rf orig.output bmi2.output avx512.output
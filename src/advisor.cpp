@@ -0,0 +1,601 @@
+/*-----------------------------------------------------------------------------
+ *  advisor.cpp - An advisor to report sizes and decoding speeds of coders
+ *      for each class of lists in an index, and recommend a coder mix.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "encoders.hpp"
+#include "decoders.hpp"
+
+#include <getopt.h>
+
+using namespace std;
+
+/*
+ * Lists are classified by their lengths and the entropy of d-gaps, i.e.,
+ * (SKIP, 128], (128, 1K], (1K, 8K], (8K, 64K], (64K, 512K], and (512K, -)
+ * for lengths, and [0, 1), [1, 2), [2, 4), [4, 8), [8, 12), and [12, -)
+ * bits per gap for entropies.
+ */
+#define NLENCLASS       6
+#define NENTCLASS       6
+#define NBUCKETS        (NLENCLASS * NENTCLASS)
+
+/* The default # of sampled lists for each bucket */
+#define NSAMPLES        8
+
+/*
+ * Only heads of long lists are sampled to bound memory. Coders see
+ * the same distribution of gaps in the rest of them.
+ */
+#define SAMPLELEN       (1U << 16)
+
+/* # of integers decoded in a trial, so that short lists are repeated */
+#define NTRIAL_INTS     (1U << 22)
+#define NTRIALS         3
+
+/* The default weight of decoding time in ns/int against bits/int */
+#define LAMBDA          1.0
+
+static uint32_t __lenlimits[NLENCLASS - 1] = {
+        128, 1024, 8192, 65536, 524288
+};
+
+static double __entlimits[NENTCLASS - 1] = {
+        1.0, 2.0, 4.0, 8.0, 12.0
+};
+
+struct __sample {
+        uint32_t        first;
+        uint32_t        n;
+        uint32_t        *gaps;
+};
+
+struct __bucket {
+        uint64_t        nlists;
+        uint64_t        nints;
+        uint32_t        nsamples;
+        struct __sample *samples;
+
+        /* Results of each coder, and a negative value means not tested */
+        double          bpi[NUMENCODERS];
+        double          npi[NUMENCODERS];
+        int             decID[NUMENCODERS];
+};
+
+static void __usage(const char *msg, ...);
+static bool __coder_ready(int encID);
+static double __gap_entropy(uint64_t *hist, uint64_t n);
+static uint32_t __classify(uint32_t num, double ent);
+static void __evaluate(struct __bucket &bk, uint32_t *list,
+                uint32_t *dec, uint32_t *cmp_array);
+static void __report(struct __bucket *bks, uint64_t nints, double lambda);
+
+int
+main(int argc, char **argv)
+{
+        int             opt;
+        bool            has_freqs;
+        bool            has_pos;
+        char            *end;
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        b;
+        uint32_t        s;
+        uint32_t        maxs;
+        uint32_t        *list;
+        uint32_t        *dec;
+        uint32_t        *cmp_array;
+        uint64_t        lenmax;
+        uint64_t        nints;
+        uint64_t        hist[33];
+        double          lambda;
+        BulkReader      *in;
+        struct __bucket *bks;
+
+        has_freqs = has_pos = false;
+        maxs = NSAMPLES;
+        lambda = LAMBDA;
+
+        while ((opt = getopt(argc, argv, "fps:l:")) != -1) {
+                switch (opt) {
+                case 'f':
+                        has_freqs = true;
+                        break;
+                case 'p':
+                        has_pos = true;
+                        break;
+                case 's':
+                        maxs = strtol(optarg, &end, 10);
+
+                        if (*end != '\0' || maxs == 0)
+                                __usage("Invalid # of samples: %s", optarg);
+                        break;
+                case 'l':
+                        lambda = strtod(optarg, &end);
+
+                        if (*end != '\0' || lambda < 0.0)
+                                __usage("Invalid weight: %s", optarg);
+                        break;
+                default:
+                        __usage(NULL);
+                }
+        }
+
+        argc -= optind - 1;
+        argv += optind - 1;
+
+        if (argc < 2)
+                __usage(NULL);
+
+        if (has_pos && !has_freqs)
+                __usage("Positions need term frequencies (-f)");
+
+        bks = new struct __bucket[NBUCKETS];
+        list = new uint32_t[SAMPLELEN + TAIL_MERGIN];
+        dec = new uint32_t[SAMPLELEN + TAIL_MERGIN];
+        cmp_array = new uint32_t[__cmp_bound(SAMPLELEN)];
+
+        if (bks == NULL || list == NULL ||
+                        dec == NULL || cmp_array == NULL)
+                eoutput("Can't allocate memory");
+
+        for (b = 0; b < NBUCKETS; b++) {
+                bks[b].nlists = bks[b].nints = 0;
+                bks[b].nsamples = 0;
+                bks[b].samples = new struct __sample[maxs];
+
+                if (bks[b].samples == NULL)
+                        eoutput("Can't allocate memory");
+
+                for (s = 0; s < maxs; s++)
+                        bks[b].samples[s].gaps = NULL;
+        }
+
+        in = new BulkReader(argv[1], BULKREADER_BUFSZ);
+        lenmax = in->size();
+        nints = 0;
+
+        srand(0);
+
+        {
+                uint32_t        num;
+                uint32_t        n;
+                uint32_t        first_doc;
+                uint32_t        prev_doc;
+                uint32_t        cur_doc;
+                uint32_t        gap;
+                uint64_t        npos;
+                struct __bucket *bk;
+                struct __sample *sp;
+
+                /* The same format as the input of encoders */
+                while (in->tell() < lenmax) {
+                        num = in->next();
+
+                        if (in->tell() + num > lenmax)
+                                break;
+
+                        nints += num;
+                        first_doc = prev_doc = in->next();
+
+                        /*
+                         * Gaps are counted in classes of their widths, and
+                         * the head of a list is kept in case it is sampled.
+                         */
+                        memset(hist, 0, sizeof(hist));
+
+                        for (i = 0; i < num - 1; i++) {
+                                cur_doc = in->next();
+
+                                if (cur_doc < prev_doc)
+                                        cerr << "List ordering exception: list MUST be increasing" << endl;
+
+                                gap = cur_doc - prev_doc - 1;
+
+                                if (i < SAMPLELEN)
+                                        list[i] = gap;
+
+                                hist[int_utils::get_msb((uint64_t)gap + 1)]++;
+                                prev_doc = cur_doc;
+                        }
+
+                        /* Short lists go to shared blocks with E_SHORT */
+                        if (num > SKIP) {
+                                bk = &bks[__classify(num,
+                                                __gap_entropy(hist, num - 1))];
+
+                                bk->nlists++;
+                                bk->nints += num;
+
+                                /* Reservoir sampling of lists in a bucket */
+                                if (bk->nsamples < maxs)
+                                        j = bk->nsamples++;
+                                else
+                                        j = rand() % bk->nlists;
+
+                                if (j < maxs) {
+                                        n = (num - 1 < SAMPLELEN)?
+                                                num - 1 : SAMPLELEN;
+                                        sp = &bk->samples[j];
+
+                                        delete[] sp->gaps;
+                                        sp->gaps = new uint32_t[n];
+
+                                        if (sp->gaps == NULL)
+                                                eoutput("Can't allocate memory");
+
+                                        memcpy(sp->gaps, list,
+                                                        n * sizeof(uint32_t));
+                                        sp->first = first_doc;
+                                        sp->n = n;
+                                }
+                        }
+
+                        if (!has_freqs)
+                                continue;
+
+                        /* Only docIDs are analyzed for now */
+                        for (i = 0, npos = 0; i < num; i++)
+                                npos += in->next();
+
+                        if (has_pos)
+                                in->skip(npos);
+                }
+        }
+
+        delete in;
+
+        for (b = 0; b < NBUCKETS; b++)
+                __evaluate(bks[b], list, dec, cmp_array);
+
+        __report(bks, nints, lambda);
+
+        for (b = 0; b < NBUCKETS; b++) {
+                for (s = 0; s < bks[b].nsamples; s++)
+                        delete[] bks[b].samples[s].gaps;
+
+                delete[] bks[b].samples;
+        }
+
+        delete[] bks;
+        delete[] list;
+        delete[] dec;
+        delete[] cmp_array;
+
+        return EXIT_SUCCESS;
+}
+
+/*--- Intra functions below ---*/
+
+bool
+__coder_ready(int encID)
+{
+        /* Both are in progress, and terminate a process */
+        return encID != E_VSEREST && encID != E_VSEHYB;
+}
+
+double
+__gap_entropy(uint64_t *hist, uint64_t n)
+{
+        uint32_t        w;
+        double          p;
+        double          ent;
+
+        if (n == 0)
+                return 0.0;
+
+        /*
+         * Gaps are assumed to be uniform in each class [2^w, 2^(w + 1)),
+         * so entropy is that of the classes plus w bits in a class.
+         */
+        for (w = 0, ent = 0.0; w < 33; w++) {
+                if (hist[w] == 0)
+                        continue;
+
+                p = (double)hist[w] / n;
+                ent += p * (w - log2(p));
+        }
+
+        return ent;
+}
+
+uint32_t
+__classify(uint32_t num, double ent)
+{
+        uint32_t        l;
+        uint32_t        e;
+
+        for (l = 0; l < NLENCLASS - 1 && num > __lenlimits[l]; l++);
+        for (e = 0; e < NENTCLASS - 1 && ent >= __entlimits[e]; e++);
+
+        return l * NENTCLASS + e;
+}
+
+void
+__evaluate(struct __bucket &bk, uint32_t *list,
+                uint32_t *dec, uint32_t *cmp_array)
+{
+        int             e;
+        int             d;
+        uint32_t        i;
+        uint32_t        s;
+        uint32_t        t;
+        uint32_t        r;
+        uint32_t        R;
+        uint32_t        cur;
+        uint32_t        cmp_size;
+        uint32_t        **cmps;
+        uint32_t        *csizes;
+        uint64_t        n;
+        uint64_t        bits;
+        double          st;
+        double          et;
+        double          best;
+        struct __sample *sp;
+
+        for (e = 0; e < NUMENCODERS; e++) {
+                bk.bpi[e] = bk.npi[e] = -1.0;
+                bk.decID[e] = -1;
+        }
+
+        if (bk.nsamples == 0)
+                return;
+
+        cmps = new uint32_t*[bk.nsamples];
+        csizes = new uint32_t[bk.nsamples];
+
+        if (cmps == NULL || csizes == NULL)
+                eoutput("Can't allocate memory");
+
+        for (s = 0, n = 0; s < bk.nsamples; s++)
+                n += bk.samples[s].n;
+
+        R = (n < NTRIAL_INTS)? NTRIAL_INTS / n : 1;
+
+        for (e = 0; e < NUMENCODERS; e++) {
+                if (!__coder_ready(e))
+                        continue;
+
+                /* Compressed samples are kept for decoding trials */
+                for (s = 0, bits = 0; s < bk.nsamples; s++) {
+                        sp = &bk.samples[s];
+
+                        /* Some coders take absolute values */
+                        if (!__enc_absolute(e)) {
+                                memcpy(list, sp->gaps, sp->n * sizeof(uint32_t));
+                        } else {
+                                for (i = 0, cur = sp->first; i < sp->n; i++) {
+                                        cur += sp->gaps[i] + 1;
+                                        list[i] = cur;
+                                }
+                        }
+
+                        (encoders[e])(list, sp->n, cmp_array, cmp_size);
+
+                        cmps[s] = new uint32_t[cmp_size + TAIL_MERGIN];
+
+                        if (cmps[s] == NULL)
+                                eoutput("Can't allocate memory");
+
+                        memcpy(cmps[s], cmp_array, cmp_size * sizeof(uint32_t));
+                        csizes[s] = cmp_size;
+
+                        bits += 32 * (uint64_t)cmp_size;
+                }
+
+                bk.bpi[e] = (double)bits / n;
+
+                /* The fastest one in decoders for the same format is taken */
+                for (d = 0; d < NUMDECODERS; d++) {
+                        if (strcmp(dec_ext[d], enc_ext[e]) != 0)
+                                continue;
+
+                        for (t = 0, best = 0.0; t < NTRIALS; t++) {
+                                st = int_utils::get_time();
+
+                                for (r = 0; r < R; r++) {
+                                        for (s = 0; s < bk.nsamples; s++)
+                                                (decoders[d])(cmps[s], csizes[s],
+                                                        dec, bk.samples[s].n);
+                                }
+
+                                et = int_utils::get_time();
+
+                                if (t == 0 || et - st < best)
+                                        best = et - st;
+                        }
+
+                        /* Validation check with the last sample */
+                        sp = &bk.samples[bk.nsamples - 1];
+
+                        for (i = 0, cur = sp->first; i < sp->n; i++) {
+                                cur += sp->gaps[i] + 1;
+
+                                if (dec[i] != (!__enc_absolute(e)? sp->gaps[i] : cur)) {
+                                        cerr << "Decoding Exception(" << enc_ext[e] + 1
+                                                << ", " << d << ", " << i << ")" << endl;
+                                        break;
+                                }
+                        }
+
+                        if (i != sp->n)
+                                continue;
+
+                        if (bk.decID[e] < 0 || best * 1.0e9 / n / R < bk.npi[e]) {
+                                bk.npi[e] = best * 1.0e9 / n / R;
+                                bk.decID[e] = d;
+                        }
+                }
+
+                for (s = 0; s < bk.nsamples; s++)
+                        delete[] cmps[s];
+
+                /* A coder failing to decode is never recommended */
+                if (bk.decID[e] < 0)
+                        bk.bpi[e] = -1.0;
+        }
+
+        delete[] cmps;
+        delete[] csizes;
+}
+
+void
+__report(struct __bucket *bks, uint64_t nints, double lambda)
+{
+        int             e;
+        int             rec;
+        int             single;
+        uint32_t        b;
+        uint64_t        nlong;
+        uint64_t        share[NUMENCODERS];
+        double          cost;
+        double          rcost;
+        double          mix_bpi;
+        double          mix_npi;
+        double          tot[NUMENCODERS];
+        bool            valid[NUMENCODERS];
+
+        nlong = 0;
+        mix_bpi = mix_npi = 0.0;
+
+        for (e = 0; e < NUMENCODERS; e++) {
+                share[e] = 0;
+                tot[e] = 0.0;
+                valid[e] = __coder_ready(e);
+        }
+
+        cout << "# cost = bits/int + " << lambda << " * ns/int" << endl;
+
+        for (b = 0; b < NBUCKETS; b++) {
+                if (bks[b].nsamples == 0)
+                        continue;
+
+                cout << endl << "# length (" <<
+                        ((b / NENTCLASS == 0)? SKIP : __lenlimits[b / NENTCLASS - 1])
+                        << ", ";
+
+                if (b / NENTCLASS < NLENCLASS - 1)
+                        cout << __lenlimits[b / NENTCLASS] << "]";
+                else
+                        cout << "-)";
+
+                cout << " entropy [" <<
+                        ((b % NENTCLASS == 0)? 0.0 : __entlimits[b % NENTCLASS - 1])
+                        << ", ";
+
+                if (b % NENTCLASS < NENTCLASS - 1)
+                        cout << __entlimits[b % NENTCLASS] << ")";
+                else
+                        cout << "-)";
+
+                cout << ": " << bks[b].nlists << " lists, " << bks[b].nints
+                        << " ints (" << setprecision(3)
+                        << 100.0 * bks[b].nints / nints << "%), "
+                        << bks[b].nsamples << " sampled" << endl;
+                cout << "# coder encID decID bits/int ns/int" << endl;
+
+                for (e = 0, rec = -1, rcost = 0.0; e < NUMENCODERS; e++) {
+                        if (bks[b].bpi[e] < 0.0) {
+                                valid[e] = false;
+                                continue;
+                        }
+
+                        cout << enc_ext[e] + 1 << " " << e << " "
+                                << bks[b].decID[e] << " " << setprecision(3)
+                                << bks[b].bpi[e] << " " << bks[b].npi[e] << endl;
+
+                        cost = bks[b].bpi[e] + lambda * bks[b].npi[e];
+                        tot[e] += cost * bks[b].nints;
+
+                        if (rec < 0 || cost < rcost) {
+                                rec = e;
+                                rcost = cost;
+                        }
+                }
+
+                if (rec < 0)
+                        continue;
+
+                cout << "# recommended: " << enc_ext[rec] + 1 << endl;
+
+                share[rec] += bks[b].nints;
+                nlong += bks[b].nints;
+                mix_bpi += bks[b].bpi[rec] * bks[b].nints;
+                mix_npi += bks[b].npi[rec] * bks[b].nints;
+        }
+
+        if (nlong == 0) {
+                cout << "# No list longer than " << SKIP << endl;
+                return;
+        }
+
+        /* Short lists are always in shared blocks with E_SHORT */
+        cout << endl << "# coder mix for " << setprecision(3)
+                << 100.0 * nlong / nints << "% of ints in long lists" << endl;
+
+        for (e = 0; e < NUMENCODERS; e++) {
+                if (share[e] != 0)
+                        cout << enc_ext[e] + 1 << " " << e << " " << setprecision(3)
+                                << 100.0 * share[e] / nlong << "%" << endl;
+        }
+
+        cout << "# mix: " << setprecision(3) << mix_bpi / nlong
+                << " bits/int, " << mix_npi / nlong << " ns/int" << endl;
+
+        /* The best single coder for all the buckets for comparison */
+        for (e = 0, single = -1; e < NUMENCODERS; e++) {
+                if (valid[e] && (single < 0 || tot[e] < tot[single]))
+                        single = e;
+        }
+
+        if (single < 0)
+                return;
+
+        for (b = 0, mix_bpi = mix_npi = 0.0; b < NBUCKETS; b++) {
+                if (bks[b].nsamples == 0)
+                        continue;
+
+                mix_bpi += bks[b].bpi[single] * bks[b].nints;
+                mix_npi += bks[b].npi[single] * bks[b].nints;
+        }
+
+        cout << "# best single coder: " << enc_ext[single] + 1 << ", "
+                << setprecision(3) << mix_bpi / nlong << " bits/int, "
+                << mix_npi / nlong << " ns/int" << endl;
+}
+
+void
+__usage(const char *msg, ...)
+{
+        cout << "Usage: advisor [-f] [-p] [-s Samples] [-l Weight] <infilename>" << endl;
+
+        if (msg != NULL) {
+                va_list vargs;
+
+                va_start(vargs, msg);
+                vfprintf(stdout, msg, vargs);
+                va_end(vargs);
+
+                cout << endl;
+        }
+
+        cout << endl;
+        cout << "\t-f\tan input has term frequencies" << endl;
+        cout << "\t-p\tan input has positions" << endl;
+        cout << "\t-s\t# of sampled lists for each bucket (default: "
+                << NSAMPLES << ")" << endl;
+        cout << "\t-l\tweight of ns/int against bits/int in costs (default: "
+                << LAMBDA << ")" << endl << endl;
+
+        exit(1);
+}
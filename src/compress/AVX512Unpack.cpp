@@ -0,0 +1,70 @@
+/*-----------------------------------------------------------------------------
+ *  AVX512Unpack.cpp - Unpacking kernels with AVX-512 VBMI for any width.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/AVX512Unpack.hpp"
+
+/* A position in memory of the t-th byte in MSB-first words */
+#define __avx512_byte(t)        (((t) & ~3U) | (3 - ((t) & 3)))
+
+static bool __avx512_build_tables(void);
+
+uint8_t AVX512Unpack::perm[AVX512_MAXWIDTH + 1][2][64]
+        __attribute__((aligned(64)));
+uint32_t AVX512Unpack::shift[AVX512_MAXWIDTH + 1][2][AVX512_LANES]
+        __attribute__((aligned(64)));
+
+static bool __avx512_tables __attribute__((unused)) = __avx512_build_tables();
+
+bool
+AVX512Unpack::available(void)
+{
+        /* Called by static initializers in coders */
+        __builtin_cpu_init();
+
+        if (!__builtin_cpu_supports("avx512f") ||
+                        !__builtin_cpu_supports("avx512bw") ||
+                        !__builtin_cpu_supports("avx512vbmi"))
+                return false;
+
+        return getenv("OPEN_CODERS_NO_AVX512") == NULL;
+}
+
+/* --- Intra functions below --- */
+
+bool
+__avx512_build_tables(void)
+{
+        uint32_t        b;
+        uint32_t        o;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        p;
+
+        for (b = 1; b <= AVX512_MAXWIDTH; b++) {
+                for (o = 0; o < 2; o++) {
+                        for (j = 0; j < AVX512_LANES; j++) {
+                                p = 16 * o + j * b;
+
+                                /* The first byte comes in the top of a lane */
+                                for (k = 0; k < 4; k++)
+                                        AVX512Unpack::perm[b][o][4 * j + k] =
+                                                __avx512_byte((p >> 3) + 3 - k);
+
+                                AVX512Unpack::shift[b][o][j] = 32 - b - (p & 7);
+                        }
+                }
+        }
+
+        return true;
+}
@@ -0,0 +1,190 @@
+/*-----------------------------------------------------------------------------
+ *  AppendList.cpp - A compressed list growing by appended docIDs.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/AppendList.hpp"
+
+AppendSnapshot::AppendSnapshot()
+{
+        dec = NULL;
+        cmplen = 0;
+        num = 0;
+        first = 0;
+        ntail = 0;
+}
+
+void
+AppendSnapshot::decodeArray(uint32_t *out)
+{
+        uint32_t        csize;
+        uint64_t        pos;
+
+        for (pos = 0; pos < cmplen; pos += csize) {
+                csize = cmp[pos++];
+
+                if (csize == APPEND_SLACK) {
+                        csize = TAIL_MERGIN;
+                        continue;
+                }
+
+                (dec)(cmp.get() + pos, csize, out, APPEND_BLOCKSZ);
+                out += APPEND_BLOCKSZ;
+        }
+
+        memcpy(out, tail, ntail * sizeof(uint32_t));
+}
+
+AppendList::AppendList(pt2Enc enc, pt2Dec dec, uint32_t first)
+{
+        __assert(enc != NULL && dec != NULL);
+
+        this->enc = enc;
+        this->dec = dec;
+
+        /* An area is taken when a first block is sealed */
+        cmpcap = 0;
+        cmplen = 0;
+
+        num = 1;
+        this->first = last = first;
+        ntail = 0;
+
+        /* No block is read past yet */
+        slack = true;
+
+        pthread_mutex_init(&mtx, NULL);
+}
+
+AppendList::~AppendList()
+{
+        pthread_mutex_destroy(&mtx);
+}
+
+void
+AppendList::append(uint32_t docid)
+{
+        append(&docid, 1);
+}
+
+void
+AppendList::append(uint32_t *docs, uint32_t n)
+{
+        uint32_t        i;
+
+        pthread_mutex_lock(&mtx);
+
+        for (i = 0; i < n; i++) {
+                if (docs[i] <= last)
+                        eoutput("Not increasing docID: %u after %u", docs[i], last);
+
+                tail[ntail++] = docs[i] - last - 1;
+                last = docs[i];
+                num++;
+
+                if (ntail == APPEND_BLOCKSZ)
+                        seal();
+        }
+
+        pthread_mutex_unlock(&mtx);
+}
+
+/*
+ * Decoders of a snapshot read up to TAIL_MERGIN words past its last
+ * block, so a slack record is placed there before the snapshot is
+ * taken, and next blocks are written after it. A record is placed
+ * once between blocks, however many snapshots are taken.
+ */
+void
+AppendList::snapshot(AppendSnapshot &snap)
+{
+        uint64_t        len;
+
+        pthread_mutex_lock(&mtx);
+
+        len = cmplen;
+
+        if (!slack) {
+                reserve(cmplen + 1 + TAIL_MERGIN);
+
+                cmp[cmplen] = APPEND_SLACK;
+                memset(cmp.get() + cmplen + 1, 0, TAIL_MERGIN * sizeof(uint32_t));
+
+                cmplen += 1 + TAIL_MERGIN;
+                slack = true;
+        }
+
+        snap.dec = dec;
+        snap.cmp = cmp;
+        snap.cmplen = len;
+        snap.num = num;
+        snap.first = first;
+        snap.ntail = ntail;
+
+        memcpy(snap.tail, tail, ntail * sizeof(uint32_t));
+
+        pthread_mutex_unlock(&mtx);
+}
+
+uint32_t
+AppendList::size()
+{
+        uint32_t        n;
+
+        pthread_mutex_lock(&mtx);
+        n = num;
+        pthread_mutex_unlock(&mtx);
+
+        return n;
+}
+
+/* An area is replaced with a larger copy if need words do not fit */
+void
+AppendList::reserve(uint64_t need)
+{
+        uint32_t        *area;
+
+        if (need <= cmpcap)
+                return;
+
+        cmpcap = (2 * cmpcap > need)? 2 * cmpcap : need;
+        area = new uint32_t[cmpcap];
+
+        if (area == NULL)
+                eoutput("Can't allocate memory");
+
+        if (cmplen > 0)
+                memcpy(area, cmp.get(), cmplen * sizeof(uint32_t));
+
+        cmp.reset(area);
+}
+
+/*
+ * A full tail is encoded after sealed blocks. Snapshots and what their
+ * decoders read end before cmplen (See snapshot()), so a block is
+ * written there in place while room remains, and otherwise in a
+ * larger copy of the area.
+ */
+void
+AppendList::seal()
+{
+        uint32_t        csize;
+
+        reserve(cmplen + 1 + __cmp_bound(APPEND_BLOCKSZ));
+
+        (enc)(tail, APPEND_BLOCKSZ, cmp.get() + cmplen + 1, csize);
+
+        cmp[cmplen] = csize;
+        cmplen += 1 + csize;
+        ntail = 0;
+        slack = false;
+}
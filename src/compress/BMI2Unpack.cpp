@@ -0,0 +1,31 @@
+/*-----------------------------------------------------------------------------
+ *  BMI2Unpack.cpp - Unpacking kernels with BMI2 for odd bit widths.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/BMI2Unpack.hpp"
+
+bool
+BMI2Unpack::available(void)
+{
+        /* Called by static initializers in coders */
+        __builtin_cpu_init();
+
+        if (!__builtin_cpu_supports("bmi2"))
+                return false;
+
+        /* pdep is microcoded, and much slower than shifts before Zen3 */
+        if (__builtin_cpu_is("amdfam15h") || __builtin_cpu_is("amdfam17h"))
+                return false;
+
+        return getenv("OPEN_CODERS_NO_BMI2") == NULL;
+}
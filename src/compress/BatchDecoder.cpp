@@ -0,0 +1,113 @@
+/*-----------------------------------------------------------------------------
+ *  BatchDecoder.cpp - A decoder for a batch of lists hiding memory latency.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/BatchDecoder.hpp"
+
+/* A state of a list decoded in turn */
+struct __batch_way {
+        BatchList       *l;
+        uint32_t        k;
+        uint32_t        p;
+        uint32_t        *data;
+};
+
+void
+BatchDecoder::decodeLists(pt2Dec dec, BatchList *lists,
+                uint32_t n, uint32_t dist)
+{
+        uint32_t        i;
+
+        __assert(dec != NULL);
+
+        for (i = 0; i < dist && i < n; i++)
+                prefetch(lists[i].in, BATCH_PFLINES);
+
+        for (i = 0; i < n; i++) {
+                if (i + dist < n)
+                        prefetch(lists[i + dist].in, BATCH_PFLINES);
+
+                if (lists[i].num > 0)
+                        (dec)(lists[i].in, lists[i].csize,
+                                        lists[i].out, lists[i].num);
+        }
+}
+
+void
+BatchDecoder::decodeInterleaved(pt2Block dec, BatchList *lists,
+                uint32_t n, uint32_t nways)
+{
+        uint32_t        i;
+        uint32_t        w;
+        uint32_t        next;
+        uint32_t        nactive;
+        uint32_t        nd;
+        __batch_way     *wy;
+        __batch_way     ways[BATCH_MAXWAYS];
+
+        __assert(dec != NULL);
+
+        if (nways == 0)
+                nways = 1;
+        if (nways > BATCH_MAXWAYS)
+                nways = BATCH_MAXWAYS;
+
+        /* Heads of lists taking ways next are in flight as well */
+        for (i = 0; i < 2 * nways && i < n; i++)
+                prefetch(lists[i].in, BATCH_PFLINES);
+
+        for (next = 0, nactive = 0; nactive < nways && next < n; next++) {
+                if (lists[next].num == 0)
+                        continue;
+
+                wy = &ways[nactive++];
+                wy->l = &lists[next];
+                wy->k = wy->p = 0;
+                wy->data = NULL;
+        }
+
+        while (nactive > 0) {
+                for (w = 0; w < nactive; ) {
+                        wy = &ways[w];
+
+                        nd = (dec)(wy->l->in, PCURSOR_BLOCKSZ,
+                                        wy->l->num - wy->k, wy->p,
+                                        wy->data, wy->l->out + wy->k);
+                        wy->k += nd;
+
+                        if (wy->k < wy->l->num) {
+                                /* Loaded until this way comes again */
+                                prefetch(wy->data, 2);
+                                w++;
+                                continue;
+                        }
+
+                        /* A list ends, and a next one takes the way */
+                        while (next < n && lists[next].num == 0)
+                                next++;
+
+                        if (next < n) {
+                                if (next + nways < n)
+                                        prefetch(lists[next + nways].in,
+                                                        BATCH_PFLINES);
+
+                                wy->l = &lists[next++];
+                                wy->k = wy->p = 0;
+                                wy->data = NULL;
+                                w++;
+                        } else {
+                                *wy = ways[--nactive];
+                        }
+                }
+        }
+}
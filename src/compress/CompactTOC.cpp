@@ -0,0 +1,293 @@
+/*-----------------------------------------------------------------------------
+ *  CompactTOC.cpp - A compressed TOC with random access to its entries.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/CompactTOC.hpp"
+
+static uint32_t __ctoc_width(uint32_t v);
+static inline uint32_t __ctoc_nwords(uint32_t n, uint32_t w)
+        __attribute__((always_inline));
+static uint32_t __ctoc_blkpos(uint32_t *toc, uint32_t numHeaders,
+                uint64_t cmplen, uint32_t b, uint32_t *vals, uint64_t &base);
+static void __ctoc_put(uint32_t *data, uint64_t bp, uint32_t v, uint32_t w);
+static inline uint32_t __ctoc_get(uint32_t *data, uint64_t bp, uint32_t w)
+        __attribute__((always_inline));
+
+CompactTOC::CompactTOC(uint32_t *toc, uint32_t numHeaders, uint64_t cmplen)
+{
+        uint32_t        b;
+        uint32_t        j;
+        uint32_t        beg;
+        uint32_t        end;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        wn;
+        uint32_t        wf;
+        uint32_t        wo;
+        uint32_t        csize;
+        uint32_t        minNum;
+        uint32_t        maxNum;
+        uint32_t        minFirst;
+        uint32_t        maxFirst;
+        uint32_t        maxOff;
+        uint32_t        *vals;
+        uint64_t        p;
+        uint64_t        bp;
+        uint64_t        nw;
+        struct __ctoc_block     *blk;
+
+        this->numHeaders = numHeaders;
+
+        /* A last block has cmplen at least */
+        nblocks = numHeaders / CTOC_BLOCKSZ + 1;
+
+        blks = new struct __ctoc_block[nblocks];
+        vals = new uint32_t[CTOC_BLOCKSZ];
+
+        if (blks == NULL || vals == NULL)
+                eoutput("Can't allocate memory");
+
+        /* Widths and sizes of each block are found first */
+        for (b = 0, datalen = 0; b < nblocks; b++) {
+                beg = b * CTOC_BLOCKSZ;
+                end = (beg + CTOC_BLOCKSZ < numHeaders)?
+                        beg + CTOC_BLOCKSZ : numHeaders;
+
+                minNum = minFirst = (beg < end)? UINT32_MAX : 0;
+                maxNum = maxFirst = maxOff = 0;
+
+                for (j = beg; j < end; j++) {
+                        minNum = std::min(minNum, __toc_num(toc, j));
+                        maxNum = std::max(maxNum, __toc_num(toc, j));
+                        minFirst = std::min(minFirst, __toc_first(toc, j));
+                        maxFirst = std::max(maxFirst, __toc_first(toc, j));
+
+                        if (__toc_pos(toc, j) & TOC_SHORT)
+                                maxOff = std::max(maxOff, (uint32_t)
+                                        __toc_blkoff(__toc_pos(toc, j)) + 1);
+                }
+
+                wn = __ctoc_width(maxNum - minNum);
+                wf = __ctoc_width(maxFirst - minFirst);
+                wo = __ctoc_width(maxOff);
+
+                if (datalen > UINT32_MAX)
+                        eoutput("Too large TOC to be compacted");
+
+                blk = blks + b;
+                blk->off = datalen;
+                blk->minNum = minNum;
+                blk->minFirst = minFirst;
+                blk->widths = wn | (wf << 8) | (wo << 16);
+
+                cnt = __ctoc_blkpos(toc, numHeaders, cmplen, b, vals, blk->base);
+
+                datalen += __ctoc_nwords(end - beg, wn + wf + wo) +
+                        EliasFano::costEF(cnt, (uint64_t)vals[cnt - 1] + 1) / 32;
+        }
+
+        /* A word more for reading 64 bits at a time */
+        data = new uint32_t[datalen + 1];
+
+        if (data == NULL)
+                eoutput("Can't allocate memory");
+
+        memset(data, 0, (datalen + 1) * sizeof(uint32_t));
+
+        for (b = 0; b < nblocks; b++) {
+                beg = b * CTOC_BLOCKSZ;
+                end = (beg + CTOC_BLOCKSZ < numHeaders)?
+                        beg + CTOC_BLOCKSZ : numHeaders;
+
+                blk = blks + b;
+
+                wn = blk->widths & 0xff;
+                wf = (blk->widths >> 8) & 0xff;
+                wo = blk->widths >> 16;
+
+                for (j = beg; j < end; j++) {
+                        p = __toc_pos(toc, j);
+                        off = (p & TOC_SHORT)? __toc_blkoff(p) + 1 : 0;
+
+                        bp = (uint64_t)blk->off * 32 +
+                                (uint64_t)(j - beg) * (wn + wf + wo);
+
+                        __ctoc_put(data, bp, __toc_num(toc, j) - blk->minNum, wn);
+                        __ctoc_put(data, bp + wn,
+                                        __toc_first(toc, j) - blk->minFirst, wf);
+                        __ctoc_put(data, bp + wn + wf, off, wo);
+                }
+
+                /* Positions follow the fields */
+                nw = blk->off + __ctoc_nwords(end - beg, wn + wf + wo);
+                cnt = __ctoc_blkpos(toc, numHeaders, cmplen, b, vals, p);
+
+                EliasFano::encodeEF(vals, cnt, data + nw, csize);
+
+                __assert(nw + csize == ((b + 1 < nblocks)?
+                                blks[b + 1].off : datalen));
+        }
+
+        delete[] vals;
+}
+
+CompactTOC::~CompactTOC()
+{
+        delete[] blks;
+        delete[] data;
+}
+
+uint64_t
+CompactTOC::sizeInBytes()
+{
+        return (uint64_t)nblocks * sizeof(struct __ctoc_block) +
+                (datalen + 1) * sizeof(uint32_t);
+}
+
+void
+CompactTOC::get(uint32_t j, uint32_t &num, uint32_t &first, uint64_t &pos)
+{
+        uint32_t        wn;
+        uint32_t        wf;
+        uint32_t        wo;
+        uint32_t        off;
+        uint64_t        bp;
+        struct __ctoc_block     *blk;
+
+        __assert(j < numHeaders);
+
+        blk = blks + j / CTOC_BLOCKSZ;
+
+        wn = blk->widths & 0xff;
+        wf = (blk->widths >> 8) & 0xff;
+        wo = blk->widths >> 16;
+
+        bp = (uint64_t)blk->off * 32 +
+                (uint64_t)(j % CTOC_BLOCKSZ) * (wn + wf + wo);
+
+        num = blk->minNum + __ctoc_get(data, bp, wn);
+        first = blk->minFirst + __ctoc_get(data, bp + wn, wf);
+        off = __ctoc_get(data, bp + wn + wf, wo);
+
+        pos = blkPos(j);
+
+        if (off != 0)
+                pos = __toc_short(pos, off - 1);
+}
+
+uint64_t
+CompactTOC::blkPos(uint32_t j)
+{
+        uint32_t        w;
+        uint32_t        beg;
+        uint32_t        cnt;
+        uint32_t        nent;
+        struct __ctoc_block     *blk;
+
+        __assert(j <= numHeaders);
+
+        blk = blks + j / CTOC_BLOCKSZ;
+        beg = j - j % CTOC_BLOCKSZ;
+
+        w = (blk->widths & 0xff) + ((blk->widths >> 8) & 0xff) +
+                (blk->widths >> 16);
+
+        nent = numHeaders - beg;
+        nent = (nent < CTOC_BLOCKSZ)? nent : CTOC_BLOCKSZ;
+        cnt = (nent < CTOC_BLOCKSZ)? nent + 1 : CTOC_BLOCKSZ;
+
+        return blk->base + EliasFano::accessEF(data + blk->off +
+                        __ctoc_nwords(nent, w), cnt, j % CTOC_BLOCKSZ);
+}
+
+/* --- Intra functions below --- */
+
+uint32_t
+__ctoc_width(uint32_t v)
+{
+        return (v != 0)? int_utils::get_msb(v) + 1 : 0;
+}
+
+void
+__ctoc_put(uint32_t *data, uint64_t bp, uint32_t v, uint32_t w)
+{
+        uint32_t        off;
+
+        if (w == 0)
+                return;
+
+        off = bp & 31;
+        data[bp >> 5] |= v << off;
+
+        if (off + w > 32)
+                data[(bp >> 5) + 1] |= v >> (32 - off);
+}
+
+uint32_t
+__ctoc_get(uint32_t *data, uint64_t bp, uint32_t w)
+{
+        uint64_t        v;
+
+        if (w == 0)
+                return 0;
+
+        v = data[bp >> 5] | ((uint64_t)data[(bp >> 5) + 1] << 32);
+
+        return (v >> (bp & 31)) & ((1ULL << w) - 1);
+}
+
+/* # of words taken by n fields of w bits */
+uint32_t
+__ctoc_nwords(uint32_t n, uint32_t w)
+{
+        return ((uint64_t)n * w + 31) / 32;
+}
+
+/*
+ * Positions of the b-th block in vals[] relative to base, and # of
+ * them is returned. A last block has cmplen after its entries.
+ */
+uint32_t
+__ctoc_blkpos(uint32_t *toc, uint32_t numHeaders,
+                uint64_t cmplen, uint32_t b, uint32_t *vals, uint64_t &base)
+{
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        cnt;
+        uint64_t        p;
+        uint64_t        prev;
+
+        cnt = numHeaders + 1 - b * CTOC_BLOCKSZ;
+        cnt = (cnt < CTOC_BLOCKSZ)? cnt : CTOC_BLOCKSZ;
+
+        for (k = 0; k < cnt; k++) {
+                j = b * CTOC_BLOCKSZ + k;
+
+                p = (j < numHeaders)? __toc_blkpos(__toc_pos(toc, j)) : cmplen;
+                prev = (j > 0)? __toc_blkpos(__toc_pos(toc, j - 1)) : 0;
+
+                if (p < prev)
+                        eoutput("Not increasing positions in TOC: %llu",
+                                        (unsigned long long)p);
+
+                if (k == 0)
+                        base = p;
+
+                if (p - base >= UINT32_MAX)
+                        eoutput("Too large lists to be compacted in TOC");
+
+                vals[k] = p - base;
+        }
+
+        return cnt;
+}
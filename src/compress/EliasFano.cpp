@@ -0,0 +1,328 @@
+/*-----------------------------------------------------------------------------
+ *  EliasFano.cpp - A coder based on Elias-Fano representation.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/EliasFano.hpp"
+
+/* The number of lower bits for len values less than univ */
+#define __ef_lbits(univ, len)   \
+        (((univ) > (len))? int_utils::get_msb((uint64_t)((univ) / (len))) : 0)
+
+/*
+ * Positions of each area in a block. The number of buckets in upper
+ * bits is derived from the max value stored in the head.
+ */
+struct __ef_layout {
+        uint32_t        l;
+        uint64_t        nb;
+        uint32_t        *s1;
+        uint32_t        *s0;
+        uint32_t        *low;
+        uint32_t        *high;
+        uint64_t        size;
+};
+
+static void __ef_get_layout(uint32_t *in, uint32_t len, struct __ef_layout &ly);
+static uint32_t __ef_get_low(uint32_t *low, uint64_t k, uint32_t l);
+static uint64_t __ef_select1(uint32_t *high, uint64_t p, uint64_t r);
+static uint64_t __ef_select0(uint32_t *high, uint64_t p, uint64_t r);
+
+void
+EliasFano::encodeEF(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &size)
+{
+        uint32_t        i;
+        uint32_t        off;
+        uint64_t        h;
+        uint64_t        k;
+        uint64_t        lo;
+        uint64_t        pos;
+        struct __ef_layout      ly;
+
+        if (len == 0) {
+                size = 0;
+                return;
+        }
+
+        /* Write the max value, and derive the layout from it */
+        out[0] = in[len - 1];
+        __ef_get_layout(out, len, ly);
+
+        memset(out + 1, 0, (ly.size - 1) * sizeof(uint32_t));
+
+        for (i = 0; i < len; i++) {
+                /* Lower bits are written from LSB */
+                if (ly.l != 0) {
+                        lo = in[i] & ((1ULL << ly.l) - 1);
+                        pos = (uint64_t)i * ly.l;
+                        off = pos & 31;
+
+                        ly.low[pos >> 5] |= lo << off;
+
+                        if (off + ly.l > 32)
+                                ly.low[(pos >> 5) + 1] |= lo >> (32 - off);
+                }
+
+                /* Upper bits are unary-coded in a bitmap */
+                pos = ((uint64_t)in[i] >> ly.l) + i;
+                ly.high[pos >> 5] |= 1U << (pos & 31);
+
+                if (i != 0 && i % EF_QUANTUM == 0)
+                        ly.s1[i / EF_QUANTUM - 1] = pos;
+        }
+
+        /* Sample the heads of every EF_QUANTUM-th bucket */
+        for (h = EF_QUANTUM, k = 0; h < ly.nb; h += EF_QUANTUM) {
+                while (k < len && ((uint64_t)in[k] >> ly.l) < h)
+                        k++;
+
+                ly.s0[h / EF_QUANTUM - 1] = h + k;
+        }
+
+        size = ly.size;
+}
+
+void
+EliasFano::decodeEF(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t base, uint32_t &prev)
+{
+        uint32_t        w;
+        uint32_t        k;
+        uint32_t        word;
+        uint64_t        v;
+        struct __ef_layout      ly;
+
+        if (len == 0)
+                return;
+
+        __ef_get_layout(in, len, ly);
+
+        /*
+         * prev holds the previous value plus one, so that
+         * the first d-gap of a list is written as it is.
+         */
+        for (w = 0, k = 0; k < len; w++) {
+                for (word = ly.high[w]; word != 0; word &= word - 1) {
+                        v = ((((uint64_t)w << 5) + __builtin_ctz(word) - k) << ly.l) |
+                                __ef_get_low(ly.low, k, ly.l);
+
+                        out[k] = base + v - prev;
+                        prev = base + v + 1;
+
+                        if (++k == len)
+                                break;
+                }
+        }
+}
+
+uint32_t
+EliasFano::accessEF(uint32_t *in, uint32_t len, uint32_t idx)
+{
+        uint64_t        p;
+        uint64_t        pos;
+        struct __ef_layout      ly;
+
+        __assert(idx < len);
+
+        __ef_get_layout(in, len, ly);
+
+        p = (idx < EF_QUANTUM)? 0 : ly.s1[idx / EF_QUANTUM - 1];
+        pos = __ef_select1(ly.high, p, idx % EF_QUANTUM);
+
+        return ((pos - idx) << ly.l) | __ef_get_low(ly.low, idx, ly.l);
+}
+
+uint32_t
+EliasFano::nextGEQEF(uint32_t *in, uint32_t len,
+                uint32_t val, uint32_t &idx)
+{
+        uint64_t        h;
+        uint64_t        p;
+        uint64_t        k;
+        uint64_t        pos;
+        uint64_t        v;
+        struct __ef_layout      ly;
+
+        if (len == 0 || val > in[0]) {
+                idx = len;
+                return 0;
+        }
+
+        __ef_get_layout(in, len, ly);
+
+        /* Find the head of the bucket that val falls into */
+        h = (uint64_t)val >> ly.l;
+        p = (h < EF_QUANTUM)? 0 : ly.s0[h / EF_QUANTUM - 1];
+
+        if (h % EF_QUANTUM != 0)
+                p = __ef_select0(ly.high, p, h % EF_QUANTUM - 1) + 1;
+
+        /* Then, scan values from the head */
+        for (k = p - h; ; k++, p = pos + 1) {
+                pos = __ef_select1(ly.high, p, 0);
+                v = ((pos - k) << ly.l) | __ef_get_low(ly.low, k, ly.l);
+
+                if (v >= val)
+                        break;
+        }
+
+        idx = k;
+
+        return v;
+}
+
+uint64_t
+EliasFano::costEF(uint64_t len, uint64_t univ)
+{
+        uint32_t        l;
+        uint64_t        nb;
+
+        l = __ef_lbits(univ, len);
+        nb = ((univ - 1) >> l) + 1;
+
+        return 32 * (1 + (len - 1) / EF_QUANTUM + (nb - 1) / EF_QUANTUM +
+                        (len * l + 31) / 32 + (len + nb + 31) / 32);
+}
+
+void
+EliasFano::encodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        i;
+        uint32_t        *vals;
+        uint64_t        v;
+
+        vals = new uint32_t[len];
+
+        if (vals == NULL)
+                eoutput("Can't allocate memory");
+
+        /* Transform d-gaps into a strictly increasing sequence */
+        for (i = 0, v = 0; i < len; i++) {
+                v += in[i];
+
+                if (v >= UINT32_MAX)
+                        eoutput("Overflowed values exist in EliasFano");
+
+                vals[i] = v++;
+        }
+
+        encodeEF(vals, len, out, nvalue);
+
+        delete[] vals;
+}
+
+void
+EliasFano::decodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue)
+{
+        uint32_t        prev;
+
+        prev = 0;
+        decodeEF(in, nvalue, out, 0, prev);
+}
+
+uint32_t
+EliasFano::access(uint32_t *in, uint32_t nvalue, uint32_t idx)
+{
+        return accessEF(in, nvalue, idx);
+}
+
+uint32_t
+EliasFano::nextGEQ(uint32_t *in, uint32_t nvalue,
+                uint32_t val, uint32_t &idx)
+{
+        return nextGEQEF(in, nvalue, val, idx);
+}
+
+/* --- Intra functions below --- */
+
+void
+__ef_get_layout(uint32_t *in, uint32_t len, struct __ef_layout &ly)
+{
+        ly.l = __ef_lbits((uint64_t)in[0] + 1, len);
+        ly.nb = ((uint64_t)in[0] >> ly.l) + 1;
+
+        ly.s1 = in + 1;
+        ly.s0 = ly.s1 + (len - 1) / EF_QUANTUM;
+        ly.low = ly.s0 + (ly.nb - 1) / EF_QUANTUM;
+        ly.high = ly.low + ((uint64_t)len * ly.l + 31) / 32;
+
+        ly.size = (ly.high - in) + (len + ly.nb + 31) / 32;
+}
+
+uint32_t
+__ef_get_low(uint32_t *low, uint64_t k, uint32_t l)
+{
+        uint32_t        off;
+        uint64_t        pos;
+        uint64_t        v;
+
+        if (l == 0)
+                return 0;
+
+        pos = k * l;
+        off = pos & 31;
+
+        /* Do not touch a next word if not needed */
+        v = low[pos >> 5] >> off;
+
+        if (off + l > 32)
+                v |= (uint64_t)low[(pos >> 5) + 1] << (32 - off);
+
+        return v & ((1ULL << l) - 1);
+}
+
+/* Return the position of the r-th 1 (0-origin) at or after p */
+uint64_t
+__ef_select1(uint32_t *high, uint64_t p, uint64_t r)
+{
+        uint32_t        c;
+        uint32_t        word;
+        uint64_t        w;
+
+        w = p >> 5;
+        word = high[w] & (~0U << (p & 31));
+
+        while ((c = __builtin_popcount(word)) <= r) {
+                r -= c;
+                word = high[++w];
+        }
+
+        for (; r > 0; r--)
+                word &= word - 1;
+
+        return (w << 5) + __builtin_ctz(word);
+}
+
+/* Return the position of the r-th 0 (0-origin) at or after p */
+uint64_t
+__ef_select0(uint32_t *high, uint64_t p, uint64_t r)
+{
+        uint32_t        c;
+        uint32_t        word;
+        uint64_t        w;
+
+        w = p >> 5;
+        word = ~high[w] & (~0U << (p & 31));
+
+        while ((c = __builtin_popcount(word)) <= r) {
+                r -= c;
+                word = ~high[++w];
+        }
+
+        for (; r > 0; r--)
+                word &= word - 1;
+
+        return (w << 5) + __builtin_ctz(word);
+}
@@ -0,0 +1,266 @@
+/*-----------------------------------------------------------------------------
+ *  ListMerger.cpp - Merge two compressed lists without encoding them again.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/ListMerger.hpp"
+
+/* # of words in B first encoded again with a boundary, and it doubles */
+#define MERGE_NWORDS    8
+
+uint64_t
+ListMerger::mergeArray(MergeCoder &mc,
+                uint32_t *inA, uint32_t lenA, uint32_t numA,
+                uint32_t val,
+                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                uint32_t *out, uint32_t &nvalue)
+{
+        __assert(mc.type == MERGE_REENCODE ||
+                        (mc.type == MERGE_PARTS && mc.merge != NULL) ||
+                        (mc.blk != NULL && mc.skip != NULL));
+
+        switch (mc.type) {
+        case MERGE_WORDS:
+                return mergeWords(mc, inA, lenA, numA, val,
+                                inB, lenB, numB, out, nvalue);
+        case MERGE_BLOCKS:
+                return mergeBlocks(mc, inA, lenA, numA, val,
+                                inB, lenB, numB, out, nvalue);
+        case MERGE_PARTS:
+                return (mc.merge)(inA, lenA, numA, val,
+                                inB, lenB, numB, out, nvalue);
+        default:
+                return reencode(mc, inA, lenA, numA, val,
+                                inB, lenB, numB, out, nvalue);
+        }
+}
+
+/*
+ * A greedy coder picks a word only from integers ahead, and a word
+ * that is not a last one has no padding, so a word is the same in a
+ * merged list if it is not a last word of a list. Integers of a last
+ * word of A, val, and those of first words in B are encoded again
+ * until a word except a last one ends where a word of B ends, and
+ * words of B from there are copied. Doubling words of B, it ends
+ * with encoding all of B at worst.
+ */
+uint64_t
+ListMerger::mergeWords(MergeCoder &mc,
+                uint32_t *inA, uint32_t lenA, uint32_t numA,
+                uint32_t val,
+                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        c;
+        uint32_t        e;
+        uint32_t        p;
+        uint32_t        q;
+        uint32_t        nb;
+        uint32_t        lim;
+        uint32_t        wA;
+        uint32_t        wE;
+        uint32_t        nenc;
+        uint32_t        total;
+        uint32_t        *data;
+        uint32_t        *edata;
+        uint32_t        *tmp;
+        uint32_t        *enc;
+        uint32_t        *bnd;
+        uint32_t        *bpos;
+        uint32_t        buf[PFORDELTA_BLOCKSZ + TAIL_MERGIN];
+        bool            found;
+
+        /* Find a last word of A by descriptors, and decode only it */
+        for (k = 0, c = 0, p = 0, wA = 0, data = inA; k < numA; k += c) {
+                wA = data - inA;
+                c = (mc.skip)(inA, 1, numA - k, p, data);
+        }
+
+        p = 0;
+
+        if (numA > 0)
+                (mc.blk)(inA + wA, 1, c, p, data, buf);
+
+        tmp = new uint32_t[c + numB + 1 + TAIL_MERGIN];
+        enc = new uint32_t[__cmp_bound(c + numB + 1)];
+        bnd = new uint32_t[lenB + 1];
+        bpos = new uint32_t[lenB + 1];
+
+        if (tmp == NULL || enc == NULL || bnd == NULL || bpos == NULL)
+                eoutput("Can't allocate memory");
+
+        memcpy(tmp, buf, c * sizeof(uint32_t));
+        tmp[c] = val;
+
+        for (nb = 0, k = 0, p = 0, data = inB, lim = MERGE_NWORDS; ; lim *= 2) {
+                /* bnd[] has # of integers in tmp up to the end of each word */
+                for (; nb < lim && k < numB; nb++) {
+                        k += (mc.blk)(inB, 1, numB - k,
+                                        p, data, tmp + c + 1 + k);
+
+                        bnd[nb] = c + 1 + k;
+                        bpos[nb] = data - inB;
+                }
+
+                total = c + 1 + k;
+                (mc.enc)(tmp, total, enc, nenc);
+
+                if (k == numB) {
+                        wE = nenc;
+                        j = lenB;
+                        break;
+                }
+
+                /* A last word is not compared, which might have padding */
+                for (i = 0, e = 0, q = 0, edata = enc, found = false; ; ) {
+                        e += (mc.blk)(enc, 1, total - e, q, edata, buf);
+
+                        if (e >= total)
+                                break;
+
+                        while (bnd[i] < e)
+                                i++;
+
+                        if (bnd[i] == e) {
+                                found = true;
+                                break;
+                        }
+                }
+
+                if (found) {
+                        wE = edata - enc;
+                        j = bpos[i];
+                        total = e;
+                        break;
+                }
+        }
+
+        memcpy(out, inA, wA * sizeof(uint32_t));
+        memcpy(out + wA, enc, wE * sizeof(uint32_t));
+        memcpy(out + wA + wE, inB + j, (lenB - j) * sizeof(uint32_t));
+
+        nvalue = wA + wE + lenB - j;
+
+        delete[] tmp;
+        delete[] enc;
+        delete[] bnd;
+        delete[] bpos;
+
+        return total;
+}
+
+/*
+ * Blocks of A but a last partial one are copied, and the partial one is
+ * encoded again with val into a short block, whose codewords are padded
+ * to a full block. Blocks of B are copied as they are after it, so a
+ * list keeps short blocks in the middle, which decoders pass over by
+ * # of integers in their headers.
+ */
+uint64_t
+ListMerger::mergeBlocks(MergeCoder &mc,
+                uint32_t *inA, uint32_t lenA, uint32_t numA,
+                uint32_t val,
+                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        p;
+        uint32_t        wA;
+        uint32_t        nblk;
+        uint32_t        ntail;
+        uint32_t        nenc;
+        uint32_t        total;
+        uint32_t        *data;
+        uint32_t        tmp[PFORDELTA_BLOCKSZ + TAIL_MERGIN];
+
+        /* A first word is # of blocks, and a last one may be partial */
+        nblk = (numA > 0)? inA[0] : 0;
+
+        for (i = 0, k = 0, p = 0, data = inA + 1; i + 1 < nblk; i++)
+                k += (mc.skip)(inA, 1, numA - k, p, data);
+
+        /* A full last block is copied as well */
+        if (numA - k == PFORDELTA_BLOCKSZ) {
+                k += (mc.skip)(inA, 1, numA - k, p, data);
+                i++;
+        }
+
+        wA = data - inA;
+        ntail = numA - k;
+
+        if (ntail > 0)
+                (mc.blk)(inA, 1, ntail, p, data, tmp);
+
+        tmp[ntail] = val;
+        total = ntail + 1;
+
+        /* A tail is a last block if B has no integers */
+        if (numB > 0) {
+                memset(tmp + total, 0,
+                        (PFORDELTA_BLOCKSZ - total) * sizeof(uint32_t));
+                (mc.enc)(tmp, PFORDELTA_BLOCKSZ, out + wA - 1, nenc);
+
+                if (total < PFORDELTA_BLOCKSZ)
+                        PForDelta::shortenBlock(out + wA, total);
+        } else {
+                (mc.enc)(tmp, total, out + wA - 1, nenc);
+        }
+
+        /* # of blocks encoded again is replaced with blocks of A */
+        memcpy(out + 1, inA + 1, (wA - 1) * sizeof(uint32_t));
+
+        out[0] = i + 1;
+        nvalue = wA - 1 + nenc;
+
+        if (numB > 0) {
+                out[0] += inB[0];
+                memcpy(out + nvalue, inB + 1, (lenB - 1) * sizeof(uint32_t));
+                nvalue += lenB - 1;
+        }
+
+        return total;
+}
+
+uint64_t
+ListMerger::reencode(MergeCoder &mc,
+                uint32_t *inA, uint32_t lenA, uint32_t numA,
+                uint32_t val,
+                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint64_t        total;
+        uint32_t        *tmp;
+
+        total = (uint64_t)numA + 1 + numB;
+        tmp = new uint32_t[total + TAIL_MERGIN];
+
+        if (tmp == NULL)
+                eoutput("Can't allocate memory");
+
+        if (numA > 0)
+                (mc.dec)(inA, lenA, tmp, numA);
+
+        tmp[numA] = val;
+
+        if (numB > 0)
+                (mc.dec)(inB, lenB, tmp + numA + 1, numB);
+
+        (mc.enc)(tmp, total, out, nvalue);
+
+        delete[] tmp;
+
+        return total;
+}
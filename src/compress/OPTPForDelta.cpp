@@ -164,3 +164,9 @@ OPTPForDelta::decodeArray(uint32_t *in, uint32_t len,
         PForDelta::decodeArray(in, len, out, nvalue); 
 }
 
+uint32_t
+OPTPForDelta::decodeBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data, uint32_t *out)
+{
+        return PForDelta::decodeBlock(in, n, rest, p, data, out);
+}
@@ -23,18 +23,31 @@
  * Lemme resume the block's format here.
  *
  *      |--------------------------------------------------|
- *      |       b | nExceptions | s16encodedExceptionSize  |
- *      |  6 bits |   10 bits   |         16 bits          |
+ *      |       b | nExceptions | nMissing | s16ExceptionSize |
+ *      |  6 bits |   10 bits   |  7 bits  |      9 bits      |
  *      |--------------------------------------------------|
  *      |              fixed_b(codewords)                  |
  *      |--------------------------------------------------|
  *      |                s16(exceptions)                   |
  *      |--------------------------------------------------|
  *
+ * nMissing is # of integers a block lacks in PFORDELTA_BLOCKSZ. It is
+ * 0 except for a short block followed by others, which ListMerger
+ * leaves in the middle of a list. A last block is not marked, and
+ * it has the rest of a list.
  */
 #define PFORDELTA_B             6
 #define PFORDELTA_NEXCEPT       10
-#define PFORDELTA_EXCEPTSZ      16
+#define PFORDELTA_NMISSING      7
+#define PFORDELTA_EXCEPTSZ      9
+
+/* # of integers in a block headed by h */
+#define __p4delta_nints(h)      \
+        (PFORDELTA_BLOCKSZ - (((h) >> PFORDELTA_EXCEPTSZ) &     \
+                ((1 << PFORDELTA_NMISSING) - 1)))
+
+/* Simple16 can't encode exceptions larger than this */
+#define PFORDELTA_MAXEXCEPT     (1U << 28)
 
 #define __p4delta_copy(src, dest)       \
         __asm__ __volatile__(           \
@@ -66,49 +79,78 @@
                 ::"memory", "%xmm0")
 
 /* A set of unpacking functions */
-static void __p4delta_unpack0(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack1(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack2(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack3(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack4(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack5(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack6(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack7(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack8(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack9(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack10(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack11(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack12(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack13(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack16(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack20(uint32_t *out, uint32_t *in);
-static void __p4delta_unpack32(uint32_t *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack0(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack1(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack2(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack3(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack4(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack5(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack6(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack7(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack8(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack9(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack10(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack11(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack12(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack13(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack16(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack20(T *out, uint32_t *in);
+template <class T>
+static void __p4delta_unpack32(T *out, uint32_t *in);
+
+/* 32-bit integers are zero-filled or copied with SSE2 */
+template <>
+void __p4delta_unpack0<uint32_t>(uint32_t *out, uint32_t *in);
+template <>
+void __p4delta_unpack32<uint32_t>(uint32_t *out, uint32_t *in);
 
 /* A interface of unpacking functions above */
-typedef void (*__p4delta_unpacker)(uint32_t *out, uint32_t *in);
-
-static __p4delta_unpacker       __p4delta_unpack[] = {
-        __p4delta_unpack0,
-        __p4delta_unpack1,
-        __p4delta_unpack2,
-        __p4delta_unpack3,
-        __p4delta_unpack4,
-        __p4delta_unpack5,
-        __p4delta_unpack6,
-        __p4delta_unpack7,
-        __p4delta_unpack8,
-        __p4delta_unpack9,
-        __p4delta_unpack10,
-        __p4delta_unpack11,
-        __p4delta_unpack12,
-        __p4delta_unpack13,
+template <class T>
+struct __p4delta_unpacker {
+        typedef void (*unpacker)(T *out, uint32_t *in);
+
+        static unpacker         unpack[33];
+};
+
+template <class T>
+typename __p4delta_unpacker<T>::unpacker __p4delta_unpacker<T>::unpack[33] = {
+        __p4delta_unpack0<T>,
+        __p4delta_unpack1<T>,
+        __p4delta_unpack2<T>,
+        __p4delta_unpack3<T>,
+        __p4delta_unpack4<T>,
+        __p4delta_unpack5<T>,
+        __p4delta_unpack6<T>,
+        __p4delta_unpack7<T>,
+        __p4delta_unpack8<T>,
+        __p4delta_unpack9<T>,
+        __p4delta_unpack10<T>,
+        __p4delta_unpack11<T>,
+        __p4delta_unpack12<T>,
+        __p4delta_unpack13<T>,
         NULL,
         NULL,
-        __p4delta_unpack16,
+        __p4delta_unpack16<T>,
         NULL,
         NULL,
         NULL,
-        __p4delta_unpack20,
+        __p4delta_unpack20<T>,
         NULL,
         NULL,
         NULL,
@@ -120,38 +162,70 @@ static __p4delta_unpacker       __p4delta_unpack[] = {
         NULL,
         NULL,
         NULL,
-        __p4delta_unpack32
+        __p4delta_unpack32<T>
 };
 
+/*
+ * Unpacking functions for odd widths with BMI2, and they take over
+ * the ones above for 32-bit integers if available.
+ */
+template <uint32_t B>
+static void __p4delta_unpack_bmi2(uint32_t *out, uint32_t *in) __bmi2_target;
+
+static bool __p4delta_setup_bmi2(void);
+static bool __p4delta_bmi2 __attribute__((unused)) = __p4delta_setup_bmi2();
+
+/*
+ * Unpacking functions with AVX-512 for all the widths below 32, and
+ * they take over the ones above for 32-bit integers if available.
+ */
+template <uint32_t B>
+static void __p4delta_unpack_avx512(uint32_t *out, uint32_t *in) __avx512_target;
+
+static bool __p4delta_setup_avx512(void);
+static bool __p4delta_avx512 __attribute__((unused)) = __p4delta_setup_avx512();
+
 /* A hard-corded Simple16 decoder wirtten in the original code */
 static inline void __p4delta_simple16_decode(uint32_t *in, uint32_t len,
                 uint32_t *out, uint32_t nvalue) __attribute__((always_inline));
 
+/* Decode a block of PFORDELTA_BLOCKSZ integers, and return a next block */
+template <class T>
+static inline uint32_t *__p4delta_decode_block(uint32_t *in, T *out)
+        __attribute__((always_inline));
+
 static uint32_t __p4delta_possLogs[] = {
         1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 16, 20, 32
 };
 
+template <class T>
 uint32_t
-PForDelta::tryB(uint32_t b, uint32_t *in, uint32_t len) 
+PForDelta::tryB(uint32_t b, T *in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        curExcept;
 
         __assert(b <= 32);
 
-        if (b == 32)
+        if (b >= 8 * sizeof(T))
                 return 0;
 
         for (i = 0, curExcept = 0; i < len; i++) {
-                if (in[i] >= (1ULL << b))
+                if (in[i] >= ((T)1 << b)) {
+                        /* Exceptions must be encoded with Simple16 */
+                        if (__unlikely((in[i] >> b) > PFORDELTA_MAXEXCEPT))
+                                return len + 1;
+
                         curExcept++;
+                }
         }
 
         return curExcept;
 }
 
+template <class T>
 uint32_t
-PForDelta::findBestB(uint32_t *in, uint32_t len)
+PForDelta::findBestB(T *in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        nExceptions;
@@ -166,10 +240,11 @@ PForDelta::findBestB(uint32_t *in, uint32_t len)
         return __p4delta_possLogs[__array_size(__p4delta_possLogs) - 1];
 }
 
+template <class T>
 void
-PForDelta::encodeBlock(uint32_t *in, uint32_t len,
+PForDelta::encodeBlock(T *in, uint32_t len,
                 uint32_t *out, uint32_t &nvalue,
-                uint32_t (*find)(uint32_t *in, uint32_t len))
+                uint32_t (*find)(T *in, uint32_t len))
 {
         uint32_t        i;
         uint32_t        b;
@@ -208,11 +283,15 @@ PForDelta::encodeBlock(uint32_t *in, uint32_t len,
                 curExcept = 0;
                 encodedExceptions_sz = 0;
 
-                if (b < 32) {
+                if (b < 8 * sizeof(T)) {
                         for (i = 0; i < len; i++) {
                                 wt->bit_writer(in[i], b);
 
-                                if (in[i] >= (1U << b)) {
+                                if (in[i] >= ((T)1 << b)) {
+                                        if ((in[i] >> b) > PFORDELTA_MAXEXCEPT)
+                                                eoutput("Input's out of range: %llu",
+                                                                (unsigned long long)in[i]);
+
                                         e = in[i] >> b;
                                         exceptionsPositions[curExcept] = i;
                                         exceptionsValues[curExcept] = e;
@@ -253,8 +332,11 @@ PForDelta::encodeBlock(uint32_t *in, uint32_t len,
                 wt->bit_flush();
 
                 /* Write a header following the format */
-                *out++ = (b << (PFORDELTA_NEXCEPT + PFORDELTA_EXCEPTSZ)) |
-                                (curExcept << PFORDELTA_EXCEPTSZ) | encodedExceptions_sz; 
+                __assert(encodedExceptions_sz < (1U << PFORDELTA_EXCEPTSZ));
+
+                *out++ = (b << (32 - PFORDELTA_B)) |
+                                (curExcept << (PFORDELTA_NMISSING + PFORDELTA_EXCEPTSZ)) |
+                                encodedExceptions_sz;
                 nvalue = 1;
 
                 /* Write exceptional values */
@@ -277,8 +359,9 @@ PForDelta::encodeBlock(uint32_t *in, uint32_t len,
         }
 }
 
+template <class T>
 void
-PForDelta::encodeArray(uint32_t *in, uint32_t len,
+PForDelta::encode(T *in, uint32_t len,
                 uint32_t *out, uint32_t &nvalue)
 {
         uint32_t        i;
@@ -294,7 +377,7 @@ PForDelta::encodeArray(uint32_t *in, uint32_t len,
         for (i = 0; i < numBlocks; i++) {
                 if (__likely(i != numBlocks - 1)) {
                         PForDelta::encodeBlock(in, PFORDELTA_BLOCKSZ,
-                                        out, csize, PForDelta::findBestB); 
+                                        out, csize, PForDelta::findBestB<T>); 
 
                         in += PFORDELTA_BLOCKSZ; 
                         out += csize;
@@ -308,62 +391,228 @@ PForDelta::encodeArray(uint32_t *in, uint32_t len,
                         nblk = ((len % PFORDELTA_BLOCKSZ) != 0)?
                                 len % PFORDELTA_BLOCKSZ : PFORDELTA_BLOCKSZ;
                         PForDelta::encodeBlock(in, nblk,
-                                out, csize, PForDelta::findBestB);
+                                out, csize, PForDelta::findBestB<T>);
                 }
 
                 nvalue += csize;
         }
 }
 
+template <class T>
+void
+PForDelta::decode(uint32_t *in, uint32_t len,
+                T *out, uint32_t nvalue)
+{
+        uint32_t        i;
+        uint32_t        n;
+        uint32_t        numBlocks;
+
+        numBlocks = *in++;
+
+        for (i = 0; i < numBlocks; i++) {
+                n = __p4delta_nints(*in);
+                in = __p4delta_decode_block(in, out);
+                out += n;
+        }
+}
+
+uint32_t
+PForDelta::tryB(uint32_t b, uint32_t *in, uint32_t len)
+{
+        return PForDelta::tryB<uint32_t>(b, in, len);
+}
+
+uint32_t
+PForDelta::findBestB(uint32_t *in, uint32_t len)
+{
+        return PForDelta::findBestB<uint32_t>(in, len);
+}
+
+void
+PForDelta::encodeBlock(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue,
+                uint32_t (*find)(uint32_t *in, uint32_t len))
+{
+        PForDelta::encodeBlock<uint32_t>(in, len, out, nvalue, find);
+}
+
+void
+PForDelta::encodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        PForDelta::encode(in, len, out, nvalue);
+}
+
 void
 PForDelta::decodeArray(uint32_t *in, uint32_t len,
                 uint32_t *out, uint32_t nvalue)
+{
+        PForDelta::decode(in, len, out, nvalue);
+}
+
+void
+PForDelta::encodeArray(uint64_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        PForDelta::encode(in, len, out, nvalue);
+}
+
+void
+PForDelta::decodeArray(uint32_t *in, uint32_t len,
+                uint64_t *out, uint32_t nvalue)
+{
+        PForDelta::decode(in, len, out, nvalue);
+}
+
+uint32_t
+PForDelta::decodeBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data, uint32_t *out)
+{
+        uint32_t        k;
+        uint32_t        c;
+
+        /* A first word is # of blocks */
+        if (p == 0)
+                data = in + 1;
+
+        for (k = 0; k < n && k < rest; p++) {
+                c = __p4delta_nints(*data);
+                data = __p4delta_decode_block(data, out + k);
+                k += c;
+        }
+
+        return (k < rest)? k : rest;
+}
+
+uint32_t
+PForDelta::skipBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data)
+{
+        uint32_t        k;
+
+        /* A first word is # of blocks */
+        if (p == 0)
+                data = in + 1;
+
+        /* A header, exceptions, and b words of codewords */
+        for (k = 0; k < n && k < rest; p++) {
+                k += __p4delta_nints(*data);
+                data += 1 + (*data & ((1 << PFORDELTA_EXCEPTSZ) - 1)) +
+                        (*data >> (32 - PFORDELTA_B)) * PFORDELTA_NBLOCK;
+        }
+
+        return (k < rest)? k : rest;
+}
+
+void
+PForDelta::shortenBlock(uint32_t *head, uint32_t n)
+{
+        __assert(n > 0 && n <= PFORDELTA_BLOCKSZ);
+        __assert(__p4delta_nints(*head) == PFORDELTA_BLOCKSZ);
+
+        *head |= (PFORDELTA_BLOCKSZ - n) << PFORDELTA_EXCEPTSZ;
+}
+
+/* --- Intra functions below --- */
+
+template <class T>
+uint32_t *
+__p4delta_decode_block(uint32_t *in, T *out)
 {
         int32_t         lpos;
-        uint32_t        i;
         uint32_t        e;
-        uint32_t        numBlocks;
         uint32_t        b;
-        uint32_t        excVal;
+        T               excVal;
         uint32_t        nExceptions;
         uint32_t        encodedExceptionsSize;
         uint32_t        except[2 * PFORDELTA_BLOCKSZ + TAIL_MERGIN + 1];
 
-        numBlocks = *in++;
+        b = *in >> (32 - PFORDELTA_B);
 
-        for (i = 0; i < numBlocks; i++) {
-                b = *in >> (32 - PFORDELTA_B);
+        nExceptions = (*in >>
+                        (32 - (PFORDELTA_B + PFORDELTA_NEXCEPT))) &
+                        ((1 << PFORDELTA_NEXCEPT) - 1);
 
-                nExceptions = (*in >>
-                                (32 - (PFORDELTA_B + PFORDELTA_NEXCEPT))) &
-                                ((1 << PFORDELTA_NEXCEPT) - 1);
+        encodedExceptionsSize = *in & ((1 << PFORDELTA_EXCEPTSZ) - 1); 
 
-                encodedExceptionsSize = *in & ((1 << PFORDELTA_EXCEPTSZ) - 1); 
+        if (PFORDELTA_USE_HARDCODE_SIMPLE16)
+                __p4delta_simple16_decode(++in, 2 * nExceptions, except, 2 * nExceptions);
+        else
+                Simple16::decodeArray(++in, 2 * nExceptions, except, 2 * nExceptions);
 
-                if (PFORDELTA_USE_HARDCODE_SIMPLE16)
-                        __p4delta_simple16_decode(++in, 2 * nExceptions, except, 2 * nExceptions);
-                else
-                        Simple16::decodeArray(++in, 2 * nExceptions, except, 2 * nExceptions);
+        in += encodedExceptionsSize;
 
-                in += encodedExceptionsSize;
+        __p4delta_unpacker<T>::unpack[b](out, in);
 
-                __p4delta_unpack[b](out, in);
+        for (e = 0, lpos = -1; e < nExceptions; e++) {
+                lpos += except[e] + 1;
+                excVal = except[e + nExceptions] + 1;
+                excVal <<= b;
+                out[lpos] |= excVal;
 
-                for (e = 0, lpos = -1; e < nExceptions; e++) {
-                        lpos += except[e] + 1;
-                        excVal = except[e + nExceptions] + 1;
-                        excVal <<= b;
-                        out[lpos] |= excVal;
+                __assert(lpos < PFORDELTA_BLOCKSZ); 
+        }
 
-                        __assert(lpos < PFORDELTA_BLOCKSZ); 
-                }
+        return in + b * PFORDELTA_NBLOCK; 
+}
 
-                out += PFORDELTA_BLOCKSZ; 
-                in += b * PFORDELTA_NBLOCK; 
-        }
+bool
+__p4delta_setup_bmi2(void)
+{
+        if (!BMI2Unpack::available())
+                return false;
+
+        __p4delta_unpacker<uint32_t>::unpack[3] = __p4delta_unpack_bmi2<3>;
+        __p4delta_unpacker<uint32_t>::unpack[5] = __p4delta_unpack_bmi2<5>;
+        __p4delta_unpacker<uint32_t>::unpack[7] = __p4delta_unpack_bmi2<7>;
+        __p4delta_unpacker<uint32_t>::unpack[9] = __p4delta_unpack_bmi2<9>;
+        __p4delta_unpacker<uint32_t>::unpack[11] = __p4delta_unpack_bmi2<11>;
+        __p4delta_unpacker<uint32_t>::unpack[13] = __p4delta_unpack_bmi2<13>;
+
+        return true;
 }
 
-/* --- Intra functions below --- */
+template <uint32_t B>
+void
+__p4delta_unpack_bmi2(uint32_t *out, uint32_t *in)
+{
+        uint32_t        i;
+
+        for (i = 0; i < PFORDELTA_BLOCKSZ; i += 32, out += 32, in += B)
+                BMI2Unpack::unpack32<B>(out, in, 0);
+}
+
+bool
+__p4delta_setup_avx512(void)
+{
+        if (!AVX512Unpack::available())
+                return false;
+
+        __p4delta_unpacker<uint32_t>::unpack[1] = __p4delta_unpack_avx512<1>;
+        __p4delta_unpacker<uint32_t>::unpack[2] = __p4delta_unpack_avx512<2>;
+        __p4delta_unpacker<uint32_t>::unpack[3] = __p4delta_unpack_avx512<3>;
+        __p4delta_unpacker<uint32_t>::unpack[4] = __p4delta_unpack_avx512<4>;
+        __p4delta_unpacker<uint32_t>::unpack[5] = __p4delta_unpack_avx512<5>;
+        __p4delta_unpacker<uint32_t>::unpack[6] = __p4delta_unpack_avx512<6>;
+        __p4delta_unpacker<uint32_t>::unpack[7] = __p4delta_unpack_avx512<7>;
+        __p4delta_unpacker<uint32_t>::unpack[8] = __p4delta_unpack_avx512<8>;
+        __p4delta_unpacker<uint32_t>::unpack[9] = __p4delta_unpack_avx512<9>;
+        __p4delta_unpacker<uint32_t>::unpack[10] = __p4delta_unpack_avx512<10>;
+        __p4delta_unpacker<uint32_t>::unpack[11] = __p4delta_unpack_avx512<11>;
+        __p4delta_unpacker<uint32_t>::unpack[12] = __p4delta_unpack_avx512<12>;
+        __p4delta_unpacker<uint32_t>::unpack[13] = __p4delta_unpack_avx512<13>;
+        __p4delta_unpacker<uint32_t>::unpack[16] = __p4delta_unpack_avx512<16>;
+        __p4delta_unpacker<uint32_t>::unpack[20] = __p4delta_unpack_avx512<20>;
+
+        return true;
+}
+
+template <uint32_t B>
+void
+__p4delta_unpack_avx512(uint32_t *out, uint32_t *in)
+{
+        AVX512Unpack::unpack<B>(out, in, PFORDELTA_BLOCKSZ);
+}
 
 void
 __p4delta_simple16_decode(uint32_t *in, uint32_t len,
@@ -651,8 +900,16 @@ __p4delta_simple16_decode(uint32_t *in, uint32_t len,
         }
 }
 
+template <class T>
 void
-__p4delta_unpack0(uint32_t *out, uint32_t *in)
+__p4delta_unpack0(T *out, uint32_t *in)
+{
+        memset(out, 0x00, PFORDELTA_BLOCKSZ * sizeof(T));
+}
+
+template <>
+void
+__p4delta_unpack0<uint32_t>(uint32_t *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -662,8 +919,9 @@ __p4delta_unpack0(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack1(uint32_t *out, uint32_t *in)
+__p4delta_unpack1(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -704,8 +962,9 @@ __p4delta_unpack1(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack2(uint32_t *out, uint32_t *in)
+__p4delta_unpack2(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -746,8 +1005,9 @@ __p4delta_unpack2(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack3(uint32_t *out, uint32_t *in)
+__p4delta_unpack3(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -790,8 +1050,9 @@ __p4delta_unpack3(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack4(uint32_t *out, uint32_t *in)
+__p4delta_unpack4(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -832,8 +1093,9 @@ __p4delta_unpack4(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack5(uint32_t *out, uint32_t *in)
+__p4delta_unpack5(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -878,8 +1140,9 @@ __p4delta_unpack5(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack6(uint32_t *out, uint32_t *in)
+__p4delta_unpack6(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -924,8 +1187,9 @@ __p4delta_unpack6(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack7(uint32_t *out, uint32_t *in)
+__p4delta_unpack7(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -972,8 +1236,9 @@ __p4delta_unpack7(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack8(uint32_t *out, uint32_t *in)
+__p4delta_unpack8(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -1014,8 +1279,9 @@ __p4delta_unpack8(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack9(uint32_t *out, uint32_t *in)
+__p4delta_unpack9(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -1064,8 +1330,9 @@ __p4delta_unpack9(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack10(uint32_t *out, uint32_t *in)
+__p4delta_unpack10(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -1114,8 +1381,9 @@ __p4delta_unpack10(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack11(uint32_t *out, uint32_t *in)
+__p4delta_unpack11(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -1166,8 +1434,9 @@ __p4delta_unpack11(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack12(uint32_t *out, uint32_t *in)
+__p4delta_unpack12(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -1216,8 +1485,9 @@ __p4delta_unpack12(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack13(uint32_t *out, uint32_t *in)
+__p4delta_unpack13(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -1270,8 +1540,9 @@ __p4delta_unpack13(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack16(uint32_t *out, uint32_t *in)
+__p4delta_unpack16(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -1312,8 +1583,9 @@ __p4delta_unpack16(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
 void
-__p4delta_unpack20(uint32_t *out, uint32_t *in)
+__p4delta_unpack20(T *out, uint32_t *in)
 {
         uint32_t        i;
 
@@ -1370,8 +1642,19 @@ __p4delta_unpack20(uint32_t *out, uint32_t *in)
         }
 }
 
+template <class T>
+void
+__p4delta_unpack32(T *out, uint32_t *in)
+{
+        uint32_t        i;
+
+        for (i = 0; i < PFORDELTA_BLOCKSZ; i++)
+                out[i] = in[i];
+}
+
+template <>
 void
-__p4delta_unpack32(uint32_t *out, uint32_t *in)
+__p4delta_unpack32<uint32_t>(uint32_t *out, uint32_t *in)
 {
         uint32_t        i;
 
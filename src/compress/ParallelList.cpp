@@ -0,0 +1,332 @@
+/*-----------------------------------------------------------------------------
+ *  ParallelList.cpp - Encode and decode sub-blocks of a long list in parallel.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/ParallelList.hpp"
+
+/* A sub-block is encoded at a fixed slot first, and packed later */
+#define PLIST_SLOTLEN   __cmp_bound(PLIST_SUBLEN)
+
+/* Arguments shared by tasks of a job */
+struct __plist_job {
+        pt2Enc          enc;
+        pt2Dec          dec;
+        uint32_t        *in;
+        uint32_t        len;
+        uint32_t        *out;
+        uint32_t        *dir;
+        uint32_t        *data;
+        uint64_t        datalen;
+        uint32_t        nsub;
+        uint32_t        *sizes;
+        uint32_t        *sums;
+        uint32_t        odd;
+        bool            docs;
+        uint32_t        first;
+};
+
+static void __plist_encode(void *job, uint32_t i);
+static void __plist_decode(void *job, uint32_t t);
+
+ParallelList::ParallelList(uint32_t nthreads)
+{
+        uint32_t        i;
+
+        this->nthreads = (nthreads > 0)? nthreads : 1;
+
+        gen = 0;
+        nbusy = 0;
+        quit = false;
+
+        task = NULL;
+        job = NULL;
+        ntasks = 0;
+        next = 0;
+
+        pthread_mutex_init(&mtx, NULL);
+        pthread_cond_init(&start, NULL);
+        pthread_cond_init(&done, NULL);
+
+        ths = new pthread_t[this->nthreads];
+
+        if (ths == NULL)
+                eoutput("Can't allocate memory");
+
+        /* A caller is a last thread */
+        for (i = 0; i < this->nthreads - 1; i++) {
+                if (pthread_create(&ths[i], NULL, worker, this) != 0)
+                        eoutput("pthread_create(): Can't start a worker");
+        }
+}
+
+ParallelList::~ParallelList()
+{
+        uint32_t        i;
+
+        pthread_mutex_lock(&mtx);
+        quit = true;
+        pthread_cond_broadcast(&start);
+        pthread_mutex_unlock(&mtx);
+
+        for (i = 0; i < nthreads - 1; i++)
+                pthread_join(ths[i], NULL);
+
+        pthread_mutex_destroy(&mtx);
+        pthread_cond_destroy(&start);
+        pthread_cond_destroy(&done);
+
+        delete[] ths;
+}
+
+uint64_t
+ParallelList::bound(uint32_t len)
+{
+        return 1 + 2 * (uint64_t)numSubBlocks(len) +
+                (uint64_t)numSubBlocks(len) * PLIST_SLOTLEN;
+}
+
+void
+ParallelList::encodeArray(pt2Enc enc, uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        i;
+        uint32_t        base;
+        uint64_t        off;
+        struct __plist_job      jb;
+
+        jb.enc = enc;
+        jb.in = in;
+        jb.len = len;
+        jb.nsub = numSubBlocks(len);
+        jb.dir = out + 1;
+        jb.data = out + 1 + 2 * jb.nsub;
+        jb.sizes = new uint32_t[jb.nsub];
+        jb.sums = new uint32_t[jb.nsub];
+
+        if (jb.sizes == NULL || jb.sums == NULL)
+                eoutput("Can't allocate memory");
+
+        run(__plist_encode, &jb, jb.nsub);
+
+        /* Sub-blocks are packed in order, which only move ahead */
+        for (i = 0, off = 0, base = 0; i < jb.nsub; i++) {
+                jb.dir[2 * i] = off;
+                jb.dir[2 * i + 1] = base;
+
+                memmove(jb.data + off, jb.data + i * PLIST_SLOTLEN,
+                                jb.sizes[i] * sizeof(uint32_t));
+
+                off += jb.sizes[i];
+                base += jb.sums[i];
+        }
+
+        if (1 + 2 * (uint64_t)jb.nsub + off > UINT32_MAX)
+                eoutput("Too large list to be encoded in sub-blocks");
+
+        out[0] = jb.nsub;
+        nvalue = 1 + 2 * jb.nsub + off;
+
+        delete[] jb.sizes;
+        delete[] jb.sums;
+}
+
+void
+ParallelList::decodeArray(pt2Dec dec, uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue)
+{
+        decode(dec, in, len, out, nvalue, false, 0);
+}
+
+void
+ParallelList::decodeDocs(pt2Dec dec, uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue, uint32_t first)
+{
+        decode(dec, in, len, out, nvalue, true, first);
+}
+
+/*
+ * Decoders may write up to TAIL_MERGIN integers after a sub-block,
+ * which is a head of a next one. Even sub-blocks are decoded first,
+ * and their garbage is overwritten by odd ones. An odd sub-block then
+ * saves and restores a head of a next one, which no thread touches.
+ */
+void
+ParallelList::decode(pt2Dec dec, uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue, bool docs, uint32_t first)
+{
+        struct __plist_job      jb;
+
+        jb.dec = dec;
+        jb.len = nvalue;
+        jb.out = out;
+        jb.nsub = in[0];
+        jb.dir = in + 1;
+        jb.data = in + 1 + 2 * jb.nsub;
+        jb.datalen = len - (1 + 2 * (uint64_t)jb.nsub);
+        jb.docs = docs;
+        jb.first = first;
+
+        if (jb.nsub != numSubBlocks(nvalue))
+                eoutput("Not a list encoded in sub-blocks: %u", jb.nsub);
+
+        jb.odd = 0;
+        run(__plist_decode, &jb, (jb.nsub + 1) / 2);
+
+        jb.odd = 1;
+        run(__plist_decode, &jb, jb.nsub / 2);
+}
+
+void *
+ParallelList::worker(void *arg)
+{
+        uint64_t        mygen;
+        ParallelList    *pl;
+
+        pl = (ParallelList *)arg;
+        mygen = 0;
+
+        pthread_mutex_lock(&pl->mtx);
+
+        for (;;) {
+                while (pl->gen == mygen && !pl->quit)
+                        pthread_cond_wait(&pl->start, &pl->mtx);
+
+                if (pl->quit)
+                        break;
+
+                mygen = pl->gen;
+                pthread_mutex_unlock(&pl->mtx);
+
+                pl->runTasks();
+
+                pthread_mutex_lock(&pl->mtx);
+
+                if (--pl->nbusy == 0)
+                        pthread_cond_signal(&pl->done);
+        }
+
+        pthread_mutex_unlock(&pl->mtx);
+
+        return NULL;
+}
+
+void
+ParallelList::run(void (*task)(void *job, uint32_t i),
+                void *job, uint32_t ntasks)
+{
+        if (ntasks == 0)
+                return;
+
+        /* No thread is woken up for a single task */
+        if (ntasks == 1 || nthreads == 1) {
+                for (uint32_t i = 0; i < ntasks; i++)
+                        task(job, i);
+                return;
+        }
+
+        pthread_mutex_lock(&mtx);
+
+        this->task = task;
+        this->job = job;
+        this->ntasks = ntasks;
+        this->next = 0;
+
+        nbusy = nthreads - 1;
+        gen++;
+
+        pthread_cond_broadcast(&start);
+        pthread_mutex_unlock(&mtx);
+
+        runTasks();
+
+        pthread_mutex_lock(&mtx);
+
+        while (nbusy > 0)
+                pthread_cond_wait(&done, &mtx);
+
+        pthread_mutex_unlock(&mtx);
+}
+
+void
+ParallelList::runTasks()
+{
+        uint32_t        i;
+
+        while ((i = __sync_fetch_and_add(&next, 1)) < ntasks)
+                task(job, i);
+}
+
+/* --- Intra functions below --- */
+
+void
+__plist_encode(void *job, uint32_t i)
+{
+        uint32_t        k;
+        uint32_t        n;
+        uint32_t        sum;
+        uint32_t        *in;
+        struct __plist_job      *jb;
+
+        jb = (struct __plist_job *)job;
+
+        n = jb->len - i * PLIST_SUBLEN;
+        n = (n < PLIST_SUBLEN)? n : PLIST_SUBLEN;
+        in = jb->in + (uint64_t)i * PLIST_SUBLEN;
+
+        (jb->enc)(in, n, jb->data + i * PLIST_SLOTLEN, jb->sizes[i]);
+
+        for (k = 0, sum = 0; k < n; k++)
+                sum += in[k] + 1;
+
+        jb->sums[i] = sum;
+}
+
+void
+__plist_decode(void *job, uint32_t t)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        n;
+        uint32_t        prev;
+        uint32_t        *out;
+        uint64_t        end;
+        bool            saved;
+        uint32_t        head[TAIL_MERGIN];
+        struct __plist_job      *jb;
+
+        jb = (struct __plist_job *)job;
+
+        i = 2 * t + jb->odd;
+        n = jb->len - i * PLIST_SUBLEN;
+        n = (n < PLIST_SUBLEN)? n : PLIST_SUBLEN;
+        out = jb->out + (uint64_t)i * PLIST_SUBLEN;
+
+        end = (i + 1 < jb->nsub)? jb->dir[2 * (i + 1)] : jb->datalen;
+        saved = (jb->odd && i + 1 < jb->nsub);
+
+        if (saved)
+                memcpy(head, out + PLIST_SUBLEN, sizeof(head));
+
+        (jb->dec)(jb->data + jb->dir[2 * i],
+                        end - jb->dir[2 * i], out, n);
+
+        if (jb->docs) {
+                for (k = 0, prev = jb->first + jb->dir[2 * i + 1]; k < n; k++) {
+                        prev += out[k] + 1;
+                        out[k] = prev;
+                }
+        }
+
+        if (saved)
+                memcpy(out + PLIST_SUBLEN, head, sizeof(head));
+}
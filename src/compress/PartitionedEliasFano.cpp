@@ -0,0 +1,258 @@
+/*-----------------------------------------------------------------------------
+ *  PartitionedEliasFano.cpp - Elias-Fano with optimal partitioning.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/PartitionedEliasFano.hpp"
+
+/* An end, an upper bound, and an offset for each partition */
+#define PEF_FIXCOST     (3 * 32)
+
+static uint64_t __pef_cost(uint32_t *seq, uint32_t head, uint32_t tail);
+
+static uint32_t __pef_possLens[] = {
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+        17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32
+};
+
+#ifdef USE_BOOST_SHAREDPTR
+ static VSEncodingPtr __pef =
+                VSEncodingPtr(new VSEncoding(&__pef_possLens[0],
+                PEF_MAXUNITS, __pef_cost));
+#else
+ static VSEncoding *__pef =
+                new VSEncoding(&__pef_possLens[0],
+                PEF_MAXUNITS, __pef_cost);
+#endif /* USE_BOOST_SHAREDPTR */
+
+void
+PartitionedEliasFano::encodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        i;
+        uint32_t        s;
+        uint32_t        e;
+        uint32_t        sz;
+        uint32_t        base;
+        uint32_t        units;
+        uint32_t        numBlocks;
+        uint32_t        *vals;
+        uint32_t        *seq;
+        uint32_t        *part;
+        uint32_t        *ends;
+        uint32_t        *ubs;
+        uint32_t        *offs;
+        uint32_t        *data;
+        uint64_t        v;
+
+        if (len == 0) {
+                nvalue = 0;
+                return;
+        }
+
+        units = int_utils::div_roundup(len, PEF_UNIT);
+
+        vals = new uint32_t[len];
+        seq = new uint32_t[2 * (units + 1)];
+
+        if (vals == NULL || seq == NULL)
+                eoutput("Can't allocate memory");
+
+        /* Transform d-gaps into a strictly increasing sequence */
+        for (i = 0, v = 0; i < len; i++) {
+                v += in[i];
+
+                if (v >= UINT32_MAX)
+                        eoutput("Overflowed values exist in PartitionedEliasFano");
+
+                vals[i] = v++;
+        }
+
+        /*
+         * For the DP, seq[] holds the position and the lower bound of
+         * values at the head of each unit.
+         */
+        for (i = 0; i <= units; i++) {
+                e = (i * PEF_UNIT < len)? i * PEF_UNIT : len;
+
+                seq[2 * i] = e;
+                seq[2 * i + 1] = (e == 0)? 0 : vals[e - 1] + 1;
+        }
+
+        part = __pef->compute_OptPartition(seq, units, PEF_FIXCOST, numBlocks);
+
+        out[0] = numBlocks;
+
+        ends = out + 1;
+        ubs = ends + numBlocks;
+        offs = ubs + numBlocks;
+        data = offs + numBlocks;
+
+        /* Values in each partition are relative to a previous one */
+        for (i = 0, sz = 0; i < numBlocks; i++) {
+                s = seq[2 * part[i]];
+                e = seq[2 * part[i + 1]];
+                base = seq[2 * part[i] + 1];
+
+                ends[i] = e;
+                ubs[i] = vals[e - 1];
+                offs[i] = sz;
+
+                for (uint32_t j = s; j < e; j++)
+                        vals[j] -= base;
+
+                EliasFano::encodeEF(vals + s, e - s, data + sz, nvalue);
+                sz += nvalue;
+        }
+
+        nvalue = (data - out) + sz;
+
+        /* Finalization */
+        delete[] part;
+        delete[] seq;
+        delete[] vals;
+}
+
+void
+PartitionedEliasFano::decodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue)
+{
+        uint32_t        i;
+        uint32_t        s;
+        uint32_t        prev;
+        uint32_t        numBlocks;
+        uint32_t        *ends;
+        uint32_t        *ubs;
+        uint32_t        *offs;
+        uint32_t        *data;
+
+        if (nvalue == 0)
+                return;
+
+        numBlocks = in[0];
+
+        ends = in + 1;
+        ubs = ends + numBlocks;
+        offs = ubs + numBlocks;
+        data = offs + numBlocks;
+
+        for (i = 0, s = 0, prev = 0; i < numBlocks; s = ends[i++])
+                EliasFano::decodeEF(data + offs[i], ends[i] - s,
+                                out + s, prev, prev);
+}
+
+uint32_t
+PartitionedEliasFano::access(uint32_t *in, uint32_t nvalue, uint32_t idx)
+{
+        uint32_t        lo;
+        uint32_t        hi;
+        uint32_t        mid;
+        uint32_t        s;
+        uint32_t        base;
+        uint32_t        numBlocks;
+        uint32_t        *ends;
+        uint32_t        *ubs;
+        uint32_t        *offs;
+        uint32_t        *data;
+
+        __assert(idx < nvalue);
+
+        numBlocks = in[0];
+
+        ends = in + 1;
+        ubs = ends + numBlocks;
+        offs = ubs + numBlocks;
+        data = offs + numBlocks;
+
+        /* Find the first partition whose end is larger than idx */
+        for (lo = 0, hi = numBlocks - 1; lo < hi; ) {
+                mid = (lo + hi) >> 1;
+
+                if (ends[mid] > idx)
+                        hi = mid;
+                else
+                        lo = mid + 1;
+        }
+
+        s = (lo == 0)? 0 : ends[lo - 1];
+        base = (lo == 0)? 0 : ubs[lo - 1] + 1;
+
+        return base + EliasFano::accessEF(data + offs[lo], ends[lo] - s, idx - s);
+}
+
+uint32_t
+PartitionedEliasFano::nextGEQ(uint32_t *in, uint32_t nvalue,
+                uint32_t val, uint32_t &idx)
+{
+        uint32_t        lo;
+        uint32_t        hi;
+        uint32_t        mid;
+        uint32_t        s;
+        uint32_t        base;
+        uint32_t        ret;
+        uint32_t        numBlocks;
+        uint32_t        *ends;
+        uint32_t        *ubs;
+        uint32_t        *offs;
+        uint32_t        *data;
+
+        if (nvalue == 0) {
+                idx = 0;
+                return 0;
+        }
+
+        numBlocks = in[0];
+
+        ends = in + 1;
+        ubs = ends + numBlocks;
+        offs = ubs + numBlocks;
+        data = offs + numBlocks;
+
+        if (val > ubs[numBlocks - 1]) {
+                idx = nvalue;
+                return 0;
+        }
+
+        /* Find the first partition whose upper bound is not less than val */
+        for (lo = 0, hi = numBlocks - 1; lo < hi; ) {
+                mid = (lo + hi) >> 1;
+
+                if (ubs[mid] >= val)
+                        hi = mid;
+                else
+                        lo = mid + 1;
+        }
+
+        s = (lo == 0)? 0 : ends[lo - 1];
+        base = (lo == 0)? 0 : ubs[lo - 1] + 1;
+
+        ret = EliasFano::nextGEQEF(data + offs[lo], ends[lo] - s,
+                        (val > base)? val - base : 0, idx);
+        idx += s;
+
+        return base + ret;
+}
+
+void
+PartitionedEliasFano::setFastPartition(bool fast)
+{
+        __pef->setFastMode(fast);
+}
+
+/* --- Intra functions below --- */
+
+uint64_t
+__pef_cost(uint32_t *seq, uint32_t head, uint32_t tail)
+{
+        return EliasFano::costEF(seq[2 * tail] - seq[2 * head],
+                        (uint64_t)seq[2 * tail + 1] - seq[2 * head + 1]);
+}
@@ -0,0 +1,105 @@
+/*-----------------------------------------------------------------------------
+ *  PostingCursor.cpp - A cursor to decode a list a block at a time.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/PostingCursor.hpp"
+
+PostingCursor::PostingCursor(pt2Block dec, uint32_t *in,
+                uint32_t num, uint32_t first)
+{
+        __assert(dec != NULL && num > 0);
+
+        this->dec = dec;
+        this->in = NULL;
+        next_chunk = in;
+        data = NULL;
+        p = 0;
+        chunked = (num - 1 > CHUNKLEN);
+
+        rest = 0;
+        nrest = num - 1;
+
+        last = cur = first;
+        pos = 0;
+        nbuf = 0;
+}
+
+uint32_t
+PostingCursor::next()
+{
+        if (__unlikely(pos == nbuf) && !fill())
+                return cur = PCURSOR_END;
+
+        return cur = buf[pos++];
+}
+
+uint32_t
+PostingCursor::nextGEQ(uint32_t d)
+{
+        if (cur >= d)
+                return cur;
+
+        while (1) {
+                if (pos == nbuf && !fill())
+                        return cur = PCURSOR_END;
+
+                /* Skip a whole block if a last docID is smaller */
+                if (buf[nbuf - 1] < d) {
+                        pos = nbuf;
+                        continue;
+                }
+
+                while (buf[pos] < d)
+                        pos++;
+
+                return cur = buf[pos++];
+        }
+}
+
+/* Decode a next block, and restore docIDs from d-gaps */
+bool
+PostingCursor::fill()
+{
+        uint32_t        i;
+
+        if (rest == 0) {
+                if (nrest == 0)
+                        return false;
+
+                /* Open a next chunk headed by its compressed size */
+                in = next_chunk;
+                rest = (nrest < CHUNKLEN)? nrest : CHUNKLEN;
+                nrest -= rest;
+
+                if (chunked) {
+                        next_chunk = in + 1 + *in;
+                        in++;
+                }
+
+                p = 0;
+                data = NULL;
+        }
+
+        nbuf = (dec)(in, PCURSOR_BLOCKSZ, rest, p, data, buf);
+        rest -= nbuf;
+        pos = 0;
+
+        __assert(nbuf > 0);
+
+        for (i = 0; i < nbuf; i++) {
+                last += buf[i] + 1;
+                buf[i] = last;
+        }
+
+        return true;
+}
@@ -0,0 +1,251 @@
+/*-----------------------------------------------------------------------------
+ *  RANS.cpp - A table-based rANS coder for small alphabets of bytes.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/RANS.hpp"
+
+/*
+ * An entry of a decoding table has a symbol in the top 8 bits, a bias
+ * of a slot in a symbol range, and a frequency minus one.
+ */
+#define __rans_entry(sym, bias, freq)   \
+        (((sym) << 24) | ((bias) << RANS_MAXSCALE) | ((freq) - 1))
+
+#define __rans_decode_step(x, sym, tbl, S, units)       \
+        do {                                            \
+                uint32_t        __e;                    \
+\
+                __e = tbl[(x) & ((1U << (S)) - 1)];     \
+                sym = __e >> 24;                        \
+                (x) = ((__e & ((1U << RANS_MAXSCALE) - 1)) + 1) * ((x) >> (S)) +   \
+                        ((__e >> RANS_MAXSCALE) & ((1U << RANS_MAXSCALE) - 1));    \
+\
+                if ((x) < RANS_L)                       \
+                        (x) = ((x) << 16) | *(units)++; \
+        } while (0)
+
+static void __rans_normalize(uint32_t *cnt, uint32_t n,
+                uint32_t S, uint32_t *freq);
+
+void
+RANS::encode(uint8_t *in, uint32_t n, uint32_t *out, uint32_t &size)
+{
+        int             i;
+        uint32_t        s;
+        uint32_t        S;
+        uint32_t        x[RANS_NSTATES];
+        uint32_t        cnt[256];
+        uint32_t        freq[256];
+        uint32_t        start[256];
+        uint32_t        nused;
+        uint16_t        *units;
+        uint16_t        *up;
+        BitsWriter      *wt;
+
+        memset(cnt, 0, sizeof(cnt));
+
+        for (i = 0; i < (int)n; i++)
+                cnt[in[i]]++;
+
+        for (s = 0, nused = 0; s < 256; s++)
+                if (cnt[s] > 0)
+                        nused++;
+
+        /* A table no larger than # of symbols is built in decoding */
+        S = (n > 1)? int_utils::get_msb(n - 1) + 1 : 1;
+
+        if (S > RANS_MAXSCALE)
+                S = RANS_MAXSCALE;
+
+        __rans_normalize(cnt, n, S, freq);
+
+        wt = new BitsWriter(out);
+
+        if (wt == NULL)
+                eoutput("Can't initialize a class");
+
+        wt->bit_writer(S, 4);
+        wt->bit_writer((nused > 0)? nused - 1 : 0, 8);
+
+        for (s = 0, start[0] = 0; s < 256; s++) {
+                if (s > 0)
+                        start[s] = start[s - 1] + freq[s - 1];
+
+                if (freq[s] > 0) {
+                        wt->bit_writer(s, 8);
+                        wt->bit_writer(freq[s] - 1, S);
+                }
+        }
+
+        wt->bit_flush();
+
+        size = wt->written;
+        out += size;
+
+        delete wt;
+
+        /* Each symbol emits at most a unit, and they are written backward */
+        units = new uint16_t[n + 2];
+
+        if (units == NULL)
+                eoutput("Can't allocate memory");
+
+        up = units + n + 2;
+
+        for (i = 0; i < RANS_NSTATES; i++)
+                x[i] = RANS_L;
+
+        for (i = n - 1; i >= 0; i--) {
+                uint32_t        *xp;
+
+                s = in[i];
+                xp = &x[i & (RANS_NSTATES - 1)];
+
+                if (*xp >= (uint64_t)((RANS_L >> S) << 16) * freq[s]) {
+                        *--up = *xp & 0xffff;
+                        *xp >>= 16;
+                }
+
+                *xp = ((*xp / freq[s]) << S) + (*xp % freq[s]) + start[s];
+        }
+
+        for (i = 0; i < RANS_NSTATES; i++)
+                out[i] = x[i];
+
+        n = units + n + 2 - up;
+        memcpy(out + RANS_NSTATES, up, n * sizeof(uint16_t));
+
+        if (n & 1)
+                ((uint16_t *)(out + RANS_NSTATES))[n] = 0;
+
+        size += RANS_NSTATES + (n + 1) / 2;
+
+        delete[] units;
+}
+
+void
+RANS::decode(uint32_t *in, uint8_t *out, uint32_t n)
+{
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        s;
+        uint32_t        S;
+        uint32_t        f;
+        uint32_t        nused;
+        uint32_t        slot;
+        uint32_t        x0;
+        uint32_t        x1;
+        uint32_t        x2;
+        uint32_t        x3;
+        uint32_t        tbl[1U << RANS_MAXSCALE];
+        uint16_t        *units;
+        BitsReader      *rd;
+
+        rd = new BitsReader(in);
+
+        if (rd == NULL)
+                eoutput("Can't initialize a class");
+
+        S = rd->bit_reader(4);
+        nused = rd->bit_reader(8) + 1;
+
+        /* Build a table per call to find a symbol by a slot directly */
+        for (i = 0, slot = 0; i < nused; i++) {
+                s = rd->bit_reader(8);
+                f = rd->bit_reader(S) + 1;
+
+                for (j = 0; j < f; j++)
+                        tbl[slot + j] = __rans_entry(s, j, f);
+
+                slot += f;
+        }
+
+        delete rd;
+
+        __assert(slot == (1U << S));
+
+        in += (12 + nused * (8 + S) + 31) / 32;
+
+        x0 = in[0];
+        x1 = in[1];
+        x2 = in[2];
+        x3 = in[3];
+        units = (uint16_t *)(in + RANS_NSTATES);
+
+        for (i = 0; i + RANS_NSTATES <= n; i += RANS_NSTATES) {
+                __rans_decode_step(x0, out[i], tbl, S, units);
+                __rans_decode_step(x1, out[i + 1], tbl, S, units);
+                __rans_decode_step(x2, out[i + 2], tbl, S, units);
+                __rans_decode_step(x3, out[i + 3], tbl, S, units);
+        }
+
+        if (i < n)
+                __rans_decode_step(x0, out[i++], tbl, S, units);
+        if (i < n)
+                __rans_decode_step(x1, out[i++], tbl, S, units);
+        if (i < n)
+                __rans_decode_step(x2, out[i++], tbl, S, units);
+}
+
+/* --- Intra functions below --- */
+
+void
+__rans_normalize(uint32_t *cnt, uint32_t n, uint32_t S, uint32_t *freq)
+{
+        uint32_t        s;
+        uint32_t        m;
+        uint32_t        sum;
+
+        /* Any present symbol needs a slot at least */
+        for (s = 0, m = 0, sum = 0; s < 256; s++) {
+                freq[s] = 0;
+
+                if (cnt[s] == 0)
+                        continue;
+
+                freq[s] = ((uint64_t)cnt[s] << S) / n;
+
+                if (freq[s] == 0)
+                        freq[s] = 1;
+
+                if (cnt[s] > cnt[m])
+                        m = s;
+
+                sum += freq[s];
+        }
+
+        if (n == 0) {
+                freq[0] = 1U << S;
+                return;
+        }
+
+        /* The rest goes to the most frequent one */
+        if (sum < (1U << S)) {
+                freq[m] += (1U << S) - sum;
+                return;
+        }
+
+        /* Or, slots are taken from larger ones */
+        while (sum > (1U << S)) {
+                for (s = 0; s < 256 && sum > (1U << S); s++) {
+                        if (freq[s] > 1 && freq[s] * 2 >= freq[m]) {
+                                freq[s]--;
+                                sum--;
+                        }
+                }
+
+                for (s = 0, m = 0; s < 256; s++)
+                        if (freq[s] > freq[m])
+                                m = s;
+        }
+}
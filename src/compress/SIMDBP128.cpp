@@ -0,0 +1,270 @@
+/*-----------------------------------------------------------------------------
+ *  SIMDBP128.cpp - A SIMD-BP128 coder with 4-wide deltas of docIDs.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/SIMDBP128.hpp"
+
+/* # of rows of 4 integers in a block */
+#define SIMDBP128_ROWS          (SIMDBP128_BLOCKSZ / SIMDBP128_LANES)
+
+#define __simdbp_width(v)       (((v) != 0)? int_utils::get_msb(v) + 1 : 0)
+
+/* Widths of blocks are 8-bit each, and packed from LSB */
+#define __simdbp_get_width(wd, k)       (((wd)[(k) >> 2] >> (8 * ((k) & 3))) & 0xff)
+#define __simdbp_set_width(wd, k, b)    ((wd)[(k) >> 2] |= (b) << (8 * ((k) & 3)))
+
+static void __simdbp_pack(uint32_t *in, uint32_t n,
+                uint32_t b, uint32_t stride, uint32_t *out);
+
+/*
+ * A set of unpacking functions, which restore docIDs from D4 deltas
+ * in rows with a SIMD add.
+ */
+template <uint32_t B>
+static __m128i __simdbp_unpack_rows(uint32_t *__no_aliases__ out,
+                uint32_t *in, __m128i prev);
+
+/* A interface of unpacking functions above */
+typedef __m128i (*__simdbp_unpacker)(uint32_t *__no_aliases__ out,
+                uint32_t *in, __m128i prev);
+
+static __simdbp_unpacker        __simdbp_unpack[] = {
+        __simdbp_unpack_rows<0>, __simdbp_unpack_rows<1>,
+        __simdbp_unpack_rows<2>, __simdbp_unpack_rows<3>,
+        __simdbp_unpack_rows<4>, __simdbp_unpack_rows<5>,
+        __simdbp_unpack_rows<6>, __simdbp_unpack_rows<7>,
+        __simdbp_unpack_rows<8>, __simdbp_unpack_rows<9>,
+        __simdbp_unpack_rows<10>, __simdbp_unpack_rows<11>,
+        __simdbp_unpack_rows<12>, __simdbp_unpack_rows<13>,
+        __simdbp_unpack_rows<14>, __simdbp_unpack_rows<15>,
+        __simdbp_unpack_rows<16>, __simdbp_unpack_rows<17>,
+        __simdbp_unpack_rows<18>, __simdbp_unpack_rows<19>,
+        __simdbp_unpack_rows<20>, __simdbp_unpack_rows<21>,
+        __simdbp_unpack_rows<22>, __simdbp_unpack_rows<23>,
+        __simdbp_unpack_rows<24>, __simdbp_unpack_rows<25>,
+        __simdbp_unpack_rows<26>, __simdbp_unpack_rows<27>,
+        __simdbp_unpack_rows<28>, __simdbp_unpack_rows<29>,
+        __simdbp_unpack_rows<30>, __simdbp_unpack_rows<31>,
+        __simdbp_unpack_rows<32>
+};
+
+void
+SIMDBP128::encodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        b;
+        uint32_t        m;
+        uint32_t        nb;
+        uint32_t        nw;
+        uint32_t        bits;
+        uint32_t        prev[SIMDBP128_LANES];
+        uint32_t        d[SIMDBP128_BLOCKSZ];
+        uint32_t        *wd;
+        uint32_t        *p;
+
+        nvalue = 0;
+
+        if (len == 0)
+                return;
+
+        nb = len / SIMDBP128_BLOCKSZ;
+        m = len % SIMDBP128_BLOCKSZ;
+
+        /*
+         * A compressed list is as follows, and a first docID is kept
+         * minus one so that its delta is always 0:
+         *      [first docID - 1][widths][blocks][rest]
+         */
+        out[0] = in[0] - 1;
+        wd = out + 1;
+        nw = (nb + 1 + 3) / 4;
+        p = wd + nw;
+
+        memset(wd, 0, nw * sizeof(uint32_t));
+
+        /* Virtual docIDs before a first row are consecutive */
+        for (i = 0; i < SIMDBP128_LANES; i++)
+                prev[i] = out[0] - (SIMDBP128_LANES - 1) + i;
+
+        for (k = 0; k < nb; k++, in += SIMDBP128_BLOCKSZ) {
+                for (i = 0, bits = 0; i < SIMDBP128_BLOCKSZ; i++) {
+                        d[i] = in[i] - prev[i & (SIMDBP128_LANES - 1)] - 4;
+                        prev[i & (SIMDBP128_LANES - 1)] = in[i];
+                        bits |= d[i];
+                }
+
+                b = __simdbp_width(bits);
+                __simdbp_set_width(wd, k, b);
+
+                for (i = 0; i < SIMDBP128_LANES; i++)
+                        __simdbp_pack(d + i, SIMDBP128_ROWS, b,
+                                        SIMDBP128_LANES, p + i);
+
+                p += SIMDBP128_LANES * b;
+        }
+
+        /*
+         * The rest of integers are not enough for rows, so d-gaps of
+         * them are packed as they are.
+         */
+        if (m > 0) {
+                for (i = 0, bits = 0; i < m; i++) {
+                        d[i] = in[i] - prev[SIMDBP128_LANES - 1] - 1;
+                        prev[SIMDBP128_LANES - 1] = in[i];
+                        bits |= d[i];
+                }
+
+                b = __simdbp_width(bits);
+                __simdbp_set_width(wd, nb, b);
+
+                __simdbp_pack(d, m, b, 1, p);
+                p += (m * b + 31) / 32;
+        }
+
+        nvalue = p - out;
+}
+
+void
+SIMDBP128::decodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        b;
+        uint32_t        m;
+        uint32_t        nb;
+        uint32_t        cur;
+        uint32_t        pos;
+        uint32_t        *wd;
+        __m128i         prev;
+
+        __validate(in, (len << 2));
+        __validate(out, ((nvalue + TAIL_MERGIN) << 2));
+
+        if (nvalue == 0)
+                return;
+
+        nb = nvalue / SIMDBP128_BLOCKSZ;
+        m = nvalue % SIMDBP128_BLOCKSZ;
+
+        cur = *in++;
+        wd = in;
+        in += (nb + 1 + 3) / 4;
+
+        prev = _mm_set_epi32(cur, cur - 1, cur - 2, cur - 3);
+
+        for (k = 0; k < nb; k++, out += SIMDBP128_BLOCKSZ) {
+                b = __simdbp_get_width(wd, k);
+                prev = (__simdbp_unpack[b])(out, in, prev);
+                in += SIMDBP128_LANES * b;
+        }
+
+        if (m == 0)
+                return;
+
+        if (nb > 0)
+                cur = _mm_cvtsi128_si32(_mm_shuffle_epi32(prev, 0xff));
+
+        b = __simdbp_get_width(wd, nb);
+
+        for (i = 0, pos = 0; i < m; i++, pos += b) {
+                uint64_t        v;
+
+                /* No word is there for 0-bit gaps */
+                v = (b != 0)? in[pos >> 5] : 0;
+
+                if ((pos & 31) + b > 32)
+                        v |= (uint64_t)in[(pos >> 5) + 1] << 32;
+
+                cur += (uint32_t)((v >> (pos & 31)) & ((1ULL << b) - 1)) + 1;
+                out[i] = cur;
+        }
+}
+
+/* --- Intra functions below --- */
+
+void
+__simdbp_pack(uint32_t *in, uint32_t n,
+                uint32_t b, uint32_t stride, uint32_t *out)
+{
+        uint32_t        i;
+        uint32_t        w;
+        uint32_t        sh;
+        uint32_t        pos;
+
+        /* Integers are packed from LSB in every stride-th word */
+        for (i = 0; i < (n * b + 31) / 32; i++)
+                out[i * stride] = 0;
+
+        for (i = 0, pos = 0; i < n; i++, pos += b) {
+                if (b == 0)
+                        break;
+
+                w = pos >> 5;
+                sh = pos & 31;
+
+                out[w * stride] |= in[i * stride] << sh;
+
+                if (sh + b > 32)
+                        out[(w + 1) * stride] |= in[i * stride] >> (32 - sh);
+        }
+}
+
+template <uint32_t B>
+__m128i
+__simdbp_unpack_rows(uint32_t *out, uint32_t *in, __m128i prev)
+{
+        uint32_t        i;
+        __m128i         w;
+        __m128i         v;
+        __m128i         mask;
+        __m128i         four;
+
+        four = _mm_set1_epi32(4);
+
+        if (B == 0) {
+                for (i = 0; i < SIMDBP128_ROWS; i++) {
+                        prev = _mm_add_epi32(prev, four);
+                        _mm_storeu_si128((__m128i *)out + i, prev);
+                }
+
+                return prev;
+        }
+
+        mask = _mm_set1_epi32((uint32_t)((1ULL << B) - 1));
+        w = _mm_loadu_si128((__m128i *)in);
+
+        /* Shifts are constants once unrolled */
+#pragma GCC unroll 32
+        for (i = 0; i < SIMDBP128_ROWS; i++) {
+                v = _mm_srli_epi32(w, (i * B) & 31);
+
+                if (((i * B) & 31) + B >= 32 && i < SIMDBP128_ROWS - 1) {
+                        w = _mm_loadu_si128((__m128i *)in + ((i * B) >> 5) + 1);
+
+                        if (((i * B) & 31) + B > 32)
+                                v = _mm_or_si128(v,
+                                        _mm_slli_epi32(w, 32 - ((i * B) & 31)));
+                }
+
+                if (B < 32)
+                        v = _mm_and_si128(v, mask);
+
+                prev = _mm_add_epi32(prev, _mm_add_epi32(v, four));
+                _mm_storeu_si128((__m128i *)out + i, prev);
+        }
+
+        return prev;
+}
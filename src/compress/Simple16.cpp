@@ -14,396 +14,317 @@
 
 #include "compress/Simple16.hpp"
 
+#include <emmintrin.h>
+
 #define SIMPLE16_LOGDESC        4
 #define SIMPLE16_LEN            (1 << SIMPLE16_LOGDESC)
 
-#define SIMPLE16_DESC_FUNC1(num1, log1) \
-        bool                            \
-        Simple16::try##num1##_##log1##bit(uint32_t *n, uint32_t len)    \
-        {                                       \
-                uint32_t        i;              \
-                uint32_t        min;            \
-\
-                min = (len < num1)? len : num1; \
-\
-                for (i = 0; i < min; i++) {     \
-                        if (int_utils::get_msb(n[i]) > log1 - 1)        \
-                                return false;   \
-                }               \
-\
-                return true;    \
-        }
+/* Bit widths used in descriptors, and integers are classified by them */
+#define SIMPLE16_NWIDTHS        11
 
-#define SIMPLE16_DESC_FUNC2(num1, log1, num2, log2)     \
-        bool                                    \
-        Simple16::try##num1##_##log1##bit_##num2##_##log2##bit(uint32_t *n, uint32_t len)       \
-        {                                       \
-                uint32_t        i;              \
-                uint32_t        base;           \
-                uint32_t        min;            \
-\
-                min = (len < num1)? len : num1; \
-\
-                for (i = 0; i < min; i++) {     \
-                        if (int_utils::get_msb(n[i]) > log1 - 1)        \
-                                return false;   \
-                }               \
-\
-                base = min;     \
-                len -= min;     \
-\
-                min = (len < num2)? len: num2;                          \
-\
-                for (i = base; i < base + min; i++) {                   \
-                        if (int_utils::get_msb(n[i]) > log2 - 1)        \
-                                return false;                           \
-                }               \
-\
-                return true;    \
-        }
+/* The number of integers classified at once in encoding */
+#define SIMPLE16_WINDOW         256
 
-#define SIMPLE16_DESC_FUNC3(num1, log1, num2, log2, num3, log3) \
-        bool                                    \
-        Simple16::try##num1##_##log1##bit_##num2##_##log2##bit_##num3##_##log3##bit(uint32_t *n, uint32_t len)    \
-        {                                       \
-                uint32_t        i;              \
-                uint32_t        base;           \
-                uint32_t        min;            \
-\
-                min = (len < num1)? len : num1; \
-\
-                for (i = 0; i < min; i++) {     \
-                        if (int_utils::get_msb(n[i]) > log1 - 1)        \
-                                return false;   \
-                }               \
-\
-                base = min;     \
-                len -= min;     \
-\
-                min = (len < num2)? len: num2;                          \
-\
-                for (i = base; i < base + min; i++) {                   \
-                        if (int_utils::get_msb(n[i]) > log2 - 1)        \
-                                return false;                           \
-                }               \
-\
-                base += min;    \
-                len -= min;     \
-\
-                min = (len < num3)? len: num3;                          \
-\
-                for (i = base; i < base + min; i++) {                   \
-                        if (int_utils::get_msb(n[i]) > log3 - 1)        \
-                                return false;                           \
-                }               \
-\
-                return true;    \
-        }
+static const uint32_t __simple16_widths[SIMPLE16_NWIDTHS] = {
+        1, 2, 3, 4, 5, 6, 7, 9, 10, 14, 28
+};
 
-/* Fuction difinition by macros in a trying order */
-SIMPLE16_DESC_FUNC1(28, 1);
-SIMPLE16_DESC_FUNC2(7, 2, 14, 1);
-SIMPLE16_DESC_FUNC3(7, 1, 7, 2, 7, 1);
-SIMPLE16_DESC_FUNC2(14, 1, 7, 2);
-SIMPLE16_DESC_FUNC1(14, 2);
-SIMPLE16_DESC_FUNC2(1, 4, 8, 3);
-SIMPLE16_DESC_FUNC3(1, 3, 4, 4, 3, 3);
-SIMPLE16_DESC_FUNC1(7, 4);
-SIMPLE16_DESC_FUNC2(4, 5, 2, 4);
-SIMPLE16_DESC_FUNC2(2, 4, 4, 5);
-SIMPLE16_DESC_FUNC2(3, 6, 2, 5);
-SIMPLE16_DESC_FUNC2(2, 5, 3, 6);
-SIMPLE16_DESC_FUNC1(4, 7);
-SIMPLE16_DESC_FUNC2(1, 10, 2, 9);
-SIMPLE16_DESC_FUNC1(2, 14);
+/* The number of the widths above that an integer with a given MSB is over */
+static const uint8_t __simple16_nover[64] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 7, 8, 9, 9, 9, 9, 10, 10,
+        10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 11, 11, 11, 11,
+        11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
+        11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11
+};
+
+/*
+ * Layouts of each descriptor in a trying order. A descriptor has up to
+ * three groups of integers, and each group has its number of integers,
+ * the class of its bit width, and its positions in a mask. A descriptor
+ * fits if no integer in mask[g] is over the width of class cls[g].
+ */
+struct __simple16_layout {
+        uint32_t        num;
+        uint32_t        n[3];
+        uint32_t        cls[3];
+        uint32_t        mask[3];
+};
+
+#define __simple16_mask(pos, n) ((uint32_t)(((1ULL << (n)) - 1) << (pos)))
+
+#define SIMPLE16_LAYOUT(n1, c1, n2, c2, n3, c3)                 \
+        {(n1) + (n2) + (n3), {n1, n2, n3}, {c1, c2, c3},        \
+                {__simple16_mask(0, n1), __simple16_mask(n1, n2),       \
+                __simple16_mask((n1) + (n2), n3)}}
+
+static const struct __simple16_layout __simple16_layouts[SIMPLE16_LEN] = {
+        SIMPLE16_LAYOUT(28, 0, 0, 0, 0, 0),     /* 28 1-bit */
+        SIMPLE16_LAYOUT(7, 1, 14, 0, 0, 0),     /* 7 2-bit, 14 1-bit */
+        SIMPLE16_LAYOUT(7, 0, 7, 1, 7, 0),      /* 7 1-bit, 7 2-bit, 7 1-bit */
+        SIMPLE16_LAYOUT(14, 0, 7, 1, 0, 0),     /* 14 1-bit, 7 2-bit */
+        SIMPLE16_LAYOUT(14, 1, 0, 0, 0, 0),     /* 14 2-bit */
+        SIMPLE16_LAYOUT(1, 3, 8, 2, 0, 0),      /* 1 4-bit, 8 3-bit */
+        SIMPLE16_LAYOUT(1, 2, 4, 3, 3, 2),      /* 1 3-bit, 4 4-bit, 3 3-bit */
+        SIMPLE16_LAYOUT(7, 3, 0, 0, 0, 0),      /* 7 4-bit */
+        SIMPLE16_LAYOUT(4, 4, 2, 3, 0, 0),      /* 4 5-bit, 2 4-bit */
+        SIMPLE16_LAYOUT(2, 3, 4, 4, 0, 0),      /* 2 4-bit, 4 5-bit */
+        SIMPLE16_LAYOUT(3, 5, 2, 4, 0, 0),      /* 3 6-bit, 2 5-bit */
+        SIMPLE16_LAYOUT(2, 4, 3, 5, 0, 0),      /* 2 5-bit, 3 6-bit */
+        SIMPLE16_LAYOUT(4, 6, 0, 0, 0, 0),      /* 4 7-bit */
+        SIMPLE16_LAYOUT(1, 8, 2, 7, 0, 0),      /* 1 10-bit, 2 9-bit */
+        SIMPLE16_LAYOUT(2, 9, 0, 0, 0, 0),      /* 2 14-bit */
+        SIMPLE16_LAYOUT(1, 10, 0, 0, 0, 0)      /* 1 28-bit */
+};
 
 /* A set of unpacking functions */
-static inline void __simple16_unpack1_28(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack1_28(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack2_7_1_14(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack2_7_1_14(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack1_7_2_7_1_7(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack1_7_2_7_1_7(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack1_14_2_7(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack1_14_2_7(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack2_14(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack2_14(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack4_1_3_8(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack4_1_3_8(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack3_1_4_4_3_3(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack3_1_4_4_3_3(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack4_7(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack4_7(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack5_4_4_2(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack5_4_4_2(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack4_2_5_4(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack4_2_5_4(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack6_3_5_2(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack6_3_5_2(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack5_2_6_3(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack5_2_6_3(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack7_4(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack7_4(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack10_1_9_2(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack10_1_9_2(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack14_2(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack14_2(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple16_unpack28_1(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple16_unpack28_1(T **out, uint32_t **in)
         __attribute__((always_inline));
 
 /* A interface of unpacking functions above */
-typedef void (*__simple16_unpacker)(uint32_t **out, uint32_t **in);
-
-static __simple16_unpacker       __simple16_unpack[SIMPLE16_LEN] = {
-        __simple16_unpack1_28, __simple16_unpack2_7_1_14,
-        __simple16_unpack1_7_2_7_1_7, __simple16_unpack1_14_2_7,
-        __simple16_unpack2_14, __simple16_unpack4_1_3_8,
-        __simple16_unpack3_1_4_4_3_3, __simple16_unpack4_7,
-        __simple16_unpack5_4_4_2, __simple16_unpack4_2_5_4,
-        __simple16_unpack6_3_5_2, __simple16_unpack5_2_6_3,
-        __simple16_unpack7_4, __simple16_unpack10_1_9_2,
-        __simple16_unpack14_2, __simple16_unpack28_1
+template <class T>
+struct __simple16_unpacker {
+        typedef void (*unpacker)(T **out, uint32_t **in);
+
+        static unpacker         unpack[SIMPLE16_LEN];
+};
+
+template <class T>
+typename __simple16_unpacker<T>::unpacker __simple16_unpacker<T>::unpack[SIMPLE16_LEN] = {
+        __simple16_unpack1_28<T>, __simple16_unpack2_7_1_14<T>,
+        __simple16_unpack1_7_2_7_1_7<T>, __simple16_unpack1_14_2_7<T>,
+        __simple16_unpack2_14<T>, __simple16_unpack4_1_3_8<T>,
+        __simple16_unpack3_1_4_4_3_3<T>, __simple16_unpack4_7<T>,
+        __simple16_unpack5_4_4_2<T>, __simple16_unpack4_2_5_4<T>,
+        __simple16_unpack6_3_5_2<T>, __simple16_unpack5_2_6_3<T>,
+        __simple16_unpack7_4<T>, __simple16_unpack10_1_9_2<T>,
+        __simple16_unpack14_2<T>, __simple16_unpack28_1<T>
 };
 
+template <class T>
 void
-Simple16::encodeArray(uint32_t *in, uint32_t len,
+Simple16::encode(T *in, uint32_t len,
                 uint32_t *out, uint32_t &nvalue)
 {
         uint32_t        i;
-        uint32_t        base;
-        uint32_t        min;
-        BitsWriter      *wt;
+        uint32_t        d;
+        uint32_t        g;
+        uint32_t        w;
+        uint32_t        end;
+        uint32_t        num;
+        uint32_t        pos;
+        uint32_t        nfill;
+        uint32_t        shift;
+        uint32_t        word;
+        uint32_t        fit;
+        uint32_t        over[SIMPLE16_NWIDTHS];
+        uint32_t        *pout;
+        uint64_t        v;
+        uint8_t         cls[SIMPLE16_WINDOW + 32];
+        __m128i         lo;
+        __m128i         hi;
+        __m128i         c;
+        const struct __simple16_layout  *ly;
 
-        wt = new BitsWriter(out);
+        pout = out;
+        pos = nfill = 0;
 
         while (len > 0) {
-                if (Simple16::try28_1bit(in, len)) {
-                        /* Descripter Number: 0 */
-                        wt->bit_writer(0, 4);
-
-                        min = (len < 28)? len : 28;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 1);
-                } else if (Simple16::try7_2bit_14_1bit(in, len)) {
-                        /* Descripter Number: 1 */
-                        wt->bit_writer(1, 4);
-
-                        min = (len < 7)? len : 7;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 2);
-
-                        base = min;
-                        min = ((len - base) < 14)? len - base : 14;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 1);
-
-                        min += base;
-                } else if (Simple16::try7_1bit_7_2bit_7_1bit(in, len)) {
-                        /* Descripter Number: 2 */
-                        wt->bit_writer(2, 4);
-
-                        min = (len < 7)? len : 7;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 1);
-
-                        base = min;
-                        min = (len - base < 7)? len - base : 7;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 2);
-
-                        base += min;
-                        min = (len - base < 7)? len - base : 7;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 1);
-
-                        min += base;
-                } else if (Simple16::try14_1bit_7_2bit(in, len)) {
-                        /* Descripter Number: 3 */
-                        wt->bit_writer(3, 4);
-
-                        min = (len < 14)? len : 14;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 1);
-
-                        base = min;
-                        min = ((len - base) < 7)? len - base : 7;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 2);
-
-                        min += base;
-                } else if (Simple16::try14_2bit(in, len)) {
-                        /* Descripter Number: 4 */
-                        wt->bit_writer(4, 4);
-
-                        min = (len < 14)? len : 14;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 2);
-                } else if (Simple16::try1_4bit_8_3bit(in, len)) {
-                        /* Descripter Number: 5 */
-                        wt->bit_writer(5, 4);
-
-                        min = (len < 1)? len : 1;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 4);
-
-                        base = min;
-                        min = ((len - base) < 8)? len - base : 8;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 3);
-
-                        min += base;
-                } else if (Simple16::try1_3bit_4_4bit_3_3bit(in, len)) {
-                        /* Descripter Number: 6 */
-                        wt->bit_writer(6, 4);
-
-                        min = (len < 1)? len : 1;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 3);
-
-                        base = min;
-                        min = (len - base < 4)? len - base : 4;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 4);
-
-                        base += min;
-                        min = (len - base < 3)? len - base : 3;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 3);
-
-                        min += base;
-                } else if (Simple16::try7_4bit(in, len)) {
-                        /* Descripter Number: 7 */
-                        wt->bit_writer(7, 4);
-
-                        min = (len < 7)? len : 7;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 4);
-                } else if (Simple16::try4_5bit_2_4bit(in, len)) {
-                        /* Descripter Number: 8 */
-                        wt->bit_writer(8, 4);
-
-                        min = (len < 4)? len : 4;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 5);
-
-                        base = min;
-                        min = ((len - base) < 2)? len - base : 2;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 4);
-
-                        min += base;
-                } else if (Simple16::try2_4bit_4_5bit(in, len)) {
-                        /* Descripter Number: 9 */
-                        wt->bit_writer(9, 4);
-
-                        min = (len < 2)? len : 2;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 4);
-
-                        base = min;
-                        min = ((len - base) < 4)? len - base : 4;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 5);
-
-                        min += base;
-                } else if (Simple16::try3_6bit_2_5bit(in, len)) {
-                        /* Descripter Number: 10 */
-                        wt->bit_writer(10, 4);
-
-                        min = (len < 3)? len : 3;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 6);
-
-                        base = min;
-                        min = ((len - base) < 2)? len - base : 2;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 5);
-
-                        min += base;
-                } else if (Simple16::try2_5bit_3_6bit(in, len)) {
-                        /* Descripter Number: 11 */
-                        wt->bit_writer(11, 4);
-
-                        min = (len < 2)? len : 2;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 5);
-
-                        base = min;
-                        min = ((len - base) < 3)? len - base : 3;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 6);
-
-                        min += base;
-                } else if (Simple16::try4_7bit(in, len)) {
-                        /* Descripter Number: 12 */
-                        wt->bit_writer(12, 4);
-
-                        min = (len < 4)? len : 4;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 7);
-                } else if (Simple16::try1_10bit_2_9bit(in, len)) {
-                        /* Descripter Number: 13 */
-                        wt->bit_writer(13, 4);
-
-                        min = (len < 1)? len : 1;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 10);
-
-                        base = min;
-                        min = ((len - base) < 2)? len - base : 2;
-                        for (i = base; i < base + min; i++)
-                                wt->bit_writer(*in++, 9);
-
-                        min += base;
-                } else if (Simple16::try2_14bit(in, len)) {
-                        /* Descripter Number: 14 */
-                        wt->bit_writer(14, 4);
-
-                        min = (len < 2)? len : 2;
-                        for (i = 0; i < min; i++)
-                                wt->bit_writer(*in++, 14);
-                } else {
-                        if ((*in >> 28) > 0)
-                                eoutput("Input's out of range: %u", *in);
-
-                        /* Descripter Number: 15 */
-                        wt->bit_writer(15, 4);
-
-                        min = 1;
-                        wt->bit_writer(*in++, 28);
+                /*
+                 * The class of each integer, i.e., the number of bit
+                 * widths it is over, is computed once in a window.
+                 */
+                if (nfill - pos < 28 && nfill - pos < len) {
+                        memmove(cls, cls + pos, nfill - pos);
+                        nfill -= pos;
+                        pos = 0;
+
+                        for (; nfill < SIMPLE16_WINDOW && nfill < len; nfill++) {
+                                v = in[nfill];
+                                cls[nfill] = __simple16_nover[__log2_uint64(v | 1)];
+                        }
+
+                        memset(cls + nfill, 0, 32);
                 }
 
-                /* Align to 32-bit */
-                wt->bit_flush();
+                /* over[c] has integers over the width of class c */
+                lo = _mm_loadu_si128((__m128i *)(cls + pos));
+                hi = _mm_loadu_si128((__m128i *)(cls + pos + 16));
 
-                len -= min;
-        }
+                for (i = 0; i < SIMPLE16_NWIDTHS; i++) {
+                        c = _mm_set1_epi8(i);
+                        over[i] = _mm_movemask_epi8(_mm_cmpgt_epi8(lo, c)) |
+                                (_mm_movemask_epi8(_mm_cmpgt_epi8(hi, c)) << 16);
+                }
+
+                /* Pick up a first descriptor that fits in the trying order */
+                for (d = 0, fit = 0; d < SIMPLE16_LEN; d++) {
+                        ly = &__simple16_layouts[d];
+
+                        fit |= (((over[ly->cls[0]] & ly->mask[0]) |
+                                        (over[ly->cls[1]] & ly->mask[1]) |
+                                        (over[ly->cls[2]] & ly->mask[2])) == 0) << d;
+                }
 
-        nvalue = wt->written;
+                if (__unlikely(fit == 0))
+                        eoutput("Input's out of range: %llu",
+                                        (unsigned long long)*in);
 
-        delete wt;
+                d = __builtin_ctz(fit);
+                ly = &__simple16_layouts[d];
+
+                /* Pack integers from MSB, as BitsWriter does */
+                num = (len < ly->num)? len : ly->num;
+                word = d << (32 - SIMPLE16_LOGDESC);
+                shift = 32 - SIMPLE16_LOGDESC;
+
+                for (g = 0, i = 0; i < num; g++) {
+                        w = __simple16_widths[ly->cls[g]];
+
+                        for (end = i + ly->n[g]; i < end && i < num; i++) {
+                                shift -= w;
+                                word |= (uint32_t)in[i] << shift;
+                        }
+                }
+
+                *pout++ = word;
+
+                in += num;
+                len -= num;
+                pos += num;
+        }
+
+        nvalue = pout - out;
 }
 
+template <class T>
 void
-Simple16::decodeArray(uint32_t *in, uint32_t len,
-                uint32_t *out, uint32_t nvalue)
+Simple16::decode(uint32_t *in, uint32_t len,
+                T *out, uint32_t nvalue)
 {
-        uint32_t        *end;
+        T               *end;
 
         end = out + nvalue;
 
         while (end > out) {
-                (__simple16_unpack[*in >>
+                (__simple16_unpacker<T>::unpack[*in >>
                  (32 - SIMPLE16_LOGDESC)])(&out, &in);
         }
 }
 
-/* --- Intra functions below --- */
+void
+Simple16::encodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        Simple16::encode(in, len, out, nvalue);
+}
 
 void
-__simple16_unpack1_28(uint32_t **out, uint32_t **in)
+Simple16::decodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue)
+{
+        Simple16::decode(in, len, out, nvalue);
+}
+
+void
+Simple16::encodeArray(uint64_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        Simple16::encode(in, len, out, nvalue);
+}
+
+void
+Simple16::decodeArray(uint32_t *in, uint32_t len,
+                uint64_t *out, uint32_t nvalue)
+{
+        Simple16::decode(in, len, out, nvalue);
+}
+
+uint32_t
+Simple16::decodeBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data, uint32_t *out)
 {
         uint32_t        *pout;
+
+        if (p == 0)
+                data = in;
+
+        /* A word might have integers past the end of a list */
+        for (pout = out; pout < out + n && pout < out + rest; p++) {
+                (__simple16_unpacker<uint32_t>::unpack[*data >>
+                 (32 - SIMPLE16_LOGDESC)])(&pout, &data);
+        }
+
+        return (pout < out + rest)? pout - out : rest;
+}
+
+uint32_t
+Simple16::skipBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data)
+{
+        uint32_t        k;
+
+        if (p == 0)
+                data = in;
+
+        for (k = 0; k < n && k < rest; p++)
+                k += __simple16_layouts[*data++ >> (32 - SIMPLE16_LOGDESC)].num;
+
+        return (k < rest)? k : rest;
+}
+
+/* --- Intra functions below --- */
+
+template <class T>
+void
+__simple16_unpack1_28(T **out, uint32_t **in)
+{
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -442,10 +363,11 @@ __simple16_unpack1_28(uint32_t **out, uint32_t **in)
         *out = pout + 28;
 }
 
+template <class T>
 void
-__simple16_unpack2_7_1_14(uint32_t **out, uint32_t **in)
+__simple16_unpack2_7_1_14(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -478,10 +400,11 @@ __simple16_unpack2_7_1_14(uint32_t **out, uint32_t **in)
         *out = pout + 21;
 }
 
+template <class T>
 void
-__simple16_unpack1_7_2_7_1_7(uint32_t **out, uint32_t **in)
+__simple16_unpack1_7_2_7_1_7(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -515,10 +438,11 @@ __simple16_unpack1_7_2_7_1_7(uint32_t **out, uint32_t **in)
         *out = pout + 21;
 }
 
+template <class T>
 void
-__simple16_unpack1_14_2_7(uint32_t **out, uint32_t **in)
+__simple16_unpack1_14_2_7(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -551,10 +475,11 @@ __simple16_unpack1_14_2_7(uint32_t **out, uint32_t **in)
         *out = pout + 21;
 }
 
+template <class T>
 void
-__simple16_unpack2_14(uint32_t **out, uint32_t **in)
+__simple16_unpack2_14(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -579,10 +504,11 @@ __simple16_unpack2_14(uint32_t **out, uint32_t **in)
         *out = pout + 14;
 }
 
+template <class T>
 void
-__simple16_unpack4_1_3_8(uint32_t **out, uint32_t **in)
+__simple16_unpack4_1_3_8(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -602,10 +528,11 @@ __simple16_unpack4_1_3_8(uint32_t **out, uint32_t **in)
         *in = pin + 1;
         *out = pout + 9;
 }
+template <class T>
 void
-__simple16_unpack3_1_4_4_3_3(uint32_t **out, uint32_t **in)
+__simple16_unpack3_1_4_4_3_3(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -626,10 +553,11 @@ __simple16_unpack3_1_4_4_3_3(uint32_t **out, uint32_t **in)
         *out = pout + 8;
 }
 
+template <class T>
 void
-__simple16_unpack4_7(uint32_t **out, uint32_t **in)
+__simple16_unpack4_7(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -647,10 +575,11 @@ __simple16_unpack4_7(uint32_t **out, uint32_t **in)
         *out = pout + 7;
 }
 
+template <class T>
 void
-__simple16_unpack5_4_4_2(uint32_t **out, uint32_t **in)
+__simple16_unpack5_4_4_2(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -668,10 +597,11 @@ __simple16_unpack5_4_4_2(uint32_t **out, uint32_t **in)
         *out = pout + 6;
 }
 
+template <class T>
 void
-__simple16_unpack4_2_5_4(uint32_t **out, uint32_t **in)
+__simple16_unpack4_2_5_4(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -689,10 +619,11 @@ __simple16_unpack4_2_5_4(uint32_t **out, uint32_t **in)
         *out = pout + 6;
 }
 
+template <class T>
 void
-__simple16_unpack6_3_5_2(uint32_t **out, uint32_t **in)
+__simple16_unpack6_3_5_2(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -709,10 +640,11 @@ __simple16_unpack6_3_5_2(uint32_t **out, uint32_t **in)
         *out = pout + 5;
 }
 
+template <class T>
 void
-__simple16_unpack5_2_6_3(uint32_t **out, uint32_t **in)
+__simple16_unpack5_2_6_3(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -729,10 +661,11 @@ __simple16_unpack5_2_6_3(uint32_t **out, uint32_t **in)
         *out = pout + 5;
 }
 
+template <class T>
 void
-__simple16_unpack7_4(uint32_t **out, uint32_t **in)
+__simple16_unpack7_4(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -747,10 +680,11 @@ __simple16_unpack7_4(uint32_t **out, uint32_t **in)
         *out = pout + 4;
 }
 
+template <class T>
 void
-__simple16_unpack10_1_9_2(uint32_t **out, uint32_t **in)
+__simple16_unpack10_1_9_2(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -765,10 +699,11 @@ __simple16_unpack10_1_9_2(uint32_t **out, uint32_t **in)
         *out = pout + 3;
 }
 
+template <class T>
 void
-__simple16_unpack14_2(uint32_t **out, uint32_t **in)
+__simple16_unpack14_2(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -781,10 +716,11 @@ __simple16_unpack14_2(uint32_t **out, uint32_t **in)
         *out = pout + 2;
 }
 
+template <class T>
 void
-__simple16_unpack28_1(uint32_t **out, uint32_t **in)
+__simple16_unpack28_1(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -18,8 +18,9 @@
 #define SIMPLE9_LEN             (1 << SIMPLE9_LOGDESC)
 
 #define SIMPLE9_DESC_FUNC(num, log)     \
+        template <class T>              \
         bool                            \
-        Simple9::try##num##_##log##bit(uint32_t *n, uint32_t len)       \
+        Simple9::try##num##_##log##bit(T *n, uint32_t len)       \
         {                                       \
                 uint32_t        i;              \
                 uint32_t        min;            \
@@ -44,40 +45,61 @@ SIMPLE9_DESC_FUNC(4, 7);
 SIMPLE9_DESC_FUNC(3, 9);
 SIMPLE9_DESC_FUNC(2, 14);
 
+/* # of integers in a word for each descriptor */
+static const uint32_t __simple9_nums[SIMPLE9_LEN] = {
+        28, 14, 9, 7, 5, 4, 3, 2, 1, 0, 0, 0, 0, 0, 0, 0
+};
+
 /* A set of unpacking functions */
-static inline void __simple9_unpack1_28(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack1_28(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple9_unpack2_14(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack2_14(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple9_unpack3_9(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack3_9(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple9_unpack4_7(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack4_7(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple9_unpack5_5(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack5_5(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple9_unpack7_4(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack7_4(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple9_unpack9_3(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack9_3(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple9_unpack14_2(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack14_2(T **out, uint32_t **in)
         __attribute__((always_inline));
-static inline void __simple9_unpack28_1(uint32_t **out, uint32_t **in)
+template <class T>
+static inline void __simple9_unpack28_1(T **out, uint32_t **in)
         __attribute__((always_inline));
 
 /* A interface of unpacking functions above */
-typedef void (*__simple9_unpacker)(uint32_t **out, uint32_t **in);
-
-static __simple9_unpacker       __simple9_unpack[SIMPLE9_LEN] = {
-        __simple9_unpack1_28, __simple9_unpack2_14,
-        __simple9_unpack3_9, __simple9_unpack4_7,
-        __simple9_unpack5_5, __simple9_unpack7_4,
-        __simple9_unpack9_3, __simple9_unpack14_2,
-        __simple9_unpack28_1, NULL, NULL, NULL,
+template <class T>
+struct __simple9_unpacker {
+        typedef void (*unpacker)(T **out, uint32_t **in);
+
+        static unpacker         unpack[SIMPLE9_LEN];
+};
+
+template <class T>
+typename __simple9_unpacker<T>::unpacker __simple9_unpacker<T>::unpack[SIMPLE9_LEN] = {
+        __simple9_unpack1_28<T>, __simple9_unpack2_14<T>,
+        __simple9_unpack3_9<T>, __simple9_unpack4_7<T>,
+        __simple9_unpack5_5<T>, __simple9_unpack7_4<T>,
+        __simple9_unpack9_3<T>, __simple9_unpack14_2<T>,
+        __simple9_unpack28_1<T>, NULL, NULL, NULL,
         NULL, NULL, NULL, NULL
 };
 
+template <class T>
 void
-Simple9::encodeArray(uint32_t *in, uint32_t len,
+Simple9::encode(T *in, uint32_t len,
                 uint32_t *out, uint32_t &nvalue)
 {
         uint32_t        i;
@@ -145,7 +167,8 @@ Simple9::encodeArray(uint32_t *in, uint32_t len,
                                 wt->bit_writer(*in++, 14);
                 } else {
                         if ((*in >> 28) > 0)
-                                eoutput("Input's out of range: %u", *in);
+                                eoutput("Input's out of range: %llu",
+                                                (unsigned long long)*in);
 
                         /* Descripter Number: 8 */
                         wt->bit_writer(8, 4);
@@ -165,26 +188,89 @@ Simple9::encodeArray(uint32_t *in, uint32_t len,
         delete wt;
 }
 
+template <class T>
 void
-Simple9::decodeArray(uint32_t *in, uint32_t len,
-                uint32_t *out, uint32_t nvalue)
+Simple9::decode(uint32_t *in, uint32_t len,
+                T *out, uint32_t nvalue)
 {
-        uint32_t        *end;
+        T               *end;
 
         end = out + nvalue;
 
         while (end > out) {
-                (__simple9_unpack[*in >>
+                (__simple9_unpacker<T>::unpack[*in >>
                  (32 - SIMPLE9_LOGDESC)])(&out, &in);
         }
 }
 
-/* --- Intra functions below --- */
+void
+Simple9::encodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        Simple9::encode(in, len, out, nvalue);
+}
 
 void
-__simple9_unpack1_28(uint32_t **out, uint32_t **in)
+Simple9::decodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue)
+{
+        Simple9::decode(in, len, out, nvalue);
+}
+
+void
+Simple9::encodeArray(uint64_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        Simple9::encode(in, len, out, nvalue);
+}
+
+void
+Simple9::decodeArray(uint32_t *in, uint32_t len,
+                uint64_t *out, uint32_t nvalue)
+{
+        Simple9::decode(in, len, out, nvalue);
+}
+
+uint32_t
+Simple9::decodeBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data, uint32_t *out)
 {
         uint32_t        *pout;
+
+        if (p == 0)
+                data = in;
+
+        /* A word might have integers past the end of a list */
+        for (pout = out; pout < out + n && pout < out + rest; p++) {
+                (__simple9_unpacker<uint32_t>::unpack[*data >>
+                 (32 - SIMPLE9_LOGDESC)])(&pout, &data);
+        }
+
+        return (pout < out + rest)? pout - out : rest;
+}
+
+uint32_t
+Simple9::skipBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data)
+{
+        uint32_t        k;
+
+        if (p == 0)
+                data = in;
+
+        for (k = 0; k < n && k < rest; p++)
+                k += __simple9_nums[*data++ >> (32 - SIMPLE9_LOGDESC)];
+
+        return (k < rest)? k : rest;
+}
+
+/* --- Intra functions below --- */
+
+template <class T>
+void
+__simple9_unpack1_28(T **out, uint32_t **in)
+{
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -223,10 +309,11 @@ __simple9_unpack1_28(uint32_t **out, uint32_t **in)
         *out = pout + 28;
 }
 
+template <class T>
 void
-__simple9_unpack2_14(uint32_t **out, uint32_t **in)
+__simple9_unpack2_14(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -251,10 +338,11 @@ __simple9_unpack2_14(uint32_t **out, uint32_t **in)
         *out = pout + 14;
 }
 
+template <class T>
 void
-__simple9_unpack3_9(uint32_t **out, uint32_t **in)
+__simple9_unpack3_9(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -274,10 +362,11 @@ __simple9_unpack3_9(uint32_t **out, uint32_t **in)
         *out = pout + 9;
 }
 
+template <class T>
 void
-__simple9_unpack4_7(uint32_t **out, uint32_t **in)
+__simple9_unpack4_7(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -295,10 +384,11 @@ __simple9_unpack4_7(uint32_t **out, uint32_t **in)
         *out = pout + 7;
 }
 
+template <class T>
 void
-__simple9_unpack5_5(uint32_t **out, uint32_t **in)
+__simple9_unpack5_5(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -314,10 +404,11 @@ __simple9_unpack5_5(uint32_t **out, uint32_t **in)
         *out = pout + 5;
 }
 
+template <class T>
 void
-__simple9_unpack7_4(uint32_t **out, uint32_t **in)
+__simple9_unpack7_4(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -332,10 +423,11 @@ __simple9_unpack7_4(uint32_t **out, uint32_t **in)
         *out = pout + 4;
 }
 
+template <class T>
 void
-__simple9_unpack9_3(uint32_t **out, uint32_t **in)
+__simple9_unpack9_3(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -349,10 +441,11 @@ __simple9_unpack9_3(uint32_t **out, uint32_t **in)
         *out = pout + 3;
 }
 
+template <class T>
 void
-__simple9_unpack14_2(uint32_t **out, uint32_t **in)
+__simple9_unpack14_2(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -365,10 +458,11 @@ __simple9_unpack14_2(uint32_t **out, uint32_t **in)
         *out = pout + 2;
 }
 
+template <class T>
 void
-__simple9_unpack28_1(uint32_t **out, uint32_t **in)
+__simple9_unpack28_1(T **out, uint32_t **in)
 {
-        uint32_t        *pout;
+        T               *pout;
         uint32_t        *pin;
 
         pout = *out;
@@ -72,6 +72,17 @@ static __vser_unpacker       __vser_unpack[] = {
         __vser_unpack31, __vser_unpack32
 };
 
+/*
+ * Unpacking functions for odd widths with BMI2, and they take over
+ * the ones above if available.
+ */
+template <uint32_t B>
+static void __vser_unpack_bmi2(uint32_t *out, uint32_t *in, uint32_t bs)
+        __bmi2_target;
+
+static bool __vser_setup_bmi2(void);
+static bool __vser_bmi2 __attribute__((unused)) = __vser_setup_bmi2();
+
 void
 VSE_R::encodeArray(uint32_t *in, uint32_t len,
                 uint32_t *out, uint32_t &nvalue)
@@ -208,6 +219,32 @@ VSE_R::decodeArray(uint32_t *in, uint32_t len,
 
 /* --- Intra functions below --- */
 
+bool
+__vser_setup_bmi2(void)
+{
+        if (!BMI2Unpack::available())
+                return false;
+
+        __vser_unpack[2] = __vser_unpack_bmi2<3>;
+        __vser_unpack[4] = __vser_unpack_bmi2<5>;
+        __vser_unpack[6] = __vser_unpack_bmi2<7>;
+        __vser_unpack[8] = __vser_unpack_bmi2<9>;
+        __vser_unpack[10] = __vser_unpack_bmi2<11>;
+        __vser_unpack[12] = __vser_unpack_bmi2<13>;
+
+        return true;
+}
+
+template <uint32_t B>
+void
+__vser_unpack_bmi2(uint32_t *out, uint32_t *in, uint32_t bs)
+{
+        uint32_t        i;
+
+        for (i = 0; i < bs; i += B, out += 32, in += B)
+                BMI2Unpack::unpack32<B>(out, in, 1U << B);
+}
+
 void
 __vser_unpack1(uint32_t *out, uint32_t *in, uint32_t bs)
 {
@@ -17,12 +17,17 @@
 
 #include "compress/VSEncoding.hpp"
 
+static uint32_t __vse_max(uint32_t *seq, uint32_t head, uint32_t tail);
+
 VSEncoding::VSEncoding(uint32_t *lens, uint32_t *zlens, uint32_t size, bool cflag)
 {
         possLens = lens;
         posszLens = zlens;
         poss_sz = size;
         aligned = cflag;
+        costFunc = NULL;
+
+        setDecodeCost(0.0, 0.0, NULL, NULL, 0);
 
         /* Set the max length of sequences */
         maxBlk = possLens[poss_sz - 1];
@@ -30,6 +35,85 @@ VSEncoding::VSEncoding(uint32_t *lens, uint32_t *zlens, uint32_t size, bool cfla
         if (posszLens != NULL &&
                         maxBlk < posszLens[poss_sz - 1])
                 maxBlk = posszLens[poss_sz - 1];
+
+        fast = false;
+        setFastLens();
+}
+
+VSEncoding::VSEncoding(uint32_t *lens, uint32_t size, pt2Cost cost)
+{
+        possLens = lens;
+        posszLens = NULL;
+        poss_sz = size;
+        aligned = false;
+        costFunc = cost;
+
+        setDecodeCost(0.0, 0.0, NULL, NULL, 0);
+
+        maxBlk = possLens[poss_sz - 1];
+
+        fast = false;
+        setFastLens();
+}
+
+VSEncoding::~VSEncoding()
+{
+        delete[] lenFlags;
+}
+
+void
+VSEncoding::setFastLens()
+{
+        uint32_t        i;
+        uint32_t        n;
+        uint32_t        m;
+
+        lenFlags = new uint8_t[maxBlk + 1];
+
+        if (lenFlags == NULL)
+                eoutput("Can't allocate memory");
+
+        memset(lenFlags, 0, maxBlk + 1);
+
+        for (i = 0; i < poss_sz; i++) {
+                lenFlags[possLens[i]] |= 1;
+                lenFlags[(posszLens != NULL)? posszLens[i] : possLens[i]] |= 2;
+        }
+
+        /* Lengths in increasing order with a few significant bits */
+        for (n = 1, nfast = 0; n <= maxBlk; n++) {
+                m = int_utils::get_msb(n);
+
+                if (lenFlags[n] == 0 || (m >= VSENCODING_FASTBITS &&
+                                (n & ((1U << (m + 1 - VSENCODING_FASTBITS)) - 1)) != 0))
+                        continue;
+
+                fastLens[nfast] = n;
+                fastLogs[nfast++] = m;
+        }
+
+        __assert(nfast <= VSENCODING_MAXFAST);
+}
+
+void
+VSEncoding::setDecodeCost(double lambda, double partNs,
+                double *intNs, uint32_t *logs, uint32_t n)
+{
+        uint32_t        i;
+        double          scale;
+
+        /* Costs in ns are converted into the unit of sizes */
+        scale = lambda * VSENCODING_COSTSCALE / ((aligned)? 32 : 1);
+
+        partCost = (uint64_t)(scale * partNs + 0.5);
+
+        for (i = 0; i <= VSENCODING_MAXLOG; i++)
+                intCost[i] = 0;
+
+        for (i = 0; i < n; i++) {
+                __assert(logs[i] <= VSENCODING_MAXLOG);
+                intCost[logs[i]] = (uint64_t)(scale * intNs[i] + 0.5);
+        }
 }
 
 uint32_t *
@@ -64,7 +148,9 @@ VSEncoding::compute_OptPartition(uint32_t *seq,
          * by using RMQ data structures. We use this trivial
          * solution since construction time is not our main concern. 
          */   
-        {
+        if (fast && lenFlags[1] == 3) {
+                computeFastPaths(seq, len, fixCost, SSSP, cost);
+        } else {
                 int     mleft;
                 int     j;
                 int     g;
@@ -74,7 +160,8 @@ VSEncoding::compute_OptPartition(uint32_t *seq,
                         mleft = ((int)(i - maxBlk) > 0)? i - maxBlk : 0;
 
                         for (maxB = 0, l = 0, g = 0, j = i - 1; j >= mleft; j--) {
-                                if (maxB < seq[j])
+                                /* seq[] is opaque for a given cost function */
+                                if (costFunc == NULL && maxB < seq[j])
                                         maxB = seq[j];
 
                                 if (posszLens == NULL) {
@@ -114,11 +201,7 @@ VSEncoding::compute_OptPartition(uint32_t *seq,
                                         }
                                 }
 
-                                /* Caluculate costs */
-                                if (aligned)
-                                        curCost = cost[j] + int_utils::div_roundup((i - j) * maxB, 32) + fixCost;
-                                else
-                                        curCost = cost[j] + (i - j) * maxB + fixCost;
+                                curCost = blockCost(seq, j, i, maxB, fixCost) + cost[j];
 
                                 if (SSSP[i] == -1)
                                         cost[i] = curCost + 1;
@@ -170,4 +253,141 @@ VSEncoding::compute_OptPartition(uint32_t *seq,
         return part;
 }
 
+/*
+ * Caluculate costs, which are scaled to add decoding time of a
+ * block. Scaling does not change the optimal partition if no
+ * decoding time is given.
+ */
+uint64_t
+VSEncoding::blockCost(uint32_t *seq, uint32_t head,
+                uint32_t tail, uint32_t maxB, uint32_t fixCost)
+{
+        if (costFunc != NULL)
+                return ((costFunc)(seq, head, tail) + fixCost) * VSENCODING_COSTSCALE;
+        else if (aligned)
+                return (int_utils::div_roundup((tail - head) * maxB, 32) + fixCost) *
+                                VSENCODING_COSTSCALE + partCost + (tail - head) * intCost[maxB];
+        else
+                return ((uint64_t)(tail - head) * maxB + fixCost) *
+                                VSENCODING_COSTSCALE + partCost + (tail - head) * intCost[maxB];
+}
+
+/*
+ * The same paths as the optimal partition over blocks in fastLens[].
+ * A max value in a block of 2^k integers ending at i is the larger of
+ * two halves, and ones of each k are kept in a ring of the last maxBlk
+ * positions. A block of n integers is covered by two blocks of 2^k,
+ * where 2^k <= n < 2^(k + 1), as in RMQ, so no block is scanned.
+ */
+void
+VSEncoding::computeFastPaths(uint32_t *seq, uint32_t len,
+                uint32_t fixCost, int *SSSP, uint64_t *cost)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        m;
+        uint32_t        p;
+        uint32_t        K;
+        uint32_t        rsz;
+        uint32_t        maxB;
+        uint32_t        cmax;
+        uint32_t        pmax;
+        uint32_t        a;
+        uint32_t        b;
+        uint32_t        *ring;
+        uint64_t        curCost;
+
+        K = int_utils::get_msb(maxBlk);
+
+        for (rsz = 1; rsz <= maxBlk; rsz <<= 1) ;
+
+        ring = new uint32_t[(K + 1) * rsz];
+
+        if (ring == NULL)
+                eoutput("Can't allocate memory");
+
+#define __ring(k, pos)  ring[(k) * rsz + ((pos) & (rsz - 1))]
+
+        for (i = 1; i <= len; i++) {
+                /* seq[] is opaque for a given cost function */
+                if (costFunc == NULL) {
+                        __ring(0, i) = seq[i - 1];
+
+                        for (k = 1; k <= K && (1U << k) <= i; k++)
+                                __ring(k, i) = std::max(__ring(k - 1, i),
+                                                __ring(k - 1, i - (1U << (k - 1))));
+                }
+
+                /* Longer blocks win ties as the optimal partition */
+                for (k = 0, maxB = 0; k < nfast && fastLens[k] <= i; k++) {
+                        p = fastLens[k];
+
+                        if (costFunc == NULL) {
+                                m = fastLogs[k];
+                                maxB = std::max(__ring(m, i),
+                                                __ring(m, i - p + (1U << m)));
+                        }
+
+                        if (!(lenFlags[p] & ((posszLens != NULL && maxB == 0)? 2 : 1)))
+                                continue;
+
+                        curCost = blockCost(seq, i - p, i, maxB, fixCost) + cost[i - p];
+
+                        if (SSSP[i] == -1 || curCost <= cost[i]) {
+                                cost[i] = curCost;
+                                SSSP[i] = i - p;
+                        }
+                }
+
+                /* A block of 1 integer is always possible */
+                __assert(SSSP[i] != -1);
+        }
+
+#undef __ring
+
+        delete[] ring;
+
+        /*
+         * Adjacent blocks are merged if smaller, walking back the path,
+         * where cmax and pmax are max values in a current block and
+         * a previous one. Each integer is scanned once.
+         */
+        cmax = (costFunc == NULL && len > 0)? __vse_max(seq, SSSP[len], len) : 0;
+
+        for (i = len; i > 0 && SSSP[i] > 0; ) {
+                b = SSSP[i];
+                a = SSSP[b];
+
+                pmax = (costFunc == NULL)? __vse_max(seq, a, b) : 0;
+                maxB = std::max(cmax, pmax);
+
+                if (i - a <= maxBlk && (lenFlags[i - a] &
+                                ((posszLens != NULL && maxB == 0)? 2 : 1)) &&
+                                blockCost(seq, a, i, maxB, fixCost) <=
+                                blockCost(seq, a, b, pmax, fixCost) +
+                                blockCost(seq, b, i, cmax, fixCost)) {
+                        SSSP[i] = a;
+                        cmax = maxB;
+                } else {
+                        i = b;
+                        cmax = pmax;
+                }
+        }
+}
+
+/* --- Intra functions below --- */
+
+/* A max value in seq[head..tail) */
+uint32_t
+__vse_max(uint32_t *seq, uint32_t head, uint32_t tail)
+{
+        uint32_t        i;
+        uint32_t        maxB;
+
+        for (i = head, maxB = 0; i < tail; i++)
+                maxB = std::max(maxB, seq[i]);
+
+        return maxB;
+}
+
 #endif /* VSENCODING_CPP */
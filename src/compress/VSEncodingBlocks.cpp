@@ -21,6 +21,10 @@
 #define VSEBLOCKS_LENS_LEN      (1 << VSEBLOCKS_LOGLEN)
 #define VSEBLOCKS_LOGS_LEN      (1 << VSEBLOCKS_LOGLOG)
 
+#if VSEBLOCKS_LOGS_LEN != VSEBLOCKS_NBUCKETS
+ #error "VSEBLOCKS_NBUCKETS must be the # of widths"
+#endif
+
 #define __vseblocks_copy16(src, dest)   \
         __asm__ __volatile__(           \
                 "movdqu %4, %%xmm0\n\t"         \
@@ -35,21 +39,6 @@
                 :"m" (src[0]), "m" (src[4]), "m" (src[8]), "m" (src[12])                \
                 :"memory", "%xmm0", "%xmm1", "%xmm2", "%xmm3")
 	    
-#define __vseblocks_zero32(dest)        \
-        __asm__ __volatile__(           \
-                "pxor   %%xmm0, %%xmm0\n\t"     \
-                "movdqu %%xmm0, %0\n\t"         \
-                "movdqu %%xmm0, %1\n\t"         \
-                "movdqu %%xmm0, %2\n\t"         \
-                "movdqu %%xmm0, %3\n\t"         \
-                "movdqu %%xmm0, %4\n\t"         \
-                "movdqu %%xmm0, %5\n\t"         \
-                "movdqu %%xmm0, %6\n\t"         \
-                "movdqu %%xmm0, %7\n\t"         \
-                :"=m" (dest[0]), "=m" (dest[4]), "=m" (dest[8]), "=m" (dest[12]) ,               \
-                        "=m" (dest[16]), "=m" (dest[20]), "=m" (dest[24]), "=m" (dest[28])       \
-                ::"memory", "%xmm0")
-
 /* A set of unpacking functions */
 static void __vseblocks_unpack1(uint32_t *__no_aliases__ out,
                 uint32_t *in, uint32_t bs);
@@ -97,6 +86,52 @@ static __vseblocks_unpacker       __vseblocks_unpack[] = {
         __vseblocks_unpack20, __vseblocks_unpack32
 };
 
+/*
+ * Unpacking functions for odd widths with BMI2, and they take over
+ * the ones above if available.
+ */
+template <uint32_t B>
+static void __vseblocks_unpack_bmi2(uint32_t *__no_aliases__ out,
+                uint32_t *in, uint32_t bs) __bmi2_target;
+
+static bool __vseblocks_setup_bmi2(void);
+static bool __vseblocks_bmi2 __attribute__((unused)) = __vseblocks_setup_bmi2();
+
+/*
+ * Runs per 8-bit descriptor, i.e., a width code B and a length code K,
+ * where nout integers are written and nsrc of them are taken from a
+ * bucket, so that permuting functions never branch on B.
+ */
+struct __vseblocks_run {
+        uint32_t        nout;
+        uint32_t        nsrc;
+};
+
+static struct __vseblocks_run   __vseblocks_runs[1 << VSEBLOCKS_LOGDESC];
+
+static bool __vseblocks_setup_runs(void);
+static bool __vseblocks_runs_ok __attribute__((unused)) = __vseblocks_setup_runs();
+
+/* Runs of zeros are copied from here, which is never advanced */
+static uint32_t __vseblocks_zeros[32] __attribute__((aligned(16)));
+
+/*
+ * Permuting functions along a batch of descriptors, and the AVX-512
+ * one takes over if available.
+ */
+typedef void (*__vseblocks_permuter)(uint32_t *desc,
+                uint32_t **pblk, uint32_t *out, uint32_t *end);
+
+static void __vseblocks_permute_sse2(uint32_t *desc,
+                uint32_t **pblk, uint32_t *out, uint32_t *end);
+static void __vseblocks_permute_avx512(uint32_t *desc,
+                uint32_t **pblk, uint32_t *out, uint32_t *end) __avx512_target;
+
+static __vseblocks_permuter     __vseblocks_permute = __vseblocks_permute_sse2;
+
+static bool __vseblocks_setup_avx512(void);
+static bool __vseblocks_avx512 __attribute__((unused)) = __vseblocks_setup_avx512();
+
 /*
  * There is asymmetry between possible lenghts ofblocks
  * if they are formed by zeros or larger numbers. 
@@ -135,7 +170,19 @@ static uint32_t __vseblocks_possLogs[] = {
                 &__vseblocks_posszLens[0], VSEBLOCKS_LENS_LEN, false);
 #endif /* USE_BOOST_SHAREDPTR */
 
-static uint32_t *__tmp = new uint32_t[VSENCODING_BLOCKSZ * 2 + TAIL_MERGIN];
+/*
+ * Decoding costs in ns of a partition and an integer per width in
+ * __vseblocks_possLogs[], which are measured by test/partbench.
+ */
+static double __vseblocks_partNs = 3.068;
+
+static double __vseblocks_intNs[] = {
+        0.359, 0.360, 0.352, 0.245, 0.327, 0.230, 0.368, 0.232,
+        0.299, 0.270, 0.415, 0.292, 0.397, 0.328, 0.925, 0.385
+};
+
+/* Lists up to this length are decoded with a scratch area on a stack */
+#define VSEBLOCKS_STACKLEN      4096
 
 void
 VSEncodingBlocks::encodeVS(uint32_t len,
@@ -291,16 +338,34 @@ VSEncodingBlocks::encodeVS(uint32_t len,
 void
 VSEncodingBlocks::decodeVS(uint32_t len,
                 uint32_t *in, uint32_t *out, uint32_t *aux)
+{
+        decodeVS(len, in, NULL, out, aux);
+}
+
+void
+VSEncodingBlocks::decodeVS(uint32_t len, uint32_t *in,
+                uint32_t *desc, uint32_t *out, uint32_t *aux)
+{
+        uint32_t        *addr;
+        uint32_t        *pblk[VSEBLOCKS_NBUCKETS];
+
+        __validate(in, len);
+
+        addr = unpackVS(in, aux, pblk);
+
+        if (desc != NULL)
+                addr = desc;
+
+        permuteVS(len, addr, pblk, out);
+}
+
+uint32_t *
+VSEncodingBlocks::unpackVS(uint32_t *in, uint32_t *aux, uint32_t **pblk)
 {
         int             ntotal;
         uint32_t        nblk;
         uint32_t        *addr;
-        uint32_t        *pblk[VSEBLOCKS_LOGS_LEN];
         uint32_t        B;
-        uint32_t        K;
-        uint32_t        *end;
-
-        __validate(in, len);
 
         ntotal = *in++;
         addr = in + ntotal;
@@ -317,71 +382,30 @@ VSEncodingBlocks::decodeVS(uint32_t len,
                 addr += (nblk * __vseblocks_possLogs[B] + 31) / 32;
         }
 
-        /*
-         * FIXME: We assume that a 32-bit block is processed in a loop here.
-         * I might think some amount of 32-bit blocks are processed simutaneously.
-         */
-        end = out + len;
-
-        do {
-                /* Permuting integers with a first 8-bit */
-                B = (*addr) >> (VSEBLOCKS_LOGDESC * 3 + VSEBLOCKS_LOGLEN);
-                K = (((*addr) >> (VSEBLOCKS_LOGDESC * 3)) & (VSEBLOCKS_LENS_LEN - 1));
-
-                if (B) {
-                        /*
-                         * NOTICE: If a max value in __vseblocks_possLens[] is
-                         * over 16, a code below needs to be fixed.
-                         * __vseblocks_copy16() just copies 16 values each.
-                         */
-                        __vseblocks_copy16(pblk[B], out);
-                        pblk[B] += __vseblocks_possLens[K];
-                        out += __vseblocks_possLens[K];
-                } else {
-                        /* FIXME: Is it better to do memcpy() firstly? */
-                        __vseblocks_zero32(out);
-                        out += __vseblocks_posszLens[K];
-                }
-
-                /* Permuting integers with a second 8-bit */
-                B = ((*addr) >> (VSEBLOCKS_LOGDESC * 2 + VSEBLOCKS_LOGLEN)) & (VSEBLOCKS_LOGS_LEN - 1);
-                K = (((*addr) >> (VSEBLOCKS_LOGDESC * 2)) & (VSEBLOCKS_LENS_LEN - 1));
+        return addr;
+}
 
-                if (B) {
-                        __vseblocks_copy16(pblk[B], out);
-                        pblk[B] += __vseblocks_possLens[K];
-                        out += __vseblocks_possLens[K];
-                } else {
-                        __vseblocks_zero32(out);
-                        out += __vseblocks_posszLens[K];
-                }
+void
+VSEncodingBlocks::permuteVS(uint32_t len, uint32_t *desc,
+                uint32_t **pblk, uint32_t *out)
+{
+        (__vseblocks_permute)(desc, pblk, out, out + len);
+}
 
-                /* Permuting integers with a third 8-bit */
-                B = ((*addr) >> (VSEBLOCKS_LOGDESC  + VSEBLOCKS_LOGLEN)) & (VSEBLOCKS_LOGS_LEN - 1);
-                K = (((*addr) >> VSEBLOCKS_LOGDESC) & (VSEBLOCKS_LENS_LEN - 1));
+uint32_t
+VSEncodingBlocks::descOffset(uint32_t *in)
+{
+        uint32_t        i;
+        uint32_t        ntotal;
+        uint32_t        off;
 
-                if (B) {
-                        __vseblocks_copy16(pblk[B], out);
-                        pblk[B] += __vseblocks_possLens[K];
-                        out += __vseblocks_possLens[K];
-                } else {
-                        __vseblocks_zero32(out);
-                        out += __vseblocks_posszLens[K];
-                }
+        ntotal = *in;
 
-                /* Permuting integers with a fourth 8-bit */
-                B = ((*addr) >> VSEBLOCKS_LOGLEN) & (VSEBLOCKS_LOGS_LEN - 1);
-                K = (*addr++) & (VSEBLOCKS_LENS_LEN - 1);
+        for (i = 1, off = ntotal + 1; i <= ntotal; i++)
+                off += ((in[i] >> VSEBLOCKS_LOGLEN) *
+                        __vseblocks_possLogs[in[i] & (VSEBLOCKS_LOGS_LEN - 1)] + 31) / 32;
 
-                if (B) {
-                        __vseblocks_copy16(pblk[B], out);
-                        pblk[B] += __vseblocks_possLens[K];
-                        out += __vseblocks_possLens[K];
-                } else {
-                        __vseblocks_zero32(out);
-                        out += __vseblocks_posszLens[K];
-                }
-        } while (end > out);
+        return off;
 }
 
 void
@@ -397,9 +421,8 @@ VSEncodingBlocks::encodeArray(uint32_t *in,
                         res > VSENCODING_BLOCKSZ;
                         res -= VSENCODING_BLOCKSZ, lin += VSENCODING_BLOCKSZ,
                         lout += csize, nvalue += csize + 1) {
-                encodeVS(VSENCODING_BLOCKSZ, lin, csize, __tmp);
+                encodeVS(VSENCODING_BLOCKSZ, lin, csize, lout + 1);
                 *lout++ = csize;
-                memcpy(lout, __tmp, csize * sizeof(uint32_t));
         }
 
         encodeVS(res, lin, csize, lout);
@@ -410,24 +433,189 @@ void
 VSEncodingBlocks::decodeArray(uint32_t *in,
                 uint32_t len, uint32_t *out, uint32_t nvalue)
 {
+        uint32_t        n;
         uint32_t        res;
         uint32_t        sum;
+        uint32_t        *aux;
+        uint32_t        stk[__vseblocks_auxlen(VSEBLOCKS_STACKLEN)];
 
         __validate(in, (len << 2));
         __validate(out, ((nvalue + TAIL_MERGIN) << 2));
 
+        /* A scratch area per call, so that threads decode lists at once */
+        n = (nvalue < VSENCODING_BLOCKSZ)? nvalue : VSENCODING_BLOCKSZ;
+        aux = (n <= VSEBLOCKS_STACKLEN)? stk : new uint32_t[__vseblocks_auxlen(n)];
+
+        if (aux == NULL)
+                eoutput("Can't allocate memory");
+
         for (res = nvalue; res > VSENCODING_BLOCKSZ;
                         out += VSENCODING_BLOCKSZ, in += sum,
                         res -= VSENCODING_BLOCKSZ) {
                 sum = *in++;
-                decodeVS(VSENCODING_BLOCKSZ, in, out, __tmp);
+                decodeVS(VSENCODING_BLOCKSZ, in, out, aux);
         }
 
-        decodeVS(res, in, out, __tmp);
+        decodeVS(res, in, out, aux);
+
+        if (aux != stk)
+                delete[] aux;
+}
+
+void
+VSEncodingBlocks::setDecodeCost(double lambda)
+{
+        setDecodeCost(lambda, __vseblocks_partNs, __vseblocks_intNs);
+}
+
+void
+VSEncodingBlocks::setDecodeCost(double lambda, double partNs, double *intNs)
+{
+        __vseblocks->setDecodeCost(lambda, partNs, intNs,
+                        __vseblocks_possLogs, VSEBLOCKS_LOGS_LEN);
+}
+
+void
+VSEncodingBlocks::setFastPartition(bool fast)
+{
+        __vseblocks->setFastMode(fast);
 }
 
 /* --- Intra functions below --- */
 
+bool
+__vseblocks_setup_bmi2(void)
+{
+        if (!BMI2Unpack::available())
+                return false;
+
+        __vseblocks_unpack[3] = __vseblocks_unpack_bmi2<3>;
+        __vseblocks_unpack[5] = __vseblocks_unpack_bmi2<5>;
+        __vseblocks_unpack[7] = __vseblocks_unpack_bmi2<7>;
+        __vseblocks_unpack[9] = __vseblocks_unpack_bmi2<9>;
+        __vseblocks_unpack[11] = __vseblocks_unpack_bmi2<11>;
+
+        return true;
+}
+
+bool
+__vseblocks_setup_runs(void)
+{
+        uint32_t        c;
+        uint32_t        B;
+        uint32_t        K;
+
+        for (c = 0; c < (1 << VSEBLOCKS_LOGDESC); c++) {
+                B = c >> VSEBLOCKS_LOGLEN;
+                K = c & (VSEBLOCKS_LENS_LEN - 1);
+
+                __vseblocks_runs[c].nout = (B)?
+                        __vseblocks_possLens[K] : __vseblocks_posszLens[K];
+                __vseblocks_runs[c].nsrc = (B)? __vseblocks_possLens[K] : 0;
+        }
+
+        return true;
+}
+
+bool
+__vseblocks_setup_avx512(void)
+{
+        if (!AVX512Unpack::available())
+                return false;
+
+        __vseblocks_permute = __vseblocks_permute_avx512;
+
+        return true;
+}
+
+/*
+ * A run is copied with 16 integers regardless of its length, so that
+ * no branch is taken per descriptor except for 32 zeros. Zeros are
+ * taken from __vseblocks_zeros, and the rest are over-written later.
+ */
+static inline void __attribute__((always_inline))
+__vseblocks_run_sse2(uint32_t **src, uint32_t *&out, uint32_t c)
+{
+        uint32_t        *s;
+
+        s = src[c >> VSEBLOCKS_LOGLEN];
+        __vseblocks_copy16(s, out);
+
+        if (__unlikely(__vseblocks_runs[c].nout > 16))
+                __vseblocks_copy16(__vseblocks_zeros, (out + 16));
+
+        src[c >> VSEBLOCKS_LOGLEN] += __vseblocks_runs[c].nsrc;
+        out += __vseblocks_runs[c].nout;
+}
+
+void
+__vseblocks_permute_sse2(uint32_t *desc,
+                uint32_t **pblk, uint32_t *out, uint32_t *end)
+{
+        uint32_t        d;
+        uint32_t        *src[VSEBLOCKS_NBUCKETS];
+
+        memcpy(src, pblk, sizeof(src));
+        src[0] = __vseblocks_zeros;
+
+        do {
+                d = *desc++;
+
+                __vseblocks_run_sse2(src, out, d >> (VSEBLOCKS_LOGDESC * 3));
+                __vseblocks_run_sse2(src, out, (d >> (VSEBLOCKS_LOGDESC * 2)) & 0xff);
+                __vseblocks_run_sse2(src, out, (d >> VSEBLOCKS_LOGDESC) & 0xff);
+                __vseblocks_run_sse2(src, out, d & 0xff);
+        } while (end > out);
+
+        memcpy(pblk + 1, src + 1, sizeof(src) - sizeof(src[0]));
+}
+
+/* The same as above, but 16 integers are copied in a vector */
+static inline void __attribute__((always_inline)) __avx512_target
+__vseblocks_run_avx512(uint32_t **src, uint32_t *&out, uint32_t c)
+{
+        __m512i         v;
+
+        v = _mm512_loadu_si512(src[c >> VSEBLOCKS_LOGLEN]);
+        _mm512_storeu_si512(out, v);
+
+        if (__unlikely(__vseblocks_runs[c].nout > 16))
+                _mm512_storeu_si512(out + 16, _mm512_setzero_si512());
+
+        src[c >> VSEBLOCKS_LOGLEN] += __vseblocks_runs[c].nsrc;
+        out += __vseblocks_runs[c].nout;
+}
+
+void
+__vseblocks_permute_avx512(uint32_t *desc,
+                uint32_t **pblk, uint32_t *out, uint32_t *end)
+{
+        uint32_t        d;
+        uint32_t        *src[VSEBLOCKS_NBUCKETS];
+
+        memcpy(src, pblk, sizeof(src));
+        src[0] = __vseblocks_zeros;
+
+        do {
+                d = *desc++;
+
+                __vseblocks_run_avx512(src, out, d >> (VSEBLOCKS_LOGDESC * 3));
+                __vseblocks_run_avx512(src, out, (d >> (VSEBLOCKS_LOGDESC * 2)) & 0xff);
+                __vseblocks_run_avx512(src, out, (d >> VSEBLOCKS_LOGDESC) & 0xff);
+                __vseblocks_run_avx512(src, out, d & 0xff);
+        } while (end > out);
+
+        memcpy(pblk + 1, src + 1, sizeof(src) - sizeof(src[0]));
+}
+
+template <uint32_t B>
+void
+__vseblocks_unpack_bmi2(uint32_t *out, uint32_t *in, uint32_t bs)
+{
+        for (uint32_t i = 0; i < bs; i += 32, out += 32, in += B)
+                BMI2Unpack::unpack32<B>(out, in, 0);
+}
+
 void
 __vseblocks_unpack1(uint32_t *out, uint32_t *in, uint32_t bs)
 {
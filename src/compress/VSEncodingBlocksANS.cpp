@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------------
+ *  VSEncodingBlocksANS.cpp - VSEncodingBlocks with rANS-coded descriptors.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/VSEncodingBlocksANS.hpp"
+
+/* The max # of words for 8-bit descriptors in a block */
+#define VSEANS_DESCLEN          (VSENCODING_BLOCKSZ / 4 + 1)
+
+/*
+ * A header has # of words for descriptors in the upper 16 bits, and
+ * # of words coded with RANS in the lower, or 0 if they are not coded.
+ */
+#define __vseans_header(nd, na) (((nd) << 16) | (na))
+
+/* Lists up to this length are decoded with a scratch area on a stack */
+#define VSEANS_STACKLEN         4096
+
+static uint32_t *__vseans_tmp = new uint32_t[VSENCODING_BLOCKSZ * 2 + TAIL_MERGIN];
+static uint32_t *__vseans_ans = new uint32_t[__rans_bound(4 * VSEANS_DESCLEN)];
+static uint32_t *__vseans_desc = new uint32_t[VSEANS_DESCLEN + TAIL_MERGIN];
+
+/*
+ * Decoding costs as VSEncodingBlocks, but a partition costs more for
+ * decoding its descriptor with RANS. They are measured by test/partbench.
+ */
+static double __vseans_partNs = 6.152;
+
+static double __vseans_intNs[] = {
+        0.843, 0.831, 0.811, 0.509, 0.781, 0.541, 0.881, 0.611,
+        0.656, 0.637, 1.035, 0.639, 0.848, 0.651, 0.991, 0.341
+};
+
+void
+VSEncodingBlocksANS::encodeVS(uint32_t len,
+                uint32_t *in, uint32_t &size, uint32_t *out)
+{
+        uint32_t        i;
+        uint32_t        nd;
+        uint32_t        na;
+        uint32_t        off;
+        uint32_t        csize;
+
+        VSEncodingBlocks::encodeVS(len, in, csize, __vseans_tmp);
+
+        off = VSEncodingBlocks::descOffset(__vseans_tmp);
+        nd = csize - off;
+
+        __assert(nd <= VSEANS_DESCLEN);
+
+        /* Descriptors are packed from MSB, so they are byte-swapped */
+        for (i = 0; i < nd; i++)
+                __vseans_desc[i] = __builtin_bswap32(__vseans_tmp[off + i]);
+
+        RANS::encode((uint8_t *)__vseans_desc, 4 * nd, __vseans_ans, na);
+
+        if (na < nd) {
+                *out++ = __vseans_header(nd, na);
+                memcpy(out, __vseans_ans, na * sizeof(uint32_t));
+                out += na;
+        } else {
+                *out++ = __vseans_header(nd, 0);
+                memcpy(out, __vseans_tmp + off, nd * sizeof(uint32_t));
+                out += nd;
+                na = nd;
+        }
+
+        /* Integers follow them as they are */
+        memcpy(out, __vseans_tmp, off * sizeof(uint32_t));
+
+        size = 1 + na + off;
+}
+
+void
+VSEncodingBlocksANS::decodeVS(uint32_t len,
+                uint32_t *in, uint32_t *out, uint32_t *aux)
+{
+        uint32_t        i;
+        uint32_t        nd;
+        uint32_t        na;
+        uint32_t        *desc;
+
+        nd = *in >> 16;
+        na = *in++ & 0xffff;
+
+        if (na == 0) {
+                VSEncodingBlocks::decodeVS(len, in + nd, in, out, aux);
+                return;
+        }
+
+        /* Descriptors are decoded after buckets */
+        desc = aux + __vseblocks_auxlen(len);
+
+        RANS::decode(in, (uint8_t *)desc, 4 * nd);
+
+        for (i = 0; i < nd; i++)
+                desc[i] = __builtin_bswap32(desc[i]);
+
+        VSEncodingBlocks::decodeVS(len, in + na, desc, out, aux);
+}
+
+void
+VSEncodingBlocksANS::setDecodeCost(double lambda)
+{
+        VSEncodingBlocks::setDecodeCost(lambda,
+                        __vseans_partNs, __vseans_intNs);
+}
+
+void
+VSEncodingBlocksANS::encodeArray(uint32_t *in,
+                uint32_t len, uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        res;
+        uint32_t        *lin;
+        uint32_t        *lout;
+        uint32_t        csize;
+
+        for (nvalue = 0, res = len, lin = in, lout = out;
+                        res > VSENCODING_BLOCKSZ;
+                        res -= VSENCODING_BLOCKSZ, lin += VSENCODING_BLOCKSZ,
+                        lout += csize, nvalue += csize + 1) {
+                encodeVS(VSENCODING_BLOCKSZ, lin, csize, lout + 1);
+                *lout++ = csize;
+        }
+
+        encodeVS(res, lin, csize, lout);
+        nvalue += csize;
+}
+
+void
+VSEncodingBlocksANS::decodeArray(uint32_t *in,
+                uint32_t len, uint32_t *out, uint32_t nvalue)
+{
+        uint32_t        n;
+        uint32_t        res;
+        uint32_t        sum;
+        uint32_t        *aux;
+        uint32_t        stk[__vseans_auxlen(VSEANS_STACKLEN)];
+
+        __validate(in, (len << 2));
+        __validate(out, ((nvalue + TAIL_MERGIN) << 2));
+
+        /* A scratch area per call, so that threads decode lists at once */
+        n = (nvalue < VSENCODING_BLOCKSZ)? nvalue : VSENCODING_BLOCKSZ;
+        aux = (n <= VSEANS_STACKLEN)? stk : new uint32_t[__vseans_auxlen(n)];
+
+        if (aux == NULL)
+                eoutput("Can't allocate memory");
+
+        for (res = nvalue; res > VSENCODING_BLOCKSZ;
+                        out += VSENCODING_BLOCKSZ, in += sum,
+                        res -= VSENCODING_BLOCKSZ) {
+                sum = *in++;
+                decodeVS(VSENCODING_BLOCKSZ, in, out, aux);
+        }
+
+        decodeVS(res, in, out, aux);
+
+        if (aux != stk)
+                delete[] aux;
+}
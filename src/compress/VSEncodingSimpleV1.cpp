@@ -25,6 +25,9 @@
 #define VSESIMPLEV1_LOGS_LEN    (1 << VSESIMPLEV1_LOGLOG)
 #define VSESIMPLEV1_LEN         (1 << VSESIMPLEV1_LOGDESC)
 
+/* The max length of partitions */
+#define VSESIMPLEV1_MAXLEN      64
+
 /* A set of unpacking functions */
 
 /* --- UNPACK 0 --- */
@@ -738,6 +741,16 @@ static uint32_t __vsesimplev1_codeLogs[] = {
         15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15
 };
 
+static uint32_t __vsesimplev1_possLogs[] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 16, 20, 32
+};
+
+static uint32_t __vsesimplev1_desc(uint32_t *in, uint32_t p,
+                uint32_t &B, uint32_t &K);
+static void __vsesimplev1_seek(uint32_t *in, uint32_t *idx, uint32_t isize,
+                uint32_t i, uint32_t &p, uint32_t &cnt, uint32_t &off);
+static uint32_t __vsesimplev1_nparts(uint32_t *in, uint32_t nvalue);
+
 #ifdef USE_BOOST_SHAREDPTR
  static VSEncodingPtr __vsesimplev1 =
                 VSEncodingPtr(new VSEncoding(&__vsesimplev1_possLens[0],
@@ -748,6 +761,17 @@ static uint32_t __vsesimplev1_codeLogs[] = {
                 NULL, VSESIMPLEV1_LENS_LEN, true);
 #endif /* USE_BOOST_SHAREDPTR */
 
+/*
+ * Decoding costs in ns of a partition and an integer per width in
+ * __vsesimplev1_possLogs[], which are measured by test/partbench.
+ */
+static double __vsesimplev1_partNs = 1.957;
+
+static double __vsesimplev1_intNs[] = {
+        0.536, 0.562, 0.529, 0.605, 0.485, 0.599, 0.582, 0.661,
+        0.427, 0.767, 0.646, 0.697, 0.613, 0.406, 0.744, 0.209
+};
+
 void
 VSEncodingSimpleV1::encodeArray(uint32_t *in, uint32_t len,
                 uint32_t *out, uint32_t &nvalue)
@@ -862,8 +886,313 @@ VSEncodingSimpleV1::decodeArray(uint32_t *in, uint32_t len,
         } while (end > out);
 }
 
+uint32_t *
+VSEncodingSimpleV1::buildIndex(uint32_t *in,
+                uint32_t nvalue, uint32_t &isize)
+{
+        uint32_t        p;
+        uint32_t        B;
+        uint32_t        K;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        *idx;
+
+        idx = new uint32_t[2 * int_utils::div_roundup(nvalue, VSESIMPLEV1_SAMPLING) + 2];
+
+        if (idx == NULL)
+                eoutput("Can't allocate memory");
+
+        for (p = 0, cnt = 0, off = 0, isize = 0; cnt < nvalue; p++) {
+                if (p % VSESIMPLEV1_SAMPLING == 0) {
+                        idx[isize++] = cnt;
+                        idx[isize++] = off;
+                }
+
+                __vsesimplev1_desc(in, p, B, K);
+
+                cnt += K;
+                off += int_utils::div_roundup(K * B, 32);
+        }
+
+        return idx;
+}
+
+uint32_t
+VSEncodingSimpleV1::get(uint32_t *in,
+                uint32_t *idx, uint32_t isize, uint32_t i)
+{
+        uint32_t        p;
+        uint32_t        B;
+        uint32_t        K;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        sh;
+        uint32_t        *data;
+        uint64_t        v;
+
+        __vsesimplev1_seek(in, idx, isize, i, p, cnt, off);
+        __vsesimplev1_desc(in, p, B, K);
+
+        if (B == 0)
+                return 0;
+
+        /* Integers are packed from MSB */
+        data = in + *in + 1 + off + (((i - cnt) * B) >> 5);
+        sh = ((i - cnt) * B) & 31;
+
+        v = (uint64_t)data[0] << 32;
+
+        if (sh + B > 32)
+                v |= data[1];
+
+        return (v << sh) >> (64 - B);
+}
+
+void
+VSEncodingSimpleV1::decodeRange(uint32_t *in, uint32_t *idx,
+                uint32_t isize, uint32_t i, uint32_t j, uint32_t *out)
+{
+        uint32_t        p;
+        uint32_t        B;
+        uint32_t        K;
+        uint32_t        d;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        s;
+        uint32_t        e;
+        uint32_t        *data;
+        uint32_t        *pout;
+        uint32_t        buf[VSESIMPLEV1_MAXLEN + TAIL_MERGIN];
+
+        if (i >= j)
+                return;
+
+        __vsesimplev1_seek(in, idx, isize, i, p, cnt, off);
+
+        data = in + *in + 1 + off;
+
+        for (; cnt < j; cnt += K, p++) {
+                d = __vsesimplev1_desc(in, p, B, K);
+
+                /* Partitions are unpacked into a buffer, and copied */
+                pout = buf;
+                (__vsesimplev1_unpack[d])(&pout, &data);
+
+                s = (i > cnt)? i - cnt : 0;
+                e = (j < cnt + K)? j - cnt : K;
+
+                memcpy(out, buf + s, (e - s) * sizeof(uint32_t));
+                out += e - s;
+        }
+}
+
+uint32_t
+VSEncodingSimpleV1::decodeBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data, uint32_t *out)
+{
+        uint32_t        k;
+        uint32_t        B;
+        uint32_t        K;
+        uint32_t        d;
+        uint32_t        *pout;
+
+        if (p == 0)
+                data = in + *in + 1;
+
+        for (k = 0; k < n && k < rest; k += K, p++) {
+                d = __vsesimplev1_desc(in, p, B, K);
+
+                pout = out + k;
+                (__vsesimplev1_unpack[d])(&pout, &data);
+        }
+
+        return (k < rest)? k : rest;
+}
+
+void
+VSEncodingSimpleV1::setDecodeCost(double lambda)
+{
+        setDecodeCost(lambda, __vsesimplev1_partNs, __vsesimplev1_intNs);
+}
+
+void
+VSEncodingSimpleV1::setDecodeCost(double lambda, double partNs, double *intNs)
+{
+        __vsesimplev1->setDecodeCost(lambda, partNs, intNs,
+                        __vsesimplev1_possLogs, VSESIMPLEV1_LOGS_LEN);
+}
+
+void
+VSEncodingSimpleV1::setFastPartition(bool fast)
+{
+        __vsesimplev1->setFastMode(fast);
+}
+
+/*
+ * A last partition of A is encoded again with val, and codewords of the
+ * others in A and B are copied as VSEncodingSimpleV2 does, where each
+ * descriptor of 8 bits is copied.
+ */
+uint64_t
+VSEncodingSimpleV1::mergeArray(uint32_t *inA, uint32_t lenA, uint32_t numA,
+                uint32_t val,
+                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        p;
+        uint32_t        q;
+        uint32_t        B;
+        uint32_t        K;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        ntail;
+        uint32_t        lenT;
+        uint32_t        pT;
+        uint32_t        pB;
+        uint32_t        pos;
+        uint32_t        *data;
+        uint32_t        *cd;
+        uint32_t        tail[VSESIMPLEV1_MAXLEN + 1 + TAIL_MERGIN];
+        uint32_t        cmpT[__cmp_bound(VSESIMPLEV1_MAXLEN + 1)];
+        BitsWriter      *ds_wt;
+
+        /* Find a last partition of A by descriptors */
+        for (p = 0, cnt = 0, off = 0; cnt < numA; p++) {
+                __vsesimplev1_desc(inA, p, B, K);
+
+                if (cnt + K >= numA)
+                        break;
+
+                cnt += K;
+                off += int_utils::div_roundup(K * B, 32);
+        }
+
+        ntail = numA - cnt;
+
+        if (ntail > 0) {
+                q = p;
+                data = inA + inA[0] + 1 + off;
+                VSEncodingSimpleV1::decodeBlock(inA, 1, ntail, q, data, tail);
+        }
+
+        tail[ntail] = val;
+        VSEncodingSimpleV1::encodeArray(tail, ntail + 1, cmpT, lenT);
+
+        pT = __vsesimplev1_nparts(cmpT, ntail + 1);
+        pB = __vsesimplev1_nparts(inB, numB);
+
+        pos = int_utils::div_roundup(p + pT + pB, 32 / VSESIMPLEV1_LOGDESC);
+        out[0] = pos;
+
+        ds_wt = new BitsWriter(out + 1);
+
+        if (ds_wt == NULL)
+                eoutput("Can't initialize a class");
+
+        ds_wt->bit_copy(inA + 1, p * VSESIMPLEV1_LOGDESC);
+        ds_wt->bit_copy(cmpT + 1, pT * VSESIMPLEV1_LOGDESC);
+        ds_wt->bit_copy(inB + 1, pB * VSESIMPLEV1_LOGDESC);
+        ds_wt->bit_flush();
+
+        /* Codewords follow descriptors */
+        cd = out + pos + 1;
+
+        if (off > 0) {
+                memcpy(cd, inA + inA[0] + 1, off * sizeof(uint32_t));
+                cd += off;
+        }
+
+        memcpy(cd, cmpT + cmpT[0] + 1, (lenT - cmpT[0] - 1) * sizeof(uint32_t));
+        cd += lenT - cmpT[0] - 1;
+
+        if (pB > 0) {
+                memcpy(cd, inB + inB[0] + 1,
+                                (lenB - inB[0] - 1) * sizeof(uint32_t));
+                cd += lenB - inB[0] - 1;
+        }
+
+        nvalue = cd - out;
+
+        delete ds_wt;
+
+        return ntail + 1;
+}
+
 /* --- Intra functions below --- */
 
+/* Return bits and the length of the p-th partition with its descriptor */
+uint32_t
+__vsesimplev1_desc(uint32_t *in, uint32_t p, uint32_t &B, uint32_t &K)
+{
+        uint32_t        d;
+
+        d = (in[1 + (p >> 2)] >> (VSESIMPLEV1_LOGDESC * (3 - (p & 3)))) &
+                (VSESIMPLEV1_LEN - 1);
+
+        B = __vsesimplev1_possLogs[d >> VSESIMPLEV1_LOGLEN];
+        K = __vsesimplev1_possLens[d & (VSESIMPLEV1_LENS_LEN - 1)];
+
+        return d;
+}
+
+/* # of partitions in a list of nvalue integers */
+uint32_t
+__vsesimplev1_nparts(uint32_t *in, uint32_t nvalue)
+{
+        uint32_t        p;
+        uint32_t        B;
+        uint32_t        K;
+        uint32_t        cnt;
+
+        for (p = 0, cnt = 0; cnt < nvalue; p++) {
+                __vsesimplev1_desc(in, p, B, K);
+                cnt += K;
+        }
+
+        return p;
+}
+
+/*
+ * Find the partition p that the i-th integer falls into, and return
+ * the number of integers and the offset of data preceding it.
+ */
+void
+__vsesimplev1_seek(uint32_t *in, uint32_t *idx, uint32_t isize,
+                uint32_t i, uint32_t &p, uint32_t &cnt, uint32_t &off)
+{
+        uint32_t        lo;
+        uint32_t        hi;
+        uint32_t        mid;
+        uint32_t        B;
+        uint32_t        K;
+
+        /* Find the last sample not exceeding i */
+        for (lo = 0, hi = isize / 2 - 1; lo < hi; ) {
+                mid = (lo + hi + 1) >> 1;
+
+                if (idx[2 * mid] <= i)
+                        lo = mid;
+                else
+                        hi = mid - 1;
+        }
+
+        p = lo * VSESIMPLEV1_SAMPLING;
+        cnt = idx[2 * lo];
+        off = idx[2 * lo + 1];
+
+        /* Then, scan descriptors from the sample */
+        while (1) {
+                __vsesimplev1_desc(in, p, B, K);
+
+                if (i < cnt + K)
+                        break;
+
+                cnt += K;
+                off += int_utils::div_roundup(K * B, 32);
+                p++;
+        }
+}
+
 /* --- UNPACK 0 --- */
 void
 __vsesimplev1_unpack0_1(uint32_t **out, uint32_t **in)
@@ -5356,7 +5685,7 @@ __vsesimplev1_unpack10_12(uint32_t **out, uint32_t **in)
         pout[10] = (pin[3] >> 18) & 0x03ff;
         pout[11] = (pin[3] >> 8) & 0x03ff;
 
-        *in = pin + 3;
+        *in = pin + 4;
         *out = pout + 12;
 }
 
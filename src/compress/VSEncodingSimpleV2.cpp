@@ -24,53 +24,124 @@
 #define VSESIMPLEV2_LOGS_LEN    (1 << VSESIMPLEV2_LOGLOG)
 
 /* A set of unpacking functions */
-static inline void __vsesimplev2_unpack0(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack0(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack1(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack1(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack2(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack2(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack3(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack3(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack4(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack4(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack5(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack5(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack6(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack6(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack7(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack7(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack8(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack8(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack9(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack9(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack10(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack10(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack11(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack11(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack12(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack12(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack16(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack16(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack20(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack20(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
-static inline void __vsesimplev2_unpack32(uint32_t **out, uint32_t **in, uint32_t len)
+template <class T>
+static inline void __vsesimplev2_unpack32(T **out, uint32_t **in, uint32_t len)
         __attribute__((always_inline));
+template <class T>
+static inline void __vsesimplev2_unpack64(T **out, uint32_t **in, uint32_t len)
+        __attribute__((always_inline));
+
+/* 32-bit integers are zero-filled or copied with SSE2 */
+template <>
+void __vsesimplev2_unpack0<uint32_t>(uint32_t **out, uint32_t **in, uint32_t len);
+template <>
+void __vsesimplev2_unpack32<uint32_t>(uint32_t **out, uint32_t **in, uint32_t len);
 
-/* A interface of unpacking functions above */
-typedef void (*__vsesimplev2_unpacker)(uint32_t **out, uint32_t **in, uint32_t len);
-
-static __vsesimplev2_unpacker       __vsesimplev2_unpack[] = {
-        __vsesimplev2_unpack0, __vsesimplev2_unpack1,
-        __vsesimplev2_unpack2, __vsesimplev2_unpack3,
-        __vsesimplev2_unpack4, __vsesimplev2_unpack5,
-        __vsesimplev2_unpack6, __vsesimplev2_unpack7,
-        __vsesimplev2_unpack8, __vsesimplev2_unpack9,
-        __vsesimplev2_unpack10, __vsesimplev2_unpack11,
-        __vsesimplev2_unpack12, __vsesimplev2_unpack16,
-        __vsesimplev2_unpack20, __vsesimplev2_unpack32
+/*
+ * A interface of unpacking functions above. For 64-bit integers,
+ * the last two codes of B are assigned to 32 and 64 bits.
+ */
+template <class T>
+struct __vsesimplev2_unpacker {
+        typedef void (*unpacker)(T **out, uint32_t **in, uint32_t len);
+
+        static unpacker         unpack[VSESIMPLEV2_LOGS_LEN];
 };
 
+template <>
+__vsesimplev2_unpacker<uint32_t>::unpacker
+                __vsesimplev2_unpacker<uint32_t>::unpack[VSESIMPLEV2_LOGS_LEN] = {
+        __vsesimplev2_unpack0<uint32_t>, __vsesimplev2_unpack1<uint32_t>,
+        __vsesimplev2_unpack2<uint32_t>, __vsesimplev2_unpack3<uint32_t>,
+        __vsesimplev2_unpack4<uint32_t>, __vsesimplev2_unpack5<uint32_t>,
+        __vsesimplev2_unpack6<uint32_t>, __vsesimplev2_unpack7<uint32_t>,
+        __vsesimplev2_unpack8<uint32_t>, __vsesimplev2_unpack9<uint32_t>,
+        __vsesimplev2_unpack10<uint32_t>, __vsesimplev2_unpack11<uint32_t>,
+        __vsesimplev2_unpack12<uint32_t>, __vsesimplev2_unpack16<uint32_t>,
+        __vsesimplev2_unpack20<uint32_t>, __vsesimplev2_unpack32<uint32_t>
+};
+
+template <>
+__vsesimplev2_unpacker<uint64_t>::unpacker
+                __vsesimplev2_unpacker<uint64_t>::unpack[VSESIMPLEV2_LOGS_LEN] = {
+        __vsesimplev2_unpack0<uint64_t>, __vsesimplev2_unpack1<uint64_t>,
+        __vsesimplev2_unpack2<uint64_t>, __vsesimplev2_unpack3<uint64_t>,
+        __vsesimplev2_unpack4<uint64_t>, __vsesimplev2_unpack5<uint64_t>,
+        __vsesimplev2_unpack6<uint64_t>, __vsesimplev2_unpack7<uint64_t>,
+        __vsesimplev2_unpack8<uint64_t>, __vsesimplev2_unpack9<uint64_t>,
+        __vsesimplev2_unpack10<uint64_t>, __vsesimplev2_unpack11<uint64_t>,
+        __vsesimplev2_unpack12<uint64_t>, __vsesimplev2_unpack16<uint64_t>,
+        __vsesimplev2_unpack32<uint64_t>, __vsesimplev2_unpack64<uint64_t>
+};
+
+/*
+ * Unpacking functions for odd widths with BMI2, and they take over
+ * the ones above for 32-bit integers if available.
+ */
+template <uint32_t B>
+static void __vsesimplev2_unpack_bmi2(uint32_t **out, uint32_t **in, uint32_t len)
+        __bmi2_target;
+
+static bool __vsesimplev2_setup_bmi2(void);
+static bool __vsesimplev2_bmi2 __attribute__((unused)) = __vsesimplev2_setup_bmi2();
+
+/*
+ * Unpacking functions with AVX-512 for all the widths below 32, and
+ * they take over the ones above for 32-bit integers if available.
+ * They write exactly len integers in partitions of any length.
+ */
+template <uint32_t B>
+static void __vsesimplev2_unpack_avx512(uint32_t **out, uint32_t **in, uint32_t len)
+        __avx512_target;
+
+static bool __vsesimplev2_setup_avx512(void);
+static bool __vsesimplev2_avx512 __attribute__((unused)) = __vsesimplev2_setup_avx512();
+
 static uint32_t __vsesimplev2_possLens[] = {
         1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
         17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
@@ -102,6 +173,31 @@ static uint32_t __vsesimplev2_codeLogs[] = {
         15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15
 };
 
+/* Tables for 64-bit integers */
+static uint32_t __vsesimplev2_remapLogs64[] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 16, 16, 16, 16,
+        32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+        64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+        64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64
+};
+
+static uint32_t __vsesimplev2_codeLogs64[] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 13, 13, 13,
+        14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14,
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15
+};
+
+static uint32_t __vsesimplev2_possLogs[] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 16, 20, 32
+};
+
+static void __vsesimplev2_desc(uint32_t *in, uint32_t p,
+                uint32_t &C, uint32_t &K);
+static void __vsesimplev2_seek(uint32_t *in, uint32_t *idx, uint32_t isize,
+                uint32_t i, uint32_t &p, uint32_t &cnt, uint32_t &off);
+static uint32_t __vsesimplev2_nparts(uint32_t *in, uint32_t nvalue);
+
 #ifdef USE_BOOST_SHAREDPTR
  static VSEncodingPtr __vsesimplev2 =
                 VSEncodingPtr(new VSEncoding(&__vsesimplev2_possLens[0],
@@ -112,8 +208,20 @@ static uint32_t __vsesimplev2_codeLogs[] = {
                 NULL, VSESIMPLEV2_LENS_LEN, true);
 #endif /* USE_BOOST_SHAREDPTR */
 
+/*
+ * Decoding costs in ns of a partition and an integer per width in
+ * __vsesimplev2_possLogs[], which are measured by test/partbench.
+ */
+static double __vsesimplev2_partNs = 6.319;
+
+static double __vsesimplev2_intNs[] = {
+        0.176, 0.183, 0.146, 0.183, 0.161, 0.170, 0.153, 0.202,
+        0.153, 0.185, 0.162, 0.207, 0.156, 0.155, 0.157, 0.911
+};
+
+template <class T>
 void
-VSEncodingSimpleV2::encodeArray(uint32_t *in, uint32_t len,
+VSEncodingSimpleV2::encode(T *in, uint32_t len,
                 uint32_t *out, uint32_t &nvalue)
 {
         uint32_t        i;
@@ -124,6 +232,8 @@ VSEncodingSimpleV2::encodeArray(uint32_t *in, uint32_t len,
         uint32_t        maxB;
         uint32_t        *logs;
         uint32_t        *part;
+        uint32_t        *remapLogs;
+        uint32_t        *codeLogs;
         BitsWriter      *ds1_wt;
         BitsWriter      *ds2_wt;
         BitsWriter      *cd_wt;
@@ -133,9 +243,17 @@ VSEncodingSimpleV2::encodeArray(uint32_t *in, uint32_t len,
         if (logs == NULL)
                 eoutput("Can't allocate memory");
 
+        if (sizeof(T) == sizeof(uint32_t)) {
+                remapLogs = __vsesimplev2_remapLogs;
+                codeLogs = __vsesimplev2_codeLogs;
+        } else {
+                remapLogs = __vsesimplev2_remapLogs64;
+                codeLogs = __vsesimplev2_codeLogs64;
+        }
+
         /* Compute logs of all numbers */
         for (i = 0; i < len; i++)
-                logs[i] = __vsesimplev2_remapLogs[1 + int_utils::get_msb(in[i])];
+                logs[i] = remapLogs[1 + int_utils::get_msb(in[i])];
 
         /* Compute optimal partition */
         part = __vsesimplev2->compute_OptPartition(logs, len,
@@ -171,15 +289,19 @@ VSEncodingSimpleV2::encodeArray(uint32_t *in, uint32_t len,
 
                 if (maxB) {
                         /* Write integers */
-                        for (j = part[i]; j < part[i + 1]; j++) 
-                                cd_wt->bit_writer(in[j], maxB);
+                        for (j = part[i]; j < part[i + 1]; j++) {
+                                if (sizeof(T) == sizeof(uint32_t))
+                                        cd_wt->bit_writer(in[j], maxB);
+                                else
+                                        cd_wt->bit_writer64(in[j], maxB);
+                        }
 
                         /* Allign to 32-bit */
                         cd_wt->bit_flush(); 
                 }
 
                 /* Writes the value of B and K */
-                ds1_wt->bit_writer(__vsesimplev2_codeLogs[maxB], VSESIMPLEV2_LOGLOG);
+                ds1_wt->bit_writer(codeLogs[maxB], VSESIMPLEV2_LOGLOG);
 
                 /* Compute the code for the block length.
                  * A original code is below though, it's too slow due to many loops.
@@ -206,16 +328,17 @@ VSEncodingSimpleV2::encodeArray(uint32_t *in, uint32_t len,
         delete cd_wt;
 }
 
+template <class T>
 void
-VSEncodingSimpleV2::decodeArray(uint32_t *in, uint32_t len,
-                uint32_t *out, uint32_t nvalue)
+VSEncodingSimpleV2::decode(uint32_t *in, uint32_t len,
+                T *out, uint32_t nvalue)
 {
         uint32_t        B;
         uint32_t        K;
         uint32_t        *bin;
         uint32_t        *kin;
         uint32_t        *data;
-        uint32_t        *end;
+        T               *end;
 
         bin = in + 2;
         kin = in + *in + 2;
@@ -227,25 +350,25 @@ VSEncodingSimpleV2::decodeArray(uint32_t *in, uint32_t len,
                 B = (*bin) >> 7 * VSESIMPLEV2_LOGLOG;
                 K = (*kin) >> 3 * VSESIMPLEV2_LOGLEN;
 
-                (__vsesimplev2_unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
+                (__vsesimplev2_unpacker<T>::unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
 
                 /* Unpacking integers with a second 4/8-bit */
                 B = ((*bin) >> 6 * VSESIMPLEV2_LOGLOG) & (VSESIMPLEV2_LOGS_LEN - 1);
                 K = ((*kin) >> 2 * VSESIMPLEV2_LOGLEN) & (VSESIMPLEV2_LENS_LEN - 1);
 
-                (__vsesimplev2_unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
+                (__vsesimplev2_unpacker<T>::unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
 
                 /* Unpacking integers with a thrid 4/8-bit */
                 B = ((*bin) >> 5 * VSESIMPLEV2_LOGLOG) & (VSESIMPLEV2_LOGS_LEN - 1);
                 K = ((*kin) >> VSESIMPLEV2_LOGLEN) & (VSESIMPLEV2_LENS_LEN - 1);
 
-                (__vsesimplev2_unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
+                (__vsesimplev2_unpacker<T>::unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
 
                 /* Unpacking integers with a forth 4/8-bit */
                 B = ((*bin) >> 4 * VSESIMPLEV2_LOGLOG) & (VSESIMPLEV2_LOGS_LEN - 1);
                 K = (*kin++) & (VSESIMPLEV2_LENS_LEN - 1);
 
-                (__vsesimplev2_unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
+                (__vsesimplev2_unpacker<T>::unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
 
                 if (end <= out)
                         break;
@@ -254,35 +377,486 @@ VSEncodingSimpleV2::decodeArray(uint32_t *in, uint32_t len,
                 B = ((*bin) >> 3 * VSESIMPLEV2_LOGLOG) & (VSESIMPLEV2_LOGS_LEN - 1);
                 K = (*kin) >> 3 * VSESIMPLEV2_LOGLEN;
 
-                (__vsesimplev2_unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
+                (__vsesimplev2_unpacker<T>::unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
 
                 /* Unpacking integers with a second 4/8-bit */
                 B = ((*bin) >> 2 * VSESIMPLEV2_LOGLOG) & (VSESIMPLEV2_LOGS_LEN - 1);
                 K = ((*kin) >> 2 * VSESIMPLEV2_LOGLEN) & (VSESIMPLEV2_LENS_LEN - 1);
 
-                (__vsesimplev2_unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
+                (__vsesimplev2_unpacker<T>::unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
 
                 /* Unpacking integers with a second 4/8-bit */
                 B = ((*bin) >> VSESIMPLEV2_LOGLOG) & (VSESIMPLEV2_LOGS_LEN - 1);
                 K = ((*kin) >> VSESIMPLEV2_LOGLEN) & (VSESIMPLEV2_LENS_LEN - 1);
 
-                (__vsesimplev2_unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
+                (__vsesimplev2_unpacker<T>::unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
 
                 /* Unpacking integers with a second 4/8-bit */
                 B = (*bin++) & (VSESIMPLEV2_LOGS_LEN - 1);
                 K = (*kin++) & (VSESIMPLEV2_LENS_LEN - 1);
 
-                (__vsesimplev2_unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
+                (__vsesimplev2_unpacker<T>::unpack[B])(&out, &data, __vsesimplev2_possLens[K]);
 
                 if (end <= out)
                         break;
         }
 }
 
+void
+VSEncodingSimpleV2::encodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        VSEncodingSimpleV2::encode(in, len, out, nvalue);
+}
+
+void
+VSEncodingSimpleV2::decodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue)
+{
+        VSEncodingSimpleV2::decode(in, len, out, nvalue);
+}
+
+void
+VSEncodingSimpleV2::encodeArray(uint64_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        VSEncodingSimpleV2::encode(in, len, out, nvalue);
+}
+
+void
+VSEncodingSimpleV2::decodeArray(uint32_t *in, uint32_t len,
+                uint64_t *out, uint32_t nvalue)
+{
+        VSEncodingSimpleV2::decode(in, len, out, nvalue);
+}
+
+uint32_t *
+VSEncodingSimpleV2::buildIndex(uint32_t *in,
+                uint32_t nvalue, uint32_t &isize)
+{
+        uint32_t        p;
+        uint32_t        C;
+        uint32_t        K;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        *idx;
+
+        idx = new uint32_t[2 * int_utils::div_roundup(nvalue, VSESIMPLEV2_SAMPLING) + 2];
+
+        if (idx == NULL)
+                eoutput("Can't allocate memory");
+
+        for (p = 0, cnt = 0, off = 0, isize = 0; cnt < nvalue; p++) {
+                if (p % VSESIMPLEV2_SAMPLING == 0) {
+                        idx[isize++] = cnt;
+                        idx[isize++] = off;
+                }
+
+                __vsesimplev2_desc(in, p, C, K);
+
+                cnt += K;
+                off += int_utils::div_roundup(K * __vsesimplev2_possLogs[C], 32);
+        }
+
+        return idx;
+}
+
+uint32_t
+VSEncodingSimpleV2::get(uint32_t *in,
+                uint32_t *idx, uint32_t isize, uint32_t i)
+{
+        uint32_t        p;
+        uint32_t        B;
+        uint32_t        C;
+        uint32_t        K;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        sh;
+        uint32_t        *data;
+        uint64_t        v;
+
+        __vsesimplev2_seek(in, idx, isize, i, p, cnt, off);
+        __vsesimplev2_desc(in, p, C, K);
+
+        B = __vsesimplev2_possLogs[C];
+
+        if (B == 0)
+                return 0;
+
+        /* Integers are packed from MSB */
+        data = in + *(in + 1) + 2 + off + (((i - cnt) * B) >> 5);
+        sh = ((i - cnt) * B) & 31;
+
+        v = (uint64_t)data[0] << 32;
+
+        if (sh + B > 32)
+                v |= data[1];
+
+        return (v << sh) >> (64 - B);
+}
+
+void
+VSEncodingSimpleV2::decodeRange(uint32_t *in, uint32_t *idx,
+                uint32_t isize, uint32_t i, uint32_t j, uint32_t *out)
+{
+        uint32_t        p;
+        uint32_t        C;
+        uint32_t        K;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        s;
+        uint32_t        e;
+        uint32_t        *data;
+        uint32_t        *pout;
+        uint32_t        buf[VSESIMPLEV2_LENS_LEN + TAIL_MERGIN];
+
+        if (i >= j)
+                return;
+
+        __vsesimplev2_seek(in, idx, isize, i, p, cnt, off);
+
+        data = in + *(in + 1) + 2 + off;
+
+        for (; cnt < j; cnt += K, p++) {
+                __vsesimplev2_desc(in, p, C, K);
+
+                /* Partitions are unpacked into a buffer, and copied */
+                pout = buf;
+                (__vsesimplev2_unpacker<uint32_t>::unpack[C])(&pout, &data, K);
+
+                s = (i > cnt)? i - cnt : 0;
+                e = (j < cnt + K)? j - cnt : K;
+
+                memcpy(out, buf + s, (e - s) * sizeof(uint32_t));
+                out += e - s;
+        }
+}
+
+uint32_t
+VSEncodingSimpleV2::decodeBlock(uint32_t *in, uint32_t n, uint32_t rest,
+                uint32_t &p, uint32_t *&data, uint32_t *out)
+{
+        uint32_t        k;
+        uint32_t        C;
+        uint32_t        K;
+        uint32_t        *pout;
+
+        if (p == 0)
+                data = in + *(in + 1) + 2;
+
+        for (k = 0; k < n && k < rest; k += K, p++) {
+                __vsesimplev2_desc(in, p, C, K);
+
+                pout = out + k;
+                (__vsesimplev2_unpacker<uint32_t>::unpack[C])(&pout, &data, K);
+        }
+
+        return (k < rest)? k : rest;
+}
+
+void
+VSEncodingSimpleV2::setDecodeCost(double lambda)
+{
+        setDecodeCost(lambda, __vsesimplev2_partNs, __vsesimplev2_intNs);
+}
+
+void
+VSEncodingSimpleV2::setDecodeCost(double lambda, double partNs, double *intNs)
+{
+        __vsesimplev2->setDecodeCost(lambda, partNs, intNs,
+                        __vsesimplev2_possLogs, VSESIMPLEV2_LOGS_LEN);
+}
+
+void
+VSEncodingSimpleV2::setFastPartition(bool fast)
+{
+        __vsesimplev2->setFastMode(fast);
+}
+
+/*
+ * A last partition of A is encoded again with val, and codewords of the
+ * others in A and B are copied. Descriptors of A, the tail, and B are
+ * copied into the new arrays of descriptors, 12 bits a partition.
+ */
+uint64_t
+VSEncodingSimpleV2::mergeArray(uint32_t *inA, uint32_t lenA, uint32_t numA,
+                uint32_t val,
+                uint32_t *inB, uint32_t lenB, uint32_t numB,
+                uint32_t *out, uint32_t &nvalue)
+{
+        uint32_t        p;
+        uint32_t        q;
+        uint32_t        C;
+        uint32_t        K;
+        uint32_t        cnt;
+        uint32_t        off;
+        uint32_t        ntail;
+        uint32_t        lenT;
+        uint32_t        pT;
+        uint32_t        pB;
+        uint32_t        nP;
+        uint32_t        pos1;
+        uint32_t        pos2;
+        uint32_t        *data;
+        uint32_t        *cd;
+        uint32_t        tail[VSESIMPLEV2_LENS_LEN + 1 + TAIL_MERGIN];
+        uint32_t        cmpT[__cmp_bound(VSESIMPLEV2_LENS_LEN + 1)];
+        BitsWriter      *ds1_wt;
+        BitsWriter      *ds2_wt;
+
+        /* Find a last partition of A by descriptors */
+        for (p = 0, cnt = 0, off = 0; cnt < numA; p++) {
+                __vsesimplev2_desc(inA, p, C, K);
+
+                if (cnt + K >= numA)
+                        break;
+
+                cnt += K;
+                off += int_utils::div_roundup(K * __vsesimplev2_possLogs[C], 32);
+        }
+
+        ntail = numA - cnt;
+
+        if (ntail > 0) {
+                q = p;
+                data = inA + inA[1] + 2 + off;
+                VSEncodingSimpleV2::decodeBlock(inA, 1, ntail, q, data, tail);
+        }
+
+        tail[ntail] = val;
+        VSEncodingSimpleV2::encodeArray(tail, ntail + 1, cmpT, lenT);
+
+        pT = __vsesimplev2_nparts(cmpT, ntail + 1);
+        pB = __vsesimplev2_nparts(inB, numB);
+        nP = p + pT + pB;
+
+        pos1 = int_utils::div_roundup(nP, 32 / VSESIMPLEV2_LOGLOG);
+        pos2 = int_utils::div_roundup(nP, 32 / VSESIMPLEV2_LOGLEN);
+
+        out[0] = pos1;
+        out[1] = pos1 + pos2;
+
+        ds1_wt = new BitsWriter(out + 2);
+        ds2_wt = new BitsWriter(out + pos1 + 2);
+
+        if (ds1_wt == NULL || ds2_wt == NULL)
+                eoutput("Can't initialize a class");
+
+        if (p > 0) {
+                ds1_wt->bit_copy(inA + 2, p * VSESIMPLEV2_LOGLOG);
+                ds2_wt->bit_copy(inA + inA[0] + 2, p * VSESIMPLEV2_LOGLEN);
+        }
+
+        ds1_wt->bit_copy(cmpT + 2, pT * VSESIMPLEV2_LOGLOG);
+        ds2_wt->bit_copy(cmpT + cmpT[0] + 2, pT * VSESIMPLEV2_LOGLEN);
+
+        if (pB > 0) {
+                ds1_wt->bit_copy(inB + 2, pB * VSESIMPLEV2_LOGLOG);
+                ds2_wt->bit_copy(inB + inB[0] + 2, pB * VSESIMPLEV2_LOGLEN);
+        }
+
+        ds1_wt->bit_flush();
+        ds2_wt->bit_flush();
+
+        /* Codewords follow descriptors */
+        cd = out + pos1 + pos2 + 2;
+
+        if (off > 0) {
+                memcpy(cd, inA + inA[1] + 2, off * sizeof(uint32_t));
+                cd += off;
+        }
+
+        memcpy(cd, cmpT + cmpT[1] + 2,
+                        (lenT - cmpT[1] - 2) * sizeof(uint32_t));
+        cd += lenT - cmpT[1] - 2;
+
+        if (pB > 0) {
+                memcpy(cd, inB + inB[1] + 2,
+                                (lenB - inB[1] - 2) * sizeof(uint32_t));
+                cd += lenB - inB[1] - 2;
+        }
+
+        nvalue = cd - out;
+
+        delete ds1_wt;
+        delete ds2_wt;
+
+        return ntail + 1;
+}
+
 /* --- Intra functions below --- */
 
+bool
+__vsesimplev2_setup_bmi2(void)
+{
+        if (!BMI2Unpack::available())
+                return false;
+
+        __vsesimplev2_unpacker<uint32_t>::unpack[3] =
+                __vsesimplev2_unpack_bmi2<3>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[5] =
+                __vsesimplev2_unpack_bmi2<5>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[7] =
+                __vsesimplev2_unpack_bmi2<7>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[9] =
+                __vsesimplev2_unpack_bmi2<9>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[11] =
+                __vsesimplev2_unpack_bmi2<11>;
+
+        return true;
+}
+
+template <uint32_t B>
+void
+__vsesimplev2_unpack_bmi2(uint32_t **out, uint32_t **in, uint32_t len)
+{
+        uint32_t        i;
+        uint32_t        *pin;
+        uint32_t        *pout;
+
+        pin = *in;
+        pout = *out;
+
+        for (i = 0; i < int_utils::div_roundup(len, 32); i++, pout += 32, pin += B)
+                BMI2Unpack::unpack32<B>(pout, pin, 0);
+
+        *in += int_utils::div_roundup(B * len, 32);
+        *out += len;
+}
+
+bool
+__vsesimplev2_setup_avx512(void)
+{
+        if (!AVX512Unpack::available())
+                return false;
+
+        __vsesimplev2_unpacker<uint32_t>::unpack[1] =
+                __vsesimplev2_unpack_avx512<1>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[2] =
+                __vsesimplev2_unpack_avx512<2>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[3] =
+                __vsesimplev2_unpack_avx512<3>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[4] =
+                __vsesimplev2_unpack_avx512<4>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[5] =
+                __vsesimplev2_unpack_avx512<5>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[6] =
+                __vsesimplev2_unpack_avx512<6>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[7] =
+                __vsesimplev2_unpack_avx512<7>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[8] =
+                __vsesimplev2_unpack_avx512<8>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[9] =
+                __vsesimplev2_unpack_avx512<9>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[10] =
+                __vsesimplev2_unpack_avx512<10>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[11] =
+                __vsesimplev2_unpack_avx512<11>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[12] =
+                __vsesimplev2_unpack_avx512<12>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[13] =
+                __vsesimplev2_unpack_avx512<16>;
+        __vsesimplev2_unpacker<uint32_t>::unpack[14] =
+                __vsesimplev2_unpack_avx512<20>;
+
+        return true;
+}
+
+template <uint32_t B>
+void
+__vsesimplev2_unpack_avx512(uint32_t **out, uint32_t **in, uint32_t len)
+{
+        AVX512Unpack::unpack<B>(*out, *in, len);
+
+        *in += int_utils::div_roundup(B * len, 32);
+        *out += len;
+}
+
+/* Return the code of B and the length of the p-th partition */
+void
+__vsesimplev2_desc(uint32_t *in, uint32_t p, uint32_t &C, uint32_t &K)
+{
+        uint32_t        *bin;
+        uint32_t        *kin;
+
+        bin = in + 2;
+        kin = in + *in + 2;
+
+        C = (bin[p >> 3] >> (VSESIMPLEV2_LOGLOG * (7 - (p & 7)))) &
+                (VSESIMPLEV2_LOGS_LEN - 1);
+        K = __vsesimplev2_possLens[(kin[p >> 2] >> (VSESIMPLEV2_LOGLEN *
+                        (3 - (p & 3)))) & (VSESIMPLEV2_LENS_LEN - 1)];
+}
+
+/* # of partitions in a list of nvalue integers */
+uint32_t
+__vsesimplev2_nparts(uint32_t *in, uint32_t nvalue)
+{
+        uint32_t        p;
+        uint32_t        C;
+        uint32_t        K;
+        uint32_t        cnt;
+
+        for (p = 0, cnt = 0; cnt < nvalue; p++) {
+                __vsesimplev2_desc(in, p, C, K);
+                cnt += K;
+        }
+
+        return p;
+}
+
+/*
+ * Find the partition p that the i-th integer falls into, and return
+ * the number of integers and the offset of data preceding it.
+ */
 void
-__vsesimplev2_unpack0(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_seek(uint32_t *in, uint32_t *idx, uint32_t isize,
+                uint32_t i, uint32_t &p, uint32_t &cnt, uint32_t &off)
+{
+        uint32_t        lo;
+        uint32_t        hi;
+        uint32_t        mid;
+        uint32_t        C;
+        uint32_t        K;
+
+        /* Find the last sample not exceeding i */
+        for (lo = 0, hi = isize / 2 - 1; lo < hi; ) {
+                mid = (lo + hi + 1) >> 1;
+
+                if (idx[2 * mid] <= i)
+                        lo = mid;
+                else
+                        hi = mid - 1;
+        }
+
+        p = lo * VSESIMPLEV2_SAMPLING;
+        cnt = idx[2 * lo];
+        off = idx[2 * lo + 1];
+
+        /* Then, scan descriptors from the sample */
+        while (1) {
+                __vsesimplev2_desc(in, p, C, K);
+
+                if (i < cnt + K)
+                        break;
+
+                cnt += K;
+                off += int_utils::div_roundup(K * __vsesimplev2_possLogs[C], 32);
+                p++;
+        }
+}
+
+template <class T>
+void
+__vsesimplev2_unpack0(T **out, uint32_t **in, uint32_t len)
+{
+        memset(*out, 0x00, len * sizeof(T));
+        *out += len;
+}
+
+template <>
+void
+__vsesimplev2_unpack0<uint32_t>(uint32_t **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pout;
@@ -300,11 +874,12 @@ __vsesimplev2_unpack0(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack1(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack1(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
-        uint32_t        *pout;
+        T               *pout;
 
         pout = *out;
 
@@ -346,11 +921,12 @@ __vsesimplev2_unpack1(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack2(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack2(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
-        uint32_t        *pout;
+        T               *pout;
 
         pout = *out;
 
@@ -376,12 +952,13 @@ __vsesimplev2_unpack2(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack3(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack3(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -427,11 +1004,12 @@ __vsesimplev2_unpack3(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack4(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack4(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
-        uint32_t        *pout;
+        T               *pout;
 
         pout = *out;
 
@@ -449,12 +1027,13 @@ __vsesimplev2_unpack4(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack5(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack5(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -502,12 +1081,13 @@ __vsesimplev2_unpack5(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack6(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack6(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -537,12 +1117,13 @@ __vsesimplev2_unpack6(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack7(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack7(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -592,11 +1173,12 @@ __vsesimplev2_unpack7(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack8(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack8(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
-        uint32_t        *pout;
+        T               *pout;
 
         pout = *out;
 
@@ -610,12 +1192,13 @@ __vsesimplev2_unpack8(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack9(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack9(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -667,12 +1250,13 @@ __vsesimplev2_unpack9(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack10(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack10(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -704,12 +1288,13 @@ __vsesimplev2_unpack10(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack11(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack11(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -763,12 +1348,13 @@ __vsesimplev2_unpack11(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack12(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack12(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -790,11 +1376,12 @@ __vsesimplev2_unpack12(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack16(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack16(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
-        uint32_t        *pout;
+        T               *pout;
 
         pout = *out;
 
@@ -806,12 +1393,13 @@ __vsesimplev2_unpack16(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack20(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack20(T **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
-        uint32_t        *pout;
+        T               *pout;
 
         pin = *in;
         pout = *out;
@@ -835,8 +1423,27 @@ __vsesimplev2_unpack20(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+template <class T>
 void
-__vsesimplev2_unpack32(uint32_t **out, uint32_t **in, uint32_t len)
+__vsesimplev2_unpack32(T **out, uint32_t **in, uint32_t len)
+{
+        uint32_t        i;
+        uint32_t        *pin;
+        T               *pout;
+
+        pin = *in;
+        pout = *out;
+
+        for (i = 0; i < len; i++)
+                pout[i] = pin[i];
+
+        *in += len;
+        *out += len;
+}
+
+template <>
+void
+__vsesimplev2_unpack32<uint32_t>(uint32_t **out, uint32_t **in, uint32_t len)
 {
         uint32_t        i;
         uint32_t        *pin;
@@ -858,3 +1465,21 @@ __vsesimplev2_unpack32(uint32_t **out, uint32_t **in, uint32_t len)
         *out += len;
 }
 
+
+template <class T>
+void
+__vsesimplev2_unpack64(T **out, uint32_t **in, uint32_t len)
+{
+        uint32_t        i;
+        uint32_t        *pin;
+        T               *pout;
+
+        pin = *in;
+        pout = *out;
+
+        for (i = 0; i < len; i++, pin += 2)
+                pout[i] = ((T)pin[0] << 32) | pin[1];
+
+        *in += 2 * len;
+        *out += len;
+}
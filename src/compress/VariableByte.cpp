@@ -17,74 +17,31 @@
 #define VARIABLEBYTE_DESC       0x80
 #define VARIABLEBYTE_DATA       (VARIABLEBYTE_DESC - 1)
 
-#define VARIABLEBYTE_EXT7BITS(value, num)         (value >> (7 * num)) & 0x7f
+#define VARIABLEBYTE_EXT7BITS(value, num)         ((value) >> (7 * (num))) & 0x7f
 
+template <class T>
 void
-VariableByte::encodeArray(uint32_t *in, uint32_t len,
+VariableByte::encode(T *in, uint32_t len,
                 uint32_t *out, uint32_t &nvalue)
 {
         uint32_t        i;
+        uint32_t        j;
         uint32_t        nwords;
         BitsWriter      *wt;
 
         wt = new BitsWriter(out);
 
-        uint32_t t;
-
         for (i = 0; i < len; i++) {
                 nwords = int_utils::get_msb(in[i]) / 7;
 
-                switch(nwords) {
-                case 0:
-                        wt->bit_writer(1, 1);
-                        t = VARIABLEBYTE_EXT7BITS(in[i], 0);
-                        wt->bit_writer(t, 7);
-                        break;
-
-                case 1:
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 0), 7);
-                        wt->bit_writer(1, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 1), 7);
-                        break;
-
-                case 2:
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 0), 7);
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 1), 7);
-                        wt->bit_writer(1, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 2), 7);
-                        break;
-
-                case 3:
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 0), 7);
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 1), 7);
+                /* Write 7-bit groups with a continuation bit each */
+                for (j = 0; j < nwords; j++) {
                         wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 2), 7);
-                        wt->bit_writer(1, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 3), 7);
-                        break;
-
-                case 4:
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 0), 7);
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 1), 7);
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 2), 7);
-                        wt->bit_writer(0, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 3), 7);
-                        wt->bit_writer(1, 1);
-                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], 4), 7);
-                        break;
-
-                default:
-                        eoutput("Exception: nwords's out of range");
-
+                        wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], j), 7);
                 }
+
+                wt->bit_writer(1, 1);
+                wt->bit_writer(VARIABLEBYTE_EXT7BITS(in[i], nwords), 7);
         }
 
         wt->bit_flush();
@@ -93,9 +50,10 @@ VariableByte::encodeArray(uint32_t *in, uint32_t len,
         delete wt;
 }
 
+template <class T>
 void
-VariableByte::decodeArray(uint32_t *in, uint32_t len,
-                uint32_t *out, uint32_t nvalue)
+VariableByte::decode(uint32_t *in, uint32_t len,
+                T *out, uint32_t nvalue)
 {
         uint32_t        i;
         uint32_t        j;
@@ -110,10 +68,10 @@ VariableByte::decodeArray(uint32_t *in, uint32_t len,
                 *out = d & VARIABLEBYTE_DATA;
 
                 for (j = 1; (d & VARIABLEBYTE_DESC) == 0; j++) {
-                        __assert(j <= 5);
+                        __assert(7 * j < 8 * sizeof(T));
 
                         d = rd->bit_reader(8);
-                        *out |= (d & VARIABLEBYTE_DATA) << (7 * j);
+                        *out |= (T)(d & VARIABLEBYTE_DATA) << (7 * j);
                 }
 
                 out++;
@@ -122,3 +80,30 @@ VariableByte::decodeArray(uint32_t *in, uint32_t len,
         delete rd;
 }
 
+void
+VariableByte::encodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        VariableByte::encode(in, len, out, nvalue);
+}
+
+void
+VariableByte::decodeArray(uint32_t *in, uint32_t len,
+                uint32_t *out, uint32_t nvalue)
+{
+        VariableByte::decode(in, len, out, nvalue);
+}
+
+void
+VariableByte::encodeArray(uint64_t *in, uint32_t len,
+                uint32_t *out, uint32_t &nvalue)
+{
+        VariableByte::encode(in, len, out, nvalue);
+}
+
+void
+VariableByte::decodeArray(uint32_t *in, uint32_t len,
+                uint64_t *out, uint32_t nvalue)
+{
+        VariableByte::decode(in, len, out, nvalue);
+}
@@ -13,81 +13,201 @@
  */
 
 #include "decoders.hpp"
+#include "utils/numa_utils.hpp"
+#include "compress/CompactTOC.hpp"
+
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 
 using namespace std;
 
 #define NLOOP   1
 
-#define __header_validate(addr, len)    \
-        do {                            \
-                uint32_t        magic;  \
-                uint32_t        vmajor; \
-                uint32_t        vminor; \
-\
-                magic = __next_read32(addr, len);       \
-                vmajor = __next_read32(addr, len);      \
-                vminor = __next_read32(addr, len);      \
-\
-                if (magic != MAGIC_NUM ||               \
-                        vmajor != VMAJOR || vminor != VMINOR)   \
-                        eoutput("Not support input format");    \
-        } while (0);
+/*
+ * A compressed stream of term frequencies or positions. Lists in the
+ * stream are decoded chunk by chunk through the cursor below, so
+ * that these values are only decoded when requested.
+ */
+struct __dstream {
+        int             decID;
+        TOCReader       *rd;
+        uint32_t        *list;
+        ShortBlock      sb;
+
+        /* A cursor in a current list */
+        uint32_t        num;
+        uint32_t        rest;
+        uint64_t        pos;
+        uint64_t        next_pos;
+};
+
+/*
+ * A shard of lists decoded by a thread pinned to a node. TOC entries
+ * and compressed lists in the shard are copied to memory on the node,
+ * so the thread does not read them across nodes.
+ */
+struct __shard {
+        int             decID;
+        uint32_t        node;
+        uint32_t        *toc_addr;
+        uint32_t        *cmp_addr;
+        uint32_t        nlists;
+        bool            sub;
+        uint64_t        lo;
+        uint64_t        hi;
+        uint64_t        list_cap;
+        uint64_t        dints;
+        uint64_t        sum_sizes;
+        pthread_t       th;
+        pthread_barrier_t       *bar;
+};
 
 static void __usage(const char *msg, ...);
+static int __read_decID(const char *arg);
+static uint32_t __read_num(const char *arg,
+                uint32_t max, const char *name);
+static void __open_dstream(struct __dstream &ds, int decID,
+                const char *ifile, const char *sext, uint32_t mopts);
+static void __close_dstream(struct __dstream &ds);
+static void __seek_dstream(struct __dstream &ds, uint32_t j);
+static uint32_t __next_chunk(struct __dstream &ds,
+                double &dtime, uint64_t &sum_sizes);
+static uint32_t *__read_short(ShortBlock &sb, uint32_t *cmp_addr,
+                uint64_t p, double &dtime, uint64_t &sum_sizes);
+static void __decode_shards(int decID, uint32_t nthreads,
+                uint32_t *toc_addr, uint32_t numHeaders, uint32_t *cmp_addr,
+                uint64_t cmplen, bool sub, uint64_t list_cap, double &dtime,
+                uint64_t &dints, uint64_t &sum_sizes);
+static void *__decode_shard(void *arg);
+static int __open_dtlb_counter(void);
+static uint64_t __read_counter(int fd);
 
 int 
 main(int argc, char **argv)
 {
         int             decID;
+        int             fdecID;
+        int             pdecID;
+        int             opt;
+        int             tlbfd;
+        uint32_t        mopts;
+        uint32_t        flags;
+        uint32_t        pfdist;
+        uint32_t        nthreads;
+        uint32_t        npar;
+        uint64_t        tlbmiss;
+        struct rusage   ru_st;
+        struct rusage   ru_et;
         uint32_t        *list;
+        uint32_t        *freqs;
         uint32_t        *cmp_addr;
-        uint32_t        *toc_addr;
+        uint64_t        list_cap;
+        uint64_t        freq_cap;
+        uint32_t        *toc;
         uint64_t        sum_sizes;
         uint64_t        dints;
-        uint64_t        cmpsz;
         uint64_t        cmplenmax;
-        uint64_t        tocsz;
-        uint64_t        toclen;
-        uint64_t        toclenmax;
-        uint64_t        ip;
-        char            *end;
+        bool            compact;
         char            ifile[NFILENAME + NEXTNAME];
         char            ofile[NFILENAME + NEXTNAME];
         double          dtime;
-        FILE            *dec;
+        BulkWriter      *dec;
+        TOCReader       *rd;
+        CompactTOC      *ctoc;
+        ParallelList    *par;
+        ShortBlock      sb;
+        struct __dstream        fs;
+        struct __dstream        ps;
+
+        /* Options for mapping input files */
+        mopts = 0;
+
+        /* Decoders for term frequencies and positions */
+        fdecID = pdecID = -1;
+
+        /* # of lists ahead whose data are prefetched */
+        pfdist = BATCH_PFDIST;
+
+        /* # of threads decoding shards of lists, or 0 for a single loop */
+        nthreads = 0;
+
+        /* # of threads decoding sub-blocks of a list, or 0 for one */
+        npar = 0;
+
+        /* Entries of TOC are compacted in memory if true */
+        compact = false;
+
+        while ((opt = getopt(argc, argv, "HPLWCd:f:p:T:t:")) != -1) {
+                switch (opt) {
+                case 'H': mopts |= MMAP_HUGEPAGE; break;
+                case 'P': mopts |= MMAP_PREFAULT; break;
+                case 'L': mopts |= MMAP_MLOCK; break;
+                case 'W': mopts |= MMAP_WARMUP; break;
+                case 'C': compact = true; break;
+                case 'd': pfdist = __read_num(optarg, UINT16_MAX, "Prefetch distance"); break;
+                case 'T': nthreads = __read_num(optarg, UINT16_MAX, "# of threads"); break;
+                case 't': npar = __read_num(optarg, UINT16_MAX, "# of threads"); break;
+                case 'f': fdecID = __read_decID(optarg); break;
+                case 'p': pdecID = __read_decID(optarg); break;
+                default: __usage(NULL);
+                }
+        }
+
+        argc -= optind - 1;
+        argv += optind - 1;
 
         if (argc < 3)
                 __usage(NULL);
 
-        list = new uint32_t[MAXLEN + TAIL_MERGIN];
+        if (pdecID >= 0 && fdecID < 0)
+                __usage("Positions need term frequencies (-f)");
 
-        if (list == NULL)
-                eoutput("Can't allocate memory");
+        if ((fdecID >= 0 && __dec_absolute(fdecID)) ||
+                        (pdecID >= 0 && __dec_absolute(pdecID)))
+                __usage("Interpolative and SIMDBP128 are only supported for docIDs");
 
-        decID = strtol(argv[1], &end, 10);
-        if ((*end != '\0') || (decID < 0) ||
-                        (decID >= NUMDECODERS) || (errno == ERANGE))
-                __usage("DecoderID '%s' invalid", argv[1]);
+        if (nthreads > 0 && (fdecID >= 0 || argc > 3))
+                __usage("Shards (-T) only decode docIDs without output");
+
+        if (nthreads > 0 && compact)
+                __usage("Shards (-T) read a raw TOC, not compacted (-C)");
+
+        decID = __read_decID(argv[1]);
+
+        if (npar > 0 && (nthreads > 0 || !__dec_parallel(decID)))
+                __usage("Sub-blocks (-t) are only decoded by PForDelta, OPTPForDelta, and VSEncodingBlocks without shards (-T)");
 
         /* Read the file name, and open it */
         strncpy(ifile, argv[2], NFILENAME);
         ifile[NFILENAME - 1] = '\0';
         
         strcat(ifile, dec_ext[decID]);
-        if (decID == D_VSEREST || decID == D_VSEHYB)
-                cmp_addr = int_utils::open_and_mmap_file(ifile, true, cmpsz);
-        else
-                cmp_addr = int_utils::open_and_mmap_file(ifile, false, cmpsz);
+        rd = new TOCReader(ifile,
+                        decID == D_VSEREST || decID == D_VSEHYB, mopts);
+
+        if (rd == NULL)
+                eoutput("Can't allocate memory");
 
-        strcat(ifile, TOCEXT);
-        toc_addr = int_utils::open_and_mmap_file(ifile, false, tocsz);
+        /* Padding after the last list is left out */
+        cmp_addr = rd->cmpAddr();
+        cmplenmax = rd->cmpLen();
+        toc = rd->entries();
+        flags = rd->flags;
 
-        /* Initialize each size */
-        cmplenmax = cmpsz >> 2;
-        toclenmax = tocsz >> 2;
-        toclen = 0;
+        /* A TOC tells if lists are in sub-blocks, whatever -t says */
+        if ((flags & TOC_SUBBLOCKS) && !__dec_parallel(decID))
+                eoutput("Sub-blocks are only decoded by PForDelta, OPTPForDelta, and VSEncodingBlocks");
 
-        __header_validate(toc_addr, toclen);
+        if (npar > 0 && !(flags & TOC_SUBBLOCKS))
+                eoutput("Lists are not encoded in sub-blocks (-t)");
+
+        /* Open streams of term frequencies and positions if needed */
+        if (fdecID >= 0)
+                __open_dstream(fs, fdecID, argv[2], FRQEXT, mopts);
+        if (pdecID >= 0)
+                __open_dstream(ps, pdecID, argv[2], POSEXT, mopts);
 
         /* If possible, setup a output file */
         dec = NULL;
@@ -97,12 +217,7 @@ main(int argc, char **argv)
                 ofile[NFILENAME - 1] = '\0';
 
                 strcat(ofile, DECEXT);
-                dec = fopen(ofile, "w");
-
-                if (dec == NULL)
-                        eoutput("foepn(): Can't create a output file");
-
-                setvbuf(dec, NULL, _IOFBF, BUFSIZ);
+                dec = new BulkWriter(ofile, BULKWRITER_BUFSZ);
         }
 
         /*
@@ -118,33 +233,144 @@ main(int argc, char **argv)
         sum_sizes = 0;
 
         nloop = 0;
-        numHeaders = toclenmax / EACH_HEADER_TOC_SZ;
+        numHeaders = rd->numHeaders;
 
-        /* Store a initial position */
-        ip = toclen;
+        if ((fdecID >= 0 && fs.rd->numHeaders != numHeaders) ||
+                        (pdecID >= 0 && ps.rd->numHeaders != numHeaders))
+                eoutput("TOCs of docIDs and other streams mismatched");
 
-        for (uint32_t i = 0; i < NLOOP; i++, toclen = ip) {
+        /* A buffer is sized from the largest list (or chunk) in TOC */
+        list_cap = rd->maxNum();
+        list_cap = (list_cap > SKIP + 1)? list_cap - 1 : SKIP;
+
+        if (list_cap > CHUNKLEN)
+                list_cap = CHUNKLEN;
+
+        list = new uint32_t[list_cap + TAIL_MERGIN];
+
+        par = NULL;
+
+        if (flags & TOC_SUBBLOCKS) {
+                par = new ParallelList((npar > 0)? npar : 1);
+
+                if (par == NULL)
+                        eoutput("Can't allocate memory");
+        }
+
+        /* A raw TOC is no longer used once its entries are compacted */
+        ctoc = NULL;
+
+        if (compact) {
+                ctoc = new CompactTOC(toc, numHeaders, cmplenmax);
+
+                if (ctoc == NULL)
+                        eoutput("Can't allocate memory");
+
+                cout << "TOC: " << rd->tocSize() << " bytes raw, "
+                        << ctoc->sizeInBytes() << " bytes compacted" << endl;
+
+                rd->closeTOC();
+                toc = NULL;
+        }
+
+        if (list == NULL)
+                eoutput("Can't allocate memory");
+
+        freqs = NULL;
+        freq_cap = 0;
+
+        /* Page faults and TLB misses are counted over the loop below */
+        tlbfd = __open_dtlb_counter();
+        getrusage(RUSAGE_SELF, &ru_st);
+
+        tlbmiss = __read_counter(tlbfd);
+
+        if (nthreads > 0) {
+                __decode_shards(decID, nthreads, toc, numHeaders,
+                                cmp_addr, cmplenmax, flags & TOC_SUBBLOCKS,
+                                list_cap, dtime, dints, sum_sizes);
+                goto LOOP_END;
+        }
+
+        for (uint32_t i = 0; i < NLOOP; i++) {
                 uint32_t        num;
                 uint32_t        prev_doc;
+                uint32_t        prev_pos;
+                uint32_t        rest;
+                uint32_t        nchunk;
+                uint32_t        csize;
                 uint64_t        cmp_pos;
                 uint64_t        next_pos;
+                uint64_t        pos;
+                uint64_t        pf;
+                uint32_t        *vals;
                 double          tm;
+                bool            restored;
 
                 nloop++;
 
                 for (uint32_t j = 0; j < numHeaders; j++) {
+                        /*
+                         * A TOC entry 2 * pfdist lists ahead is fetched
+                         * first, and data of a list pfdist ahead are then
+                         * fetched through the entry, which is in cache.
+                         */
+                        if (pfdist > 0 && ctoc != NULL) {
+                                if (j + pfdist < numHeaders)
+                                        BatchDecoder::prefetch(cmp_addr +
+                                                ctoc->blkPos(j + pfdist), BATCH_PFLINES);
+                        } else if (pfdist > 0) {
+                                if (j + 2 * pfdist < numHeaders)
+                                        BatchDecoder::prefetch(
+                                                &__toc_num(toc, j + 2 * pfdist), 1);
+
+                                if (j + pfdist < numHeaders) {
+                                        pf = __toc_blkpos(__toc_pos(toc, j + pfdist));
+
+                                        BatchDecoder::prefetch(cmp_addr + pf,
+                                                        BATCH_PFLINES);
+                                }
+                        }
+
                         /* Read the header of each list */
-                        num = __next_read32(toc_addr, toclen);
+                        if (ctoc != NULL) {
+                                ctoc->get(j, num, prev_doc, cmp_pos);
+                        } else {
+                                num = __toc_num(toc, j);
+                                prev_doc = __toc_first(toc, j);
+                                cmp_pos = __toc_pos(toc, j);
+                        }
+
+                        /* Write the header of a list on the output file */
+                        if (dec != NULL) {
+                                dec->write(&num, 1);
+                                dec->write(&prev_doc, 1);
+                        }
 
-                        __assert(num < MAXLEN);
+                        /* A short list is a part of a shared block */
+                        if (cmp_pos & TOC_SHORT) {
+                                if (num > 1) {
+                                        vals = __read_short(sb, cmp_addr,
+                                                        cmp_pos, dtime, sum_sizes);
+                                        dints += num - 1;
 
-                        prev_doc = __next_read32(toc_addr, toclen);
-                        cmp_pos = __next_read64(toc_addr, toclen);
+                                        if (dec != NULL) {
+                                                for (uint32_t k = 0; k < num - 1; k++) {
+                                                        prev_doc += vals[k] + 1;
+                                                        list[k] = prev_doc;
+                                                }
 
-                        if (__likely(j != numHeaders - 1))
-                                next_pos = __next_pos64(toc_addr, toclen);
+                                                dec->write(list, num - 1);
+                                        }
+                                }
+
+                                goto NEXT_STREAMS;
+                        }
+
+                        if (ctoc != NULL)
+                                next_pos = ctoc->blkPos(j + 1);
                         else
-                                next_pos = cmplenmax;
+                                next_pos = rd->nextPos(j);
 
                         __assert(cmp_pos <= next_pos);
                         __assert(next_pos - cmp_pos <= UINT32_MAX);
@@ -153,49 +379,150 @@ main(int argc, char **argv)
                         if (__unlikely(cmp_pos >= next_pos))
                                 goto LOOP_END;
 
-                        /* Do decoding */
-                        tm = int_utils::get_time();
-                        (decoders[decID])(cmp_addr + cmp_pos, next_pos - cmp_pos, list, num - 1);
+                        /* A list longer than CHUNKLEN is decoded chunk by chunk */
+                        for (rest = num - 1, pos = cmp_pos; rest > 0; rest -= nchunk) {
+                                if (__likely(num - 1 <= CHUNKLEN)) {
+                                        nchunk = num - 1;
+                                        csize = next_pos - cmp_pos;
+                                } else {
+                                        nchunk = (rest < CHUNKLEN)? rest : CHUNKLEN;
+                                        csize = cmp_addr[pos++];
+                                }
 
-                        /* Accumulate each count */
-                        dtime += int_utils::get_time() - tm;
-                        dints += num - 1;
-                        sum_sizes = cmp_pos;
+                                /*
+                                 * Do decoding, and docIDs are restored in parallel as
+                                 * well. Threads take wall-clock time, not CPU time.
+                                 */
+                                restored = false;
+                                tm = (par != NULL)? int_utils::get_wall_time() :
+                                        int_utils::get_time();
+
+                                if (par != NULL && nchunk > PLIST_SUBLEN) {
+                                        if (dec != NULL) {
+                                                par->decodeDocs(decoders[decID], cmp_addr + pos,
+                                                                csize, list, nchunk, prev_doc);
+                                                restored = true;
+                                        } else {
+                                                par->decodeArray(decoders[decID],
+                                                                cmp_addr + pos, csize, list, nchunk);
+                                        }
+                                } else {
+                                        (decoders[decID])(cmp_addr + pos, csize, list, nchunk);
+                                }
 
-                        /* Write on the output file */
-                        if (dec != NULL) {
-                                if (decID != D_BINARYIPL) {
-                                        fwrite(&num, 1, sizeof(uint32_t), dec);
-                                        fwrite(&prev_doc, 1, sizeof(uint32_t), dec);
+                                /* Accumulate each count */
+                                dtime += ((par != NULL)? int_utils::get_wall_time() :
+                                        int_utils::get_time()) - tm;
+                                dints += nchunk;
+                                pos += csize;
+
+                                /* Write on the output file */
+                                if (dec != NULL) {
+                                        /* Restore docIDs in place, and write them at once */
+                                        if (restored) {
+                                                prev_doc = list[nchunk - 1];
+                                        } else if (!__dec_absolute(decID)) {
+                                                for (uint32_t k = 0; k < nchunk; k++) {
+                                                        prev_doc += list[k] + 1;
+                                                        list[k] = prev_doc;
+                                                }
+                                        }
+
+                                        dec->write(list, nchunk);
+                                }
+                        }
 
-                                        for (uint32_t j = 0; j < num - 1; j++) {
-                                                prev_doc += list[j] + 1;
-                                                fwrite(&prev_doc, 1, sizeof(uint32_t), dec);
+                        sum_sizes += next_pos - cmp_pos;
+NEXT_STREAMS:
+                        if (fdecID < 0)
+                                continue;
+
+                        /*
+                         * Frequencies are kept for a list because
+                         * positions are relative in each document.
+                         */
+                        __seek_dstream(fs, j);
+
+                        freqs = int_utils::reserve_array(freqs,
+                                        freq_cap, fs.num);
+
+                        for (pos = 0; fs.rest > 0; pos += nchunk) {
+                                nchunk = __next_chunk(fs, dtime, sum_sizes);
+                                dints += nchunk;
+
+                                for (uint32_t k = 0; k < nchunk; k++)
+                                        freqs[pos + k] = fs.list[k] + 1;
+                        }
+
+                        if (dec != NULL)
+                                dec->write(freqs, fs.num);
+
+                        if (pdecID < 0)
+                                continue;
+
+                        __seek_dstream(ps, j);
+
+                        /* Restore positions in each document */
+                        for (pos = 0, rest = 0; ps.rest > 0; ) {
+                                nchunk = __next_chunk(ps, dtime, sum_sizes);
+                                dints += nchunk;
+
+                                if (dec == NULL)
+                                        continue;
+
+                                for (uint32_t k = 0; k < nchunk; k++) {
+                                        /* rest is the number of positions left in a document */
+                                        if (rest == 0) {
+                                                rest = freqs[pos++];
+                                                prev_pos = ps.list[k];
+                                        } else {
+                                                prev_pos += ps.list[k] + 1;
                                         }
-                                } else {
-                                        fwrite(&num, 1, sizeof(uint32_t), dec);
-                                        fwrite(&prev_doc, 1, sizeof(uint32_t), dec);
-                                        fwrite(&list, num - 1, sizeof(uint32_t), dec);
+
+                                        ps.list[k] = prev_pos;
+                                        rest--;
                                 }
+
+                                dec->write(ps.list, nchunk);
                         }
                 }
         }
 LOOP_END:
 
+        tlbmiss = __read_counter(tlbfd) - tlbmiss;
+        getrusage(RUSAGE_SELF, &ru_et);
+
         cout << "Decoded ints: " << dints << endl;
         cout << "Time: " << dtime << " Secs" << endl;
         cout << "Performance: " << (dints + 0.0) / (dtime * 1000000) << " mis" << endl; 
-        cout << "Size: " << (sum_sizes * nloop / 1024) * 4 << " KiB" << endl;
-        cout << "Size: " << ((sum_sizes * nloop + 0.0) / (dints + 0.0)) * 32 << " bpi" << endl;
+        cout << "Size: " << (sum_sizes / 1024) * 4 << " KiB" << endl;
+        cout << "Size: " << ((sum_sizes + 0.0) / (dints + 0.0)) * 32 << " bpi" << endl;
+        cout << "Page faults: " << ru_et.ru_minflt - ru_st.ru_minflt << " minor, "
+                << ru_et.ru_majflt - ru_st.ru_majflt << " major" << endl;
+
+        if (tlbfd != -1) {
+                cout << "dTLB misses: " << tlbmiss << endl;
+                close(tlbfd);
+        } else {
+                cout << "dTLB misses: N/A" << endl;
+        }
 
         /* Finalization */
-        int_utils::close_file(cmp_addr, cmpsz);
-        int_utils::close_file(toc_addr, tocsz);
+        delete rd;
+        delete ctoc;
+
+        if (fdecID >= 0)
+                __close_dstream(fs);
+        if (pdecID >= 0)
+                __close_dstream(ps);
+
+        /* Flushed in the destructor */
+        delete dec;
 
-        if (dec != NULL)
-                fclose(dec);
+        delete par;
 
         delete[] list;
+        delete[] freqs;
 
         return EXIT_SUCCESS;
 }
@@ -205,7 +532,17 @@ LOOP_END:
 void
 __usage(const char *msg, ...)
 {
-        cout << "Usage: decoders <DecoderID> <infilename> <outfilename>" << endl;
+        cout << "Usage: decoders [-HPLWC] [-d Lists] [-T Threads] [-t Threads] [-f FreqDecoderID] [-p PosDecoderID] <DecoderID> <infilename> <outfilename>" << endl;
+        cout << "  -H: Use transparent huge pages for input files" << endl;
+        cout << "  -P: Prefault input files with MAP_POPULATE" << endl;
+        cout << "  -L: Lock input files in memory with mlock()" << endl;
+        cout << "  -W: Touch every page of input files before decoding" << endl;
+        cout << "  -C: Compact TOC entries in memory, and look up each list there" << endl;
+        cout << "  -d: Prefetch lists Lists ahead (default: " << BATCH_PFDIST << ", 0 disables)" << endl;
+        cout << "  -T: Decode docIDs in shards by Threads pinned to NUMA nodes" << endl;
+        cout << "  -t: Decode sub-blocks of long lists by Threads if encoded with -t (default: 1)" << endl;
+        cout << "  -f: Decode term frequencies in <infilename>.FRQ" << endl;
+        cout << "  -p: Decode positions in <infilename>.POS (needs -f)" << endl;
 
         if (msg != NULL) {
                 va_list vargs;
@@ -238,7 +575,393 @@ __usage(const char *msg, ...)
         cout << "\t15\tVSEncodingRest" << endl;
         cout << "\t16\tVSEncodingBlocksHybrid" << endl;
         cout << "\t17\tVSEncodingSimple v1" << endl;
-        cout << "\t18\tVSEncodingSimple v2" << endl << endl;
+        cout << "\t18\tVSEncodingSimple v2" << endl;
+        cout << "\t19\tElias-Fano" << endl;
+        cout << "\t20\tPartitioned Elias-Fano" << endl;
+        cout << "\t21\tVSEncodingBlocks with rANS descriptors" << endl;
+        cout << "\t22\tSIMD-BP128 with D4 deltas" << endl << endl;
 
         exit(1);
 }
+
+int
+__read_decID(const char *arg)
+{
+        int     decID;
+        char    *end;
+
+        errno = 0;
+        decID = strtol(arg, &end, 10);
+
+        if ((*end != '\0') || (decID < 0) ||
+                        (decID >= NUMDECODERS) || (errno == ERANGE))
+                __usage("DecoderID '%s' invalid", arg);
+
+        return decID;
+}
+
+uint32_t
+__read_num(const char *arg, uint32_t max, const char *name)
+{
+        long    num;
+        char    *end;
+
+        errno = 0;
+        num = strtol(arg, &end, 10);
+
+        if ((*end != '\0') || (num < 0) ||
+                        (num > max) || (errno == ERANGE))
+                __usage("%s '%s' invalid", name, arg);
+
+        return num;
+}
+
+void
+__open_dstream(struct __dstream &ds, int decID,
+                const char *ifile, const char *sext, uint32_t mopts)
+{
+        uint32_t        list_cap;
+        char            sfile[NFILENAME + 2 * NEXTNAME];
+
+        ds.decID = decID;
+
+        strncpy(sfile, ifile, NFILENAME);
+        sfile[NFILENAME - 1] = '\0';
+
+        strcat(sfile, sext);
+        strcat(sfile, dec_ext[decID]);
+        ds.rd = new TOCReader(sfile,
+                        decID == D_VSEREST || decID == D_VSEHYB, mopts);
+
+        if (ds.rd == NULL)
+                eoutput("Can't allocate memory");
+
+        if (ds.rd->flags & TOC_SUBBLOCKS)
+                eoutput("Sub-blocks are only supported for docIDs");
+
+        /* A buffer is sized from the largest list (or chunk) in TOC */
+        list_cap = ds.rd->maxNum();
+
+        if (list_cap > CHUNKLEN)
+                list_cap = CHUNKLEN;
+
+        ds.list = new uint32_t[list_cap + TAIL_MERGIN];
+
+        if (ds.list == NULL)
+                eoutput("Can't allocate memory");
+}
+
+void
+__close_dstream(struct __dstream &ds)
+{
+        delete ds.rd;
+        delete[] ds.list;
+}
+
+void
+__seek_dstream(struct __dstream &ds, uint32_t j)
+{
+        ds.num = ds.rd->num(j);
+        ds.pos = ds.rd->pos(j);
+
+        if (ds.pos & TOC_SHORT)
+                ds.next_pos = ds.pos;
+        else
+                ds.next_pos = ds.rd->nextPos(j);
+
+        __assert(ds.pos <= ds.next_pos);
+
+        ds.rest = ds.num;
+}
+
+/* It decodes a next chunk of a current list into ds.list */
+uint32_t
+__next_chunk(struct __dstream &ds, double &dtime, uint64_t &sum_sizes)
+{
+        uint32_t        nchunk;
+        uint32_t        csize;
+        double          tm;
+
+        /* Values of a short list are copied from its block at once */
+        if (ds.pos & TOC_SHORT) {
+                memcpy(ds.list, __read_short(ds.sb, ds.rd->cmpAddr(),
+                                ds.pos, dtime, sum_sizes),
+                                ds.num * sizeof(uint32_t));
+
+                ds.rest = 0;
+
+                return ds.num;
+        }
+
+        if (__likely(ds.num <= CHUNKLEN)) {
+                nchunk = ds.num;
+                csize = ds.next_pos - ds.pos;
+        } else {
+                nchunk = (ds.rest < CHUNKLEN)? ds.rest : CHUNKLEN;
+                csize = ds.rd->cmpAddr()[ds.pos++];
+                sum_sizes++;
+        }
+
+        /* Do decoding */
+        tm = int_utils::get_time();
+        (decoders[ds.decID])(ds.rd->cmpAddr() + ds.pos, csize, ds.list, nchunk);
+        dtime += int_utils::get_time() - tm;
+
+        ds.pos += csize;
+        ds.rest -= nchunk;
+        sum_sizes += csize;
+
+        return nchunk;
+}
+
+/*
+ * It returns values of a short list in a shared block. A block is
+ * decoded as a whole, and kept until a list in other blocks is read.
+ */
+uint32_t *
+__read_short(ShortBlock &sb, uint32_t *cmp_addr,
+                uint64_t p, double &dtime, uint64_t &sum_sizes)
+{
+        double          tm;
+
+        if (!sb.cached(p)) {
+                tm = int_utils::get_time();
+                sum_sizes += sb.decode(cmp_addr, p);
+                dtime += int_utils::get_time() - tm;
+        }
+
+        return sb.values(p);
+}
+
+/*
+ * Lists are split into nthreads shards of about the same compressed
+ * size, and shards are spread over nodes in order. A shard boundary
+ * is not put between lists sharing a block, so that each shard has a
+ * contiguous range of compressed data. dtime is elapsed time after
+ * all the shards are copied to their nodes.
+ */
+void
+__decode_shards(int decID, uint32_t nthreads,
+                uint32_t *toc_addr, uint32_t numHeaders, uint32_t *cmp_addr,
+                uint64_t cmplen, bool sub, uint64_t list_cap, double &dtime,
+                uint64_t &dints, uint64_t &sum_sizes)
+{
+        uint32_t        s;
+        uint32_t        j;
+        uint32_t        jb;
+        uint32_t        nnodes;
+        uint64_t        *pos;
+        double          st;
+        __shard         *shards;
+        pthread_barrier_t       bar;
+
+        nnodes = numa_utils::num_nodes();
+
+        shards = new __shard[nthreads];
+        pos = new uint64_t[numHeaders + 1];
+
+        if (shards == NULL || pos == NULL)
+                eoutput("Can't allocate memory");
+
+        for (j = 0; j < numHeaders; j++)
+                pos[j] = __toc_blkpos(__toc_pos(toc_addr, j));
+
+        pos[numHeaders] = cmplen;
+
+        pthread_barrier_init(&bar, NULL, nthreads + 1);
+
+        for (s = 0, j = 0; s < nthreads; s++) {
+                jb = j;
+
+                if (s == nthreads - 1) {
+                        j = numHeaders;
+                } else {
+                        while (j < numHeaders && pos[j] < cmplen * (s + 1) / nthreads)
+                                j++;
+                        while (j > 0 && j < numHeaders && pos[j] == pos[j - 1])
+                                j++;
+                }
+
+                shards[s].decID = decID;
+                shards[s].node = (uint64_t)s * nnodes / nthreads;
+                shards[s].toc_addr = &__toc_num(toc_addr, jb);
+                shards[s].cmp_addr = cmp_addr;
+                shards[s].nlists = j - jb;
+                shards[s].sub = sub;
+                shards[s].lo = pos[jb];
+                shards[s].hi = pos[j];
+                shards[s].list_cap = list_cap;
+                shards[s].dints = 0;
+                shards[s].sum_sizes = 0;
+                shards[s].bar = &bar;
+
+                if (pthread_create(&shards[s].th, NULL,
+                                        __decode_shard, &shards[s]) != 0)
+                        eoutput("pthread_create(): Can't start a decoder");
+        }
+
+        /* Shards start decoding at once after copied */
+        pthread_barrier_wait(&bar);
+        st = int_utils::get_wall_time();
+
+        for (s = 0; s < nthreads; s++) {
+                pthread_join(shards[s].th, NULL);
+
+                dints += shards[s].dints;
+                sum_sizes += shards[s].sum_sizes;
+        }
+
+        dtime += int_utils::get_wall_time() - st;
+
+        cout << "Shards: " << nthreads << " threads on " <<
+                nnodes << " node(s)" << endl;
+
+        pthread_barrier_destroy(&bar);
+
+        delete[] shards;
+        delete[] pos;
+}
+
+void *
+__decode_shard(void *arg)
+{
+        uint32_t        j;
+        uint32_t        num;
+        uint32_t        rest;
+        uint32_t        nchunk;
+        uint32_t        csize;
+        uint32_t        *toc;
+        uint32_t        *cmp;
+        uint32_t        *list;
+        uint64_t        tocsz;
+        uint64_t        cmpsz;
+        uint64_t        cmp_pos;
+        uint64_t        next_pos;
+        uint64_t        pos;
+        double          dtime;
+        __shard         *sh;
+        ParallelList    *par;
+        ShortBlock      *sb;
+
+        sh = (__shard *)arg;
+
+        if (!numa_utils::pin_thread(sh->node))
+                cerr << "Can't pin a thread to node " << sh->node << endl;
+
+        /*
+         * Only [lo, hi) is copied to the node, and so positions in TOC
+         * are rebased by lo when they are read below.
+         */
+        tocsz = ((uint64_t)sh->nlists * EACH_HEADER_TOC_SZ + 1) * sizeof(uint32_t);
+        cmpsz = (sh->hi - sh->lo + TAIL_MERGIN) * sizeof(uint32_t);
+
+        toc = numa_utils::alloc_on_node(tocsz, sh->node);
+        cmp = numa_utils::alloc_on_node(cmpsz, sh->node);
+
+        memcpy(toc, sh->toc_addr, tocsz - sizeof(uint32_t));
+        memcpy(cmp, sh->cmp_addr + sh->lo,
+                        (sh->hi - sh->lo) * sizeof(uint32_t));
+
+        list = new uint32_t[sh->list_cap + TAIL_MERGIN];
+        sb = new ShortBlock;
+
+        /* Sub-blocks of a list are decoded in a shard's own thread */
+        par = (sh->sub)? new ParallelList(1) : NULL;
+
+        if (list == NULL || sb == NULL || (sh->sub && par == NULL))
+                eoutput("Can't allocate memory");
+
+        /* Decoding time is taken by a caller over all the shards */
+        dtime = 0.0;
+
+        pthread_barrier_wait(sh->bar);
+
+        for (j = 0; j < sh->nlists; j++) {
+                num = __toc_num(toc, j);
+                cmp_pos = __toc_pos(toc, j);
+
+                if (cmp_pos & TOC_SHORT) {
+                        if (num > 1) {
+                                __read_short(*sb, cmp,
+                                                cmp_pos - (sh->lo << SHR_OFFBITS),
+                                                dtime, sh->sum_sizes);
+                                sh->dints += num - 1;
+                        }
+
+                        continue;
+                }
+
+                cmp_pos -= sh->lo;
+
+                if (__likely(j != sh->nlists - 1))
+                        next_pos = __toc_blkpos(__toc_pos(toc, j + 1)) - sh->lo;
+                else
+                        next_pos = sh->hi - sh->lo;
+
+                if (__unlikely(cmp_pos >= next_pos))
+                        continue;
+
+                for (rest = num - 1, pos = cmp_pos; rest > 0; rest -= nchunk) {
+                        if (__likely(num - 1 <= CHUNKLEN)) {
+                                nchunk = num - 1;
+                                csize = next_pos - cmp_pos;
+                        } else {
+                                nchunk = (rest < CHUNKLEN)? rest : CHUNKLEN;
+                                csize = cmp[pos++];
+                        }
+
+                        if (par != NULL && nchunk > PLIST_SUBLEN)
+                                par->decodeArray(decoders[sh->decID],
+                                                cmp + pos, csize, list, nchunk);
+                        else
+                                (decoders[sh->decID])(cmp + pos, csize, list, nchunk);
+
+                        sh->dints += nchunk;
+                        pos += csize;
+                }
+
+                sh->sum_sizes += next_pos - cmp_pos;
+        }
+
+        numa_utils::free_on_node(toc, tocsz);
+        numa_utils::free_on_node(cmp, cmpsz);
+
+        delete[] list;
+        delete sb;
+        delete par;
+
+        return NULL;
+}
+
+/* It returns -1 if hardware counters are not available */
+int
+__open_dtlb_counter(void)
+{
+        int                     fd;
+        struct perf_event_attr  pe;
+
+        memset(&pe, 0, sizeof(pe));
+
+        pe.type = PERF_TYPE_HW_CACHE;
+        pe.size = sizeof(pe);
+        pe.config = PERF_COUNT_HW_CACHE_DTLB |
+                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+
+        fd = syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+
+        return fd;
+}
+
+uint64_t
+__read_counter(int fd)
+{
+        uint64_t        v;
+
+        if (fd == -1 || read(fd, &v, sizeof(v)) != sizeof(v))
+                return 0;
+
+        return v;
+}
@@ -14,157 +14,419 @@
 
 #include "encoders.hpp"
 
+#include <getopt.h>
+
 using namespace std;
 
-#define __header_written(out)   \
-        do {                    \
-                uint32_t        magic;  \
-                uint32_t        vmajor; \
-                uint32_t        vminor; \
-\
-                magic = MAGIC_NUM;      \
-                vmajor = VMAJOR;        \
-                vminor = VMINOR;        \
-\
-                fwrite(&magic, sizeof(uint32_t), 1, out);       \
-                fwrite(&vmajor,sizeof(uint32_t), 1, out);       \
-                fwrite(&vminor,sizeof(uint32_t), 1, out);       \
-        } while (0)
+/*
+ * A compressed stream of a posting file. docIDs, term frequencies,
+ * and positions are written into separate streams, and each stream
+ * has its own coder, output file, and TOC.
+ */
+struct __stream {
+        int             encID;
+        double          lambda;
+        bool            fast;
+        TOCWriter       *out;
+
+        /* Sub-blocks of long lists are encoded in parallel if not NULL */
+        ParallelList    *par;
+};
 
 static void __usage(const char *msg, ...);
+static int __read_encID(const char *arg);
+static void __open_stream(struct __stream &st, int encID,
+                const char *ifile, const char *sext, uint32_t flags);
+static void __close_stream(struct __stream &st);
+static void __encode_chunk(struct __stream &st, uint32_t *list,
+                uint32_t nchunk, bool chunked);
 
 int 
 main(int argc, char **argv)
 {
         int             encID;
+        int             opt;
+        int             nstreams;
+        double          lambda;
+        bool            fast;
+        char            *end;
         uint32_t        i;
+        uint32_t        nthreads;
         uint32_t        *list;
-        uint32_t        *cmp_array;
-        uint32_t        *addr;
-        uint64_t        fsz;
+        uint32_t        *freqs;
         uint64_t        lenmax;
+        uint64_t        list_cap;
+        uint64_t        freq_cap;
         char            ifile[NFILENAME];
-        char            ofile[NFILENAME + NEXTNAME];
-        char            *end;
-        FILE            *cmp;
-        FILE            *toc;
+        BulkReader      *in;
+        struct __stream st[3];
+
+        /* Buffers are grown on demand in the loop below */
+        list = NULL;
+        freqs = NULL;
+        list_cap = 0;
+        freq_cap = 0;
+
+        st[1].encID = st[2].encID = -1;
+        lambda = 0.0;
+        fast = false;
+        nthreads = 0;
+
+        /* Coders for term frequencies and positions */
+        while ((opt = getopt(argc, argv, "f:p:l:at:")) != -1) {
+                switch (opt) {
+                case 'f':
+                        st[1].encID = __read_encID(optarg);
+                        break;
+                case 'p':
+                        st[2].encID = __read_encID(optarg);
+                        break;
+                case 'l':
+                        lambda = strtod(optarg, &end);
+
+                        if (*end != '\0' || lambda < 0.0)
+                                __usage("Invalid weight: %s", optarg);
+                        break;
+                case 'a':
+                        fast = true;
+                        break;
+                case 't':
+                        nthreads = strtol(optarg, &end, 10);
+
+                        if (*end != '\0' || nthreads == 0 || nthreads > UINT16_MAX)
+                                __usage("Invalid # of threads: %s", optarg);
+                        break;
+                default:
+                        __usage(NULL);
+                }
+        }
+
+        argc -= optind - 1;
+        argv += optind - 1;
 
         if (argc < 3)
                 __usage(NULL);
 
-        list = new uint32_t[MAXLEN + TAIL_MERGIN];
-        cmp_array = new uint32_t[MAXLEN + TAIL_MERGIN];
+        if (st[2].encID >= 0 && st[1].encID < 0)
+                __usage("Positions need term frequencies (-f)");
 
-        if (list == NULL || cmp_array == NULL)
-                eoutput("Can't allocate memory");
+        /*
+         * BinaryInterpolative and SIMDBP128 take absolute values,
+         * so they only work for docIDs.
+         */
+        if ((st[1].encID >= 0 && __enc_absolute(st[1].encID)) ||
+                        (st[2].encID >= 0 && __enc_absolute(st[2].encID)))
+                __usage("Interpolative and SIMDBP128 are only supported for docIDs");
+
+        nstreams = (st[2].encID >= 0)? 3 : (st[1].encID >= 0)? 2 : 1;
 
         /* Read EncoderID */
-        encID = strtol(argv[1], &end, 10);
-        if ((*end != '\0') || (encID < 0) ||
-                        (encID >= NUMENCODERS) ||(errno == ERANGE))
-                __usage("EncoderID '%s' invalid", argv[1]);
+        encID = __read_encID(argv[1]);
+
+        if (nthreads > 0 && !__enc_parallel(encID))
+                __usage("Sub-blocks (-t) are only supported by PForDelta, OPTPForDelta, and VSEncodingBlocks");
 
         /* Read file name */
         strncpy(ifile, argv[2], NFILENAME);
         ifile[NFILENAME - 1] = '\0';
 
-        /* Open a output file and tune buffer mode */
-        strncpy(ofile, ifile, NFILENAME);
-        strcat(ofile, enc_ext[encID]);
-        cmp = fopen(ofile, "w");
+        /*
+         * Open output files, and a header is written in each TOC.
+         * Only docIDs are in sub-blocks, which decoders restore in
+         * parallel, and so the TOC of docIDs is flagged.
+         */
+        __open_stream(st[0], encID, ifile, "",
+                        (nthreads > 0)? TOC_SUBBLOCKS : 0);
 
-        strcat(ofile, TOCEXT);
-        toc = fopen(ofile, "w");
+        if (nstreams > 1)
+                __open_stream(st[1], st[1].encID, ifile, FRQEXT, 0);
+        if (nstreams > 2)
+                __open_stream(st[2], st[2].encID, ifile, POSEXT, 0);
 
-        if (cmp == NULL || toc == NULL)
-                eoutput("foepn(): Can't create a output file");
+        for (i = 0; i < (uint32_t)nstreams; i++) {
+                st[i].lambda = lambda;
+                st[i].fast = fast;
+        }
 
-        setvbuf(cmp, NULL, _IOFBF, BUFSIZ);
-        setvbuf(toc, NULL, _IOFBF, BUFSIZ);
+        if (nthreads > 0) {
+                st[0].par = new ParallelList(nthreads);
 
-        /* First off, a header is written */
-        __header_written(toc);
+                if (st[0].par == NULL)
+                        eoutput("Can't allocate memory");
+        }
 
         /*
-         * FIXME: I think loops with mmap() is faster than that with
-         * xxxread() on most linux platforms. True?
+         * Inputs are read with large pread()s into double buffers,
+         * which overlaps I/O with encoding. mmap() with page faults
+         * thrashed the page cache on inputs larger than RAM.
          */
-        addr = int_utils::open_and_mmap_file(ifile, false, fsz);
-        lenmax = fsz >> 2;
+        in = new BulkReader(ifile, BULKREADER_BUFSZ);
+        lenmax = in->size();
+
+        /* Short lists are built in this buffer as well */
+        list = int_utils::reserve_array(list,
+                        list_cap, SKIP + TAIL_MERGIN);
 
         {
+                uint32_t        first_doc;
                 uint32_t        prev_doc;
                 uint32_t        cur_doc;
-                uint64_t        cmp_pos;
-                uint32_t        cmp_size;
                 uint32_t        num;
-                uint64_t        len;
-
-                for (len = 0, cmp_pos = 0; len < lenmax; ) {
+                uint32_t        rest;
+                uint32_t        nchunk;
+                uint32_t        k;
+                uint32_t        t;
+                uint32_t        prev_pos;
+                uint32_t        cur_pos;
+                uint64_t        npos;
+
+                /*
+                 * A list in an input file is as follows, where
+                 * frequencies and positions exist only if -f and
+                 * -p are given:
+                 *      [num][docIDs][frequencies][positions]
+                 *
+                 * Frequencies are more than 0, and positions in each
+                 * document are increasing.
+                 */
+                while (in->tell() < lenmax) {
                         /* Read the numer of integers in a list */
-                        num = __next_read32(addr, len);
+                        num = in->next();
 
-                        if (len + num > lenmax)
+                        if (in->tell() + num > lenmax)
                                 goto LOOP_END;
 
                         /* Read the head of a list */
-                        prev_doc = __next_read32(addr, len);
+                        prev_doc = in->next();
+                        first_doc = prev_doc;
 
-                        if (num > SKIP && num < MAXLEN) {
+                        if (num > SKIP) {
                                 /*
                                  * For any list, TOC will contain:
-                                 *      (number of elements, first elements, pointer to the compressed list)
+                                 *      (number of elements, first elements, last elements, pointer to the compressed list)
                                  */
-                                fwrite(&num, 1, sizeof(uint32_t), toc);
-                                fwrite(&prev_doc, 1, sizeof(uint32_t), toc);
-                                fwrite(&cmp_pos, 1, sizeof(uint64_t), toc);
+                                st[0].out->beginList();
 
+                                nchunk = (num - 1 < CHUNKLEN)? num - 1 : CHUNKLEN;
+
+                                list = int_utils::reserve_array(list,
+                                                list_cap, nchunk + TAIL_MERGIN);
+
+                                for (rest = num - 1; rest > 0; rest -= nchunk) {
+                                        nchunk = (rest < CHUNKLEN)? rest : CHUNKLEN;
+
+                                        for (i = 0; i < nchunk; i++) {
+                                                cur_doc = in->next();
+
+                                                if (cur_doc < prev_doc)
+                                                        cerr << "List ordering exception: list MUST be increasing" << endl;
+
+                                                if (!__enc_absolute(encID))
+                                                        list[i] = cur_doc - prev_doc - 1;
+                                                else
+                                                        list[i] = cur_doc;
+
+                                                prev_doc = cur_doc;
+                                        }
+
+                                        __encode_chunk(st[0], list,
+                                                        nchunk, num - 1 > CHUNKLEN);
+                                }
+
+                                st[0].out->endList(num, first_doc, prev_doc);
+                        } else {
+                                /*
+                                 * Short lists are packed into a shared block
+                                 * with d-gaps regardless of EncoderID.
+                                 */
                                 for (i = 0; i < num - 1; i++) {
-                                        cur_doc = __next_read32(addr, len);
+                                        cur_doc = in->next();
 
                                         if (cur_doc < prev_doc)
                                                 cerr << "List ordering exception: list MUST be increasing" << endl;
 
-                                        if (encID != E_BINARYIPL)
-                                                list[i] = cur_doc - prev_doc - 1;
-                                        else
-                                                list[i] = cur_doc;
-
+                                        list[i] = cur_doc - prev_doc - 1;
                                         prev_doc = cur_doc;
                                 }
 
-                                /* Do encoding */
-                                (encoders[encID])(list, num - 1, cmp_array, cmp_size);
+                                st[0].out->writeShort(num, first_doc, prev_doc,
+                                                list, num - 1);
+                        }
+
+                        if (nstreams == 1)
+                                continue;
+
+                        /*
+                         * Frequencies are kept for a list because
+                         * positions are relative in each document.
+                         */
+                        freqs = int_utils::reserve_array(freqs,
+                                        freq_cap, num);
+
+                        for (i = 0, npos = 0; i < num; i++) {
+                                freqs[i] = in->next();
+
+                                if (freqs[i] == 0)
+                                        eoutput("Frequency exception: frequencies MUST be positive");
+
+                                npos += freqs[i];
+                        }
+
+                        if (num > SKIP) {
+                                /* Frequencies are not monotone, so 1s are stored as 0s */
+                                st[1].out->beginList();
+
+                                nchunk = (num < CHUNKLEN)? num : CHUNKLEN;
+
+                                list = int_utils::reserve_array(list,
+                                                list_cap, nchunk + TAIL_MERGIN);
+
+                                for (i = 0; i < num; i += nchunk) {
+                                        nchunk = (num - i < CHUNKLEN)? num - i : CHUNKLEN;
+
+                                        for (k = 0; k < nchunk; k++)
+                                                list[k] = freqs[i + k] - 1;
+
+                                        __encode_chunk(st[1], list,
+                                                        nchunk, num > CHUNKLEN);
+                                }
+
+                                st[1].out->endList(num, 0, 0);
+                        } else {
+                                for (i = 0; i < num; i++)
+                                        list[i] = freqs[i] - 1;
+
+                                st[1].out->writeShort(num, 0, 0, list, num);
+                        }
+
+                        if (nstreams == 2)
+                                continue;
+
+                        if (npos > UINT32_MAX)
+                                eoutput("Too many positions in a list");
+
+                        /* Positions are packed if the total is small enough */
+                        if (npos > SKIP)
+                                st[2].out->beginList();
+
+                        nchunk = (npos < CHUNKLEN)? npos : CHUNKLEN;
+
+                        list = int_utils::reserve_array(list,
+                                        list_cap, nchunk + TAIL_MERGIN);
 
-                                fwrite(cmp_array, sizeof(uint32_t), cmp_size, cmp);
-                                cmp_pos += cmp_size;
+                        /* Positions are d-gaps in each document */
+                        for (i = 0, k = 0, prev_pos = 0; i < num; i++) {
+                                for (t = 0; t < freqs[i]; t++) {
+                                        cur_pos = in->next();
+
+                                        if (t == 0) {
+                                                list[k++] = cur_pos;
+                                        } else {
+                                                if (cur_pos <= prev_pos)
+                                                        cerr << "Position ordering exception: positions MUST be increasing" << endl;
+
+                                                list[k++] = cur_pos - prev_pos - 1;
+                                        }
+
+                                        prev_pos = cur_pos;
+
+                                        if (k == CHUNKLEN) {
+                                                __encode_chunk(st[2], list,
+                                                                k, npos > CHUNKLEN);
+                                                k = 0;
+                                        }
+                                }
+                        }
+
+                        if (npos <= SKIP) {
+                                st[2].out->writeShort(npos, 0, 0, list, k);
                         } else {
-                                /* Read skipped data */
-                                for (i = 0; i < num - 1; i++)
-                                        cur_doc = __next_read32(addr, len);
+                                if (k != 0)
+                                        __encode_chunk(st[2], list,
+                                                        k, npos > CHUNKLEN);
+
+                                st[2].out->endList(npos, 0, 0);
                         }
                 }
         }
 LOOP_END:
 
         /* Finalization */
-        int_utils::close_file(addr, fsz);
+        delete in;
 
-        fclose(cmp);
-        fclose(toc);
+        for (i = 0; i < (uint32_t)nstreams; i++)
+                __close_stream(st[i]);
 
         delete[] list;
-        delete[] cmp_array;
+        delete[] freqs;
 
         return EXIT_SUCCESS;
 }
 
 /*--- Intra functions below ---*/
 
+int
+__read_encID(const char *arg)
+{
+        int     encID;
+        char    *end;
+
+        errno = 0;
+        encID = strtol(arg, &end, 10);
+
+        if ((*end != '\0') || (encID < 0) ||
+                        (encID >= NUMENCODERS) ||(errno == ERANGE))
+                __usage("EncoderID '%s' invalid", arg);
+
+        return encID;
+}
+
+void
+__open_stream(struct __stream &st, int encID,
+                const char *ifile, const char *sext, uint32_t flags)
+{
+        char    ofile[NFILENAME + 2 * NEXTNAME];
+
+        st.encID = encID;
+        st.par = NULL;
+
+        strncpy(ofile, ifile, NFILENAME);
+        strcat(ofile, sext);
+        strcat(ofile, enc_ext[encID]);
+
+        st.out = new TOCWriter(ofile, flags);
+
+        if (st.out == NULL)
+                eoutput("Can't allocate memory");
+}
+
+void
+__close_stream(struct __stream &st)
+{
+        /* A pending block and padding are written in the destructor */
+        delete st.out;
+        delete st.par;
+}
+
+void
+__encode_chunk(struct __stream &st, uint32_t *list,
+                uint32_t nchunk, bool chunked)
+{
+        /* Do encoding */
+        __enc_decode_cost(st.encID, st.lambda);
+        __enc_fast_partition(st.encID, st.fast);
+
+        st.out->encodeChunk(encoders[st.encID], st.par,
+                        list, nchunk, chunked);
+}
+
 void
 __usage(const char *msg, ...)
 {
-        cout << "Usage: encoders <EncoderID> <infilename>" << endl;
+        cout << "Usage: encoders [-f FreqEncoderID] [-p PosEncoderID] [-l Weight] [-a] [-t Threads] <EncoderID> <infilename>" << endl;
+        cout << "  -l: weight of decoding time in bits per ns for VSE partitions (default: 0)" << endl;
+        cout << "  -a: fast VSE partitions for fresh data, which merger -e encodes exactly (default: exact)" << endl;
+        cout << "  -t: encode sub-blocks of long docID lists in parallel by Threads (PForDelta, OPTPForDelta, VSEncodingBlocks)" << endl;
 
         if (msg != NULL) {
                 va_list vargs;
@@ -192,7 +454,11 @@ __usage(const char *msg, ...)
         cout << "\t10\tVSEncodingRest" << endl;
         cout << "\t11\tVSEncodingBlocksHybrid" << endl;
         cout << "\t12\tVSEncodingSimple v1" << endl;
-        cout << "\t13\tVSEncodingSimple v2" << endl << endl;
+        cout << "\t13\tVSEncodingSimple v2" << endl;
+        cout << "\t14\tElias-Fano" << endl;
+        cout << "\t15\tPartitioned Elias-Fano" << endl;
+        cout << "\t16\tVSEncodingBlocks with rANS descriptors" << endl;
+        cout << "\t17\tSIMD-BP128 with D4 deltas" << endl << endl;
 
         exit(1);
 }
@@ -62,6 +62,29 @@ BitsWriter::bit_writer(uint32_t value, uint32_t bits)
         } 
 }
 
+void
+BitsWriter::bit_writer64(uint64_t value, uint32_t bits)
+{
+        __assert(bits <= 64);
+
+        if (bits > 32) {
+                bit_writer(value >> 32, bits - 32);
+                bits = 32;
+        }
+
+        bit_writer(value & ((1ULL << 32) - 1), bits);
+}
+
+void
+BitsWriter::bit_copy(uint32_t *in, uint64_t nbits)
+{
+        for (; nbits >= 32; nbits -= 32)
+                bit_writer(*in++, 32);
+
+        if (nbits > 0)
+                bit_writer(*in >> (32 - nbits), nbits);
+}
+
 uint32_t *
 BitsWriter::ret_pos()
 {
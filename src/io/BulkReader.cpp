@@ -0,0 +1,193 @@
+/*-----------------------------------------------------------------------------
+ *  BulkReader.cpp - A double-buffered reader to input integers in bulk.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "io/BulkReader.hpp"
+
+BulkReader::BulkReader(const char *filen, uint64_t bufsz)
+{
+        int             ret;
+        struct stat     sb;
+
+        fd = open(filen, O_RDONLY);
+
+        if (fd == -1)
+                eoutput("oepn(): Can't open the file");
+
+        ret = fstat(fd, &sb);
+        if (ret == -1 || sb.st_size == 0)
+                eoutput("fstat(): Unknown the file size");
+
+        fsz = sb.st_size;
+
+        __fadvise_sequential(fd, fsz);
+
+        this->bufsz = bufsz;
+
+        buf[0] = new uint32_t[bufsz];
+        buf[1] = new uint32_t[bufsz];
+
+        if (buf[0] == NULL || buf[1] == NULL)
+                eoutput("Can't allocate memory");
+
+        filled[0] = filled[1] = 0;
+        ready[0] = ready[1] = false;
+        quit = false;
+
+        cur = NULL;
+        pos = len = base = 0;
+        idx = 1;
+
+        pthread_mutex_init(&mtx, NULL);
+        pthread_cond_init(&cond, NULL);
+
+        if (pthread_create(&th, NULL, __prefetcher, this) != 0)
+                eoutput("pthread_create(): Can't start a prefetcher");
+}
+
+BulkReader::~BulkReader()
+{
+        pthread_mutex_lock(&mtx);
+        quit = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mtx);
+
+        pthread_join(th, NULL);
+
+        pthread_mutex_destroy(&mtx);
+        pthread_cond_destroy(&cond);
+
+        close(fd);
+
+        delete[] buf[0];
+        delete[] buf[1];
+}
+
+void
+BulkReader::skip(uint64_t n)
+{
+        while (n > len - pos) {
+                n -= len - pos;
+                pos = len;
+                fetch();
+        }
+
+        pos += n;
+}
+
+/* --- Intra functions below --- */
+
+void
+BulkReader::fetch()
+{
+        uint32_t        nidx;
+
+        if (cur != NULL)
+                release();
+
+        nidx = idx ^ 1;
+
+        pthread_mutex_lock(&mtx);
+
+        while (!ready[nidx])
+                pthread_cond_wait(&cond, &mtx);
+
+        pthread_mutex_unlock(&mtx);
+
+        if (filled[nidx] == 0)
+                eoutput("BulkReader: Read beyond the end of the file");
+
+        base += len;
+
+        cur = buf[nidx];
+        len = filled[nidx];
+        pos = 0;
+        idx = nidx;
+}
+
+void
+BulkReader::release()
+{
+        pthread_mutex_lock(&mtx);
+        ready[idx] = false;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mtx);
+}
+
+void
+BulkReader::prefetcher()
+{
+        uint32_t        i;
+        uint64_t        off;
+        uint64_t        end;
+        uint64_t        n;
+        ssize_t         ret;
+        bool            done;
+        char            *p;
+
+        /* A trailing fragment less than 4B is ignored */
+        end = fsz & ~3ULL;
+
+        for (i = 0, off = 0; ; i ^= 1) {
+                pthread_mutex_lock(&mtx);
+
+                while (ready[i] && !quit)
+                        pthread_cond_wait(&cond, &mtx);
+
+                /* quit is set by the destructor under the lock */
+                done = quit;
+
+                pthread_mutex_unlock(&mtx);
+
+                if (done)
+                        break;
+
+                n = end - off;
+                if (n > bufsz * sizeof(uint32_t))
+                        n = bufsz * sizeof(uint32_t);
+
+                for (p = (char *)buf[i]; p < (char *)buf[i] + n; ) {
+                        ret = pread(fd, p, (char *)buf[i] + n - p, off);
+
+                        if (ret == -1) {
+                                if (errno == EINTR)
+                                        continue;
+
+                                eoutput("pread(): Can't read the file");
+                        }
+
+                        if (ret == 0)
+                                eoutput("pread(): Unexpected end of the file");
+
+                        p += ret;
+                        off += ret;
+                }
+
+                /* Data already copied are not needed in the page cache */
+                if (n != 0)
+                        __fadvise_dontneed(fd, off - n, n);
+
+                pthread_mutex_lock(&mtx);
+                filled[i] = n >> 2;
+                ready[i] = true;
+                pthread_cond_broadcast(&cond);
+                pthread_mutex_unlock(&mtx);
+        }
+}
+
+void *
+BulkReader::__prefetcher(void *arg)
+{
+        ((BulkReader *)arg)->prefetcher();
+        return NULL;
+}
@@ -0,0 +1,116 @@
+/*-----------------------------------------------------------------------------
+ *  BulkWriter.cpp - A buffered writer to output decoded integers in bulk.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "io/BulkWriter.hpp"
+
+BulkWriter::BulkWriter(const char *filen, uint64_t bufsz)
+{
+        fd = open(filen, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (fd == -1)
+                eoutput("open(): Can't create a output file");
+
+        buf = new uint32_t[bufsz];
+
+        if (buf == NULL)
+                eoutput("Can't allocate memory");
+
+        pos = 0;
+        size = bufsz;
+        written = 0;
+}
+
+BulkWriter::~BulkWriter()
+{
+        flush();
+        close(fd);
+
+        delete[] buf;
+}
+
+void
+BulkWriter::write(uint32_t *in, uint64_t len)
+{
+        if (__likely(pos + len <= size)) {
+                memcpy(buf + pos, in, len * sizeof(uint32_t));
+                pos += len;
+                return;
+        }
+
+        if (len < size) {
+                flush();
+
+                memcpy(buf, in, len * sizeof(uint32_t));
+                pos = len;
+        } else {
+                struct iovec    iov[2];
+
+                /* Buffered data first, and the array follows */
+                iov[0].iov_base = buf;
+                iov[0].iov_len = pos * sizeof(uint32_t);
+                iov[1].iov_base = in;
+                iov[1].iov_len = len * sizeof(uint32_t);
+
+                writev_all(iov, 2);
+                pos = 0;
+        }
+}
+
+void
+BulkWriter::flush()
+{
+        struct iovec    iov;
+
+        if (pos == 0)
+                return;
+
+        iov.iov_base = buf;
+        iov.iov_len = pos * sizeof(uint32_t);
+
+        writev_all(&iov, 1);
+        pos = 0;
+}
+
+/* --- Intra functions below --- */
+
+void
+BulkWriter::writev_all(struct iovec *iov, int iovcnt)
+{
+        ssize_t         n;
+
+        while (iovcnt > 0) {
+                n = writev(fd, iov, iovcnt);
+
+                if (n == -1) {
+                        if (errno == EINTR)
+                                continue;
+
+                        eoutput("writev(): Can't write the output file");
+                }
+
+                written += n;
+
+                /* Skip fully-written entries, and adjust a partial one */
+                while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+                        n -= iov->iov_len;
+                        iov++;
+                        iovcnt--;
+                }
+
+                if (iovcnt > 0) {
+                        iov->iov_base = (char *)iov->iov_base + n;
+                        iov->iov_len -= n;
+                }
+        }
+}
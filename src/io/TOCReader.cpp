@@ -0,0 +1,99 @@
+/*-----------------------------------------------------------------------------
+ *  TOCReader.cpp - A reader of a compressed file and its TOC.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "io/TOCReader.hpp"
+#include "compress/VariableByte.hpp"
+
+TOCReader::TOCReader(const char *filen, bool write, uint32_t opts)
+{
+        uint32_t        magic;
+        uint32_t        vmajor;
+        uint32_t        vminor;
+        uint64_t        len;
+        char            tfile[NFILENAME + 2 * NEXTNAME + sizeof(TOCEXT)];
+
+        strncpy(tfile, filen, NFILENAME + 2 * NEXTNAME);
+        tfile[NFILENAME + 2 * NEXTNAME - 1] = '\0';
+
+        cmp_addr = int_utils::open_and_mmap_file(tfile, write, cmpsz, opts);
+
+        __cmp_validate(cmpsz);
+
+        strcat(tfile, TOCEXT);
+        toc_addr = int_utils::open_and_mmap_file(tfile, false, tocsz, opts);
+
+        if (tocsz < 4 * sizeof(uint32_t))
+                eoutput("Not support input format");
+
+        len = 0;
+        magic = __next_read32(toc_addr, len);
+        vmajor = __next_read32(toc_addr, len);
+        vminor = __next_read32(toc_addr, len);
+        flags = __next_read32(toc_addr, len);
+
+        if (magic != MAGIC_NUM ||
+                        vmajor != VMAJOR || vminor != VMINOR ||
+                        (flags & ~TOC_FLAGS) != 0)
+                eoutput("Not support input format");
+
+        toc = toc_addr + len;
+        numHeaders = ((tocsz >> 2) - len) / EACH_HEADER_TOC_SZ;
+}
+
+TOCReader::~TOCReader()
+{
+        int_utils::close_file(cmp_addr, cmpsz);
+        closeTOC();
+}
+
+void
+TOCReader::closeTOC()
+{
+        if (toc_addr == NULL)
+                return;
+
+        int_utils::close_file(toc_addr, tocsz);
+
+        toc_addr = NULL;
+        toc = NULL;
+}
+
+uint32_t
+TOCReader::maxNum()
+{
+        uint32_t        j;
+        uint32_t        ret;
+
+        for (j = 0, ret = 0; j < numHeaders; j++) {
+                if (__toc_num(toc, j) > ret)
+                        ret = __toc_num(toc, j);
+        }
+
+        return ret;
+}
+
+/* Shared blocks are decoded by VariableByte, i.e., D_SHORT */
+uint32_t
+ShortBlock::decode(uint32_t *cmp_addr, uint64_t p)
+{
+        uint32_t        head;
+
+        pos = __toc_blkpos(p);
+        head = cmp_addr[pos];
+
+        VariableByte::decodeArray(cmp_addr + pos + 1, head >> SHR_OFFBITS,
+                        vals, head & ((1U << SHR_OFFBITS) - 1));
+
+        return (head >> SHR_OFFBITS) + 1;
+}
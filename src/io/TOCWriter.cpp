@@ -0,0 +1,173 @@
+/*-----------------------------------------------------------------------------
+ *  TOCWriter.cpp - A writer of a compressed file and its TOC.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "io/TOCWriter.hpp"
+#include "compress/VariableByte.hpp"
+
+TOCWriter::TOCWriter(const char *filen, uint32_t flags)
+{
+        uint32_t        header[4];
+        char            tfile[NFILENAME + 2 * NEXTNAME + sizeof(TOCEXT)];
+
+        cmp_pos = 0;
+        list_pos = 0;
+        cmp_array = NULL;
+        cmp_cap = 0;
+        blk_n = 0;
+
+        blk = new uint32_t[SHRBLKLEN + TAIL_MERGIN];
+
+        if (blk == NULL)
+                eoutput("Can't allocate memory");
+
+        /* Open a output file and tune buffer mode */
+        strncpy(tfile, filen, NFILENAME + 2 * NEXTNAME);
+        tfile[NFILENAME + 2 * NEXTNAME - 1] = '\0';
+        cmp = fopen(tfile, "w");
+
+        strcat(tfile, TOCEXT);
+        toc = fopen(tfile, "w");
+
+        if (cmp == NULL || toc == NULL)
+                eoutput("foepn(): Can't create a output file");
+
+        setvbuf(cmp, NULL, _IOFBF, BUFSIZ);
+        setvbuf(toc, NULL, _IOFBF, BUFSIZ);
+
+        /* First off, a header is written */
+        header[0] = MAGIC_NUM;
+        header[1] = VMAJOR;
+        header[2] = VMINOR;
+        header[3] = flags;
+
+        fwrite(header, sizeof(uint32_t), 4, toc);
+}
+
+TOCWriter::~TOCWriter()
+{
+        uint32_t        pad[TAIL_MERGIN];
+
+        flushShort();
+
+        /* Decoders may read past the last list */
+        memset(pad, 0, sizeof(pad));
+        fwrite(pad, sizeof(uint32_t), TAIL_MERGIN, cmp);
+
+        fclose(cmp);
+        fclose(toc);
+
+        delete[] cmp_array;
+        delete[] blk;
+}
+
+void
+TOCWriter::beginList()
+{
+        /* A pending block is placed before a long list */
+        flushShort();
+
+        list_pos = cmp_pos;
+}
+
+void
+TOCWriter::endList(uint32_t num, uint32_t first, uint32_t last)
+{
+        putEntry(num, first, last, list_pos);
+}
+
+void
+TOCWriter::writeShort(uint32_t num, uint32_t first, uint32_t last,
+                uint32_t *vals, uint32_t n)
+{
+        uint64_t        p;
+
+        __assert(n <= SHRBLKLEN);
+
+        if (blk_n + n > SHRBLKLEN)
+                flushShort();
+
+        /* The block is written at cmp_pos when flushed */
+        p = __toc_short(cmp_pos, blk_n);
+        putEntry(num, first, last, p);
+
+        memcpy(blk + blk_n, vals, n * sizeof(uint32_t));
+        blk_n += n;
+}
+
+void
+TOCWriter::encodeChunk(pt2Enc enc, ParallelList *par,
+                uint32_t *list, uint32_t nchunk, bool chunked)
+{
+        uint32_t        cmp_size;
+        bool            sub;
+
+        /* A list in a sub-block is encoded as it is */
+        sub = (par != NULL && nchunk > PLIST_SUBLEN);
+
+        cmp_array = int_utils::reserve_array(cmp_array, cmp_cap,
+                        (sub)? ParallelList::bound(nchunk) : __cmp_bound(nchunk));
+
+        if (sub)
+                par->encodeArray(enc, list, nchunk, cmp_array, cmp_size);
+        else
+                enc(list, nchunk, cmp_array, cmp_size);
+
+        if (chunked) {
+                fwrite(&cmp_size, 1, sizeof(uint32_t), cmp);
+                cmp_pos++;
+        }
+
+        write(cmp_array, cmp_size);
+}
+
+void
+TOCWriter::write(uint32_t *in, uint64_t len)
+{
+        fwrite(in, sizeof(uint32_t), len, cmp);
+        cmp_pos += len;
+}
+
+void
+TOCWriter::putEntry(uint32_t num, uint32_t first,
+                uint32_t last, uint64_t p)
+{
+        uint32_t        ent[EACH_HEADER_TOC_SZ];
+
+        __toc_put(ent, 0, num, first, last, p);
+        fwrite(ent, sizeof(uint32_t), EACH_HEADER_TOC_SZ, toc);
+}
+
+/* Shared blocks are encoded by VariableByte, i.e., E_SHORT */
+void
+TOCWriter::flushShort()
+{
+        uint32_t        cmp_size;
+        uint32_t        head;
+
+        if (blk_n == 0)
+                return;
+
+        cmp_array = int_utils::reserve_array(cmp_array,
+                        cmp_cap, __cmp_bound(SHRBLKLEN));
+
+        VariableByte::encodeArray(blk, blk_n, cmp_array, cmp_size);
+
+        head = (cmp_size << SHR_OFFBITS) | blk_n;
+
+        fwrite(&head, 1, sizeof(uint32_t), cmp);
+        write(cmp_array, cmp_size);
+
+        cmp_pos++;
+        blk_n = 0;
+}
@@ -0,0 +1,483 @@
+/*-----------------------------------------------------------------------------
+ *  merger.cpp - A merger of two compressed files into one, where lists of
+ *      each term are concatenated without encoding them again as far as
+ *      their coder allows.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <getopt.h>
+
+#include "encoders.hpp"
+#include "decoders.hpp"
+#include "compress/ListMerger.hpp"
+
+using namespace std;
+
+/* A decoder, a way of merging, and a skipper or merger for each EncoderID */
+struct __merge_coder {
+        int             decID;
+        int             type;
+        pt2Skip         skip;
+        pt2Merge        merge;
+};
+
+static const struct __merge_coder __mcoders[NUMENCODERS] = {
+        {D_GAMMA, MERGE_REENCODE, NULL, NULL},
+        {D_DELTA, MERGE_REENCODE, NULL, NULL},
+        {D_VARIABLEBYTE, MERGE_REENCODE, NULL, NULL},
+        {D_BINARYIPL, MERGE_REENCODE, NULL, NULL},
+        {D_SIMPLE9, MERGE_WORDS, Simple9::skipBlock, NULL},
+        {D_SIMPLE16, MERGE_WORDS, Simple16::skipBlock, NULL},
+        {D_P4D, MERGE_BLOCKS, PForDelta::skipBlock, NULL},
+        {D_OPTP4D, MERGE_BLOCKS, PForDelta::skipBlock, NULL},
+        {D_VSEBLOCKS, MERGE_REENCODE, NULL, NULL},
+        {D_VSER, MERGE_REENCODE, NULL, NULL},
+        {D_VSEREST, MERGE_REENCODE, NULL, NULL},
+        {D_VSEHYB, MERGE_REENCODE, NULL, NULL},
+        {D_VSESIMPLEV1, MERGE_PARTS, NULL, VSEncodingSimpleV1::mergeArray},
+        {D_VSESIMPLEV2, MERGE_PARTS, NULL, VSEncodingSimpleV2::mergeArray},
+        {D_EF, MERGE_REENCODE, NULL, NULL},
+        {D_PEF, MERGE_REENCODE, NULL, NULL},
+        {D_VSEBLOCKSANS, MERGE_REENCODE, NULL, NULL},
+        {D_SIMDBP128, MERGE_REENCODE, NULL, NULL}
+};
+
+/* A compressed file to be merged, and a list read from it */
+struct __segment {
+        TOCReader       *rd;
+        uint32_t        *cmp_addr;
+
+        /* A shared block of short lists last decoded */
+        ShortBlock      sb;
+
+        /* Long lists are in sub-blocks if not NULL */
+        ParallelList    *par;
+
+        /* A current list, and its values in a coder's domain */
+        uint32_t        num;
+        uint32_t        first;
+        uint32_t        last;
+        uint64_t        pos;
+        uint64_t        next_pos;
+        uint32_t        *vals;
+        uint64_t        vals_cap;
+};
+
+static void __usage(const char *msg, ...);
+static int __read_encID(const char *arg);
+static void __open_segment(struct __segment &sg, int decID, const char *ifile);
+static void __close_segment(struct __segment &sg);
+static void __seek_segment(struct __segment &sg, uint32_t j);
+static bool __in_subblocks(struct __segment &sg, uint32_t n);
+static void __read_values(struct __segment &sg, int encID, int decID);
+static TOCWriter *__open_stream(int encID, const char *ofile);
+
+int
+main(int argc, char **argv)
+{
+        int             opt;
+        int             encID;
+        int             decID;
+        bool            exact;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        num;
+        uint32_t        n;
+        uint32_t        nA;
+        uint32_t        nB;
+        uint32_t        val;
+        uint32_t        lastA;
+        uint32_t        lenA;
+        uint32_t        lenB;
+        uint32_t        nvalue;
+        uint32_t        nchunk;
+        uint32_t        *list;
+        uint32_t        *inA;
+        uint32_t        *inB;
+        uint32_t        *cmpA;
+        uint32_t        *cmpB;
+        uint64_t        list_cap;
+        uint64_t        nints;
+        uint64_t        nreenc;
+        double          mtime;
+        MergeCoder      mc;
+        struct __segment sg[2];
+        TOCWriter       *out;
+
+        /* All the lists are encoded again if true */
+        exact = false;
+
+        while ((opt = getopt(argc, argv, "e")) != -1) {
+                switch (opt) {
+                case 'e': exact = true; break;
+                default: __usage(NULL);
+                }
+        }
+
+        argc -= optind - 1;
+        argv += optind - 1;
+
+        if (argc < 5)
+                __usage(NULL);
+
+        encID = __read_encID(argv[1]);
+        decID = __mcoders[encID].decID;
+
+        mc.type = (exact)? MERGE_REENCODE : __mcoders[encID].type;
+        mc.enc = encoders[encID];
+        mc.dec = decoders[decID];
+        mc.blk = blockDecoders[decID];
+        mc.skip = __mcoders[encID].skip;
+        mc.merge = __mcoders[encID].merge;
+
+        __open_segment(sg[0], decID, argv[2]);
+        __open_segment(sg[1], decID, argv[3]);
+
+        /* Lists of a term are at the same index in both the TOCs */
+        if (sg[0].rd->numHeaders != sg[1].rd->numHeaders)
+                eoutput("TOCs of input files mismatched");
+
+        out = __open_stream(encID, argv[4]);
+
+        list = NULL;
+        list_cap = 0;
+
+        /* Short lists of a segment are encoded in these buffers to merge */
+        cmpA = new uint32_t[__cmp_bound(SKIP)];
+        cmpB = new uint32_t[__cmp_bound(SKIP)];
+
+        if (cmpA == NULL || cmpB == NULL)
+                eoutput("Can't allocate memory");
+
+        nints = 0;
+        nreenc = 0;
+        mtime = int_utils::get_wall_time();
+
+        for (j = 0; j < sg[0].rd->numHeaders; j++) {
+                __seek_segment(sg[0], j);
+                __seek_segment(sg[1], j);
+
+                /* A last docID is in TOC, so A is decoded only if needed */
+                lastA = sg[0].last;
+
+                if (sg[1].first <= lastA)
+                        eoutput("docIDs of a list overlapped: %u after %u",
+                                        sg[1].first, lastA);
+
+                num = sg[0].num + sg[1].num;
+                n = num - 1;
+                nA = sg[0].num - 1;
+                nB = sg[1].num - 1;
+
+                list = int_utils::reserve_array(list,
+                                list_cap, __cmp_bound(n));
+
+                if (num <= SKIP) {
+                        /* Short lists have d-gaps regardless of EncoderID */
+                        memcpy(list, sg[0].sb.read(sg[0].cmp_addr, sg[0].pos),
+                                        nA * sizeof(uint32_t));
+                        list[nA] = sg[1].first - lastA - 1;
+                        memcpy(list + nA + 1, sg[1].sb.read(sg[1].cmp_addr,
+                                        sg[1].pos), nB * sizeof(uint32_t));
+
+                        out->writeShort(num, sg[0].first, sg[1].last, list, n);
+                        nints += n;
+
+                        continue;
+                }
+
+                val = (__enc_absolute(encID))?
+                        sg[1].first : sg[1].first - lastA - 1;
+
+                out->beginList();
+
+                /* Chunked lists and sub-blocks are decoded, and encoded again */
+                if (nA > CHUNKLEN || nB > CHUNKLEN || n > CHUNKLEN ||
+                                __in_subblocks(sg[0], nA) ||
+                                __in_subblocks(sg[1], nB)) {
+                        __read_values(sg[0], encID, decID);
+                        __read_values(sg[1], encID, decID);
+
+                        memcpy(list, sg[0].vals, nA * sizeof(uint32_t));
+                        list[nA] = val;
+                        memcpy(list + nA + 1, sg[1].vals, nB * sizeof(uint32_t));
+
+                        for (k = 0; k < n; k += nchunk) {
+                                nchunk = (n - k < CHUNKLEN)? n - k : CHUNKLEN;
+                                out->encodeChunk(encoders[encID], NULL,
+                                                list + k, nchunk, n > CHUNKLEN);
+                        }
+
+                        out->endList(num, sg[0].first, sg[1].last);
+
+                        nints += n;
+                        nreenc += n;
+
+                        continue;
+                }
+
+                /* A short list is encoded first, which is cheap */
+                lenA = lenB = 0;
+                inA = cmpA;
+                inB = cmpB;
+
+                if (sg[0].pos & TOC_SHORT) {
+                        __read_values(sg[0], encID, decID);
+
+                        if (nA > 0)
+                                (mc.enc)(sg[0].vals, nA, cmpA, lenA);
+                } else {
+                        inA = sg[0].cmp_addr + sg[0].pos;
+                        lenA = sg[0].next_pos - sg[0].pos;
+                }
+
+                if (sg[1].pos & TOC_SHORT) {
+                        __read_values(sg[1], encID, decID);
+
+                        if (nB > 0)
+                                (mc.enc)(sg[1].vals, nB, cmpB, lenB);
+                } else {
+                        inB = sg[1].cmp_addr + sg[1].pos;
+                        lenB = sg[1].next_pos - sg[1].pos;
+                }
+
+                list = int_utils::reserve_array(list, list_cap,
+                                __cmp_bound(n) + lenA + lenB);
+
+                nreenc += ListMerger::mergeArray(mc, inA, lenA, nA, val,
+                                inB, lenB, nB, list, nvalue);
+
+                out->write(list, nvalue);
+                out->endList(num, sg[0].first, sg[1].last);
+
+                nints += n;
+        }
+
+        /* A pending block and padding are written in the destructor */
+        delete out;
+
+        mtime = int_utils::get_wall_time() - mtime;
+
+        cout << "Merged lists: " << sg[0].rd->numHeaders << endl;
+        cout << "Merged ints: " << nints << endl;
+        cout << "Encoded again: " << nreenc << " ints (" <<
+                ((nints > 0)? (nreenc * 100.0) / nints : 0.0) << "%)" << endl;
+        cout << "Time: " << mtime << " Secs" << endl;
+
+        /* Finalization */
+        __close_segment(sg[0]);
+        __close_segment(sg[1]);
+
+        delete[] list;
+        delete[] cmpA;
+        delete[] cmpB;
+
+        return EXIT_SUCCESS;
+}
+
+/*--- Intra functions below ---*/
+
+void
+__usage(const char *msg, ...)
+{
+        cout << "Usage: merger [-e] <EncoderID> <infilename1> <infilename2> <outfilename>" << endl;
+        cout << "  docIDs in a list of infilename2 must follow those of infilename1" << endl;
+        cout << "  -e: encode all the lists again, e.g., to make fast VSE partitions exact" << endl;
+
+        if (msg != NULL) {
+                va_list vargs;
+
+                va_start(vargs, msg);
+                vfprintf(stdout, msg, vargs);
+                va_end(vargs);
+
+                cout << endl;
+        }
+
+        cout << endl << "EncoderID\tEncoderName" << endl;
+        cout << "---" << endl;
+
+        cout << "\t0\tGamma" << endl;
+        cout << "\t1\tDelta" << endl;
+        cout << "\t2\tVariable Byte" << endl;
+        cout << "\t3\tBinary Interpolative" << endl;
+        cout << "\t4\tSimple 9" << endl;
+        cout << "\t5\tSimple 16" << endl;
+        cout << "\t6\tPForDelta" << endl;
+        cout << "\t7\tOPTPForDelta" << endl;
+        cout << "\t8\tVSEncodingBlocks" << endl;
+        cout << "\t9\tVSE-R" << endl;
+        cout << "\t10\tVSEncodingRest" << endl;
+        cout << "\t11\tVSEncodingBlocksHybrid" << endl;
+        cout << "\t12\tVSEncodingSimple v1" << endl;
+        cout << "\t13\tVSEncodingSimple v2" << endl;
+        cout << "\t14\tElias-Fano" << endl;
+        cout << "\t15\tPartitioned Elias-Fano" << endl;
+        cout << "\t16\tVSEncodingBlocks with rANS descriptors" << endl;
+        cout << "\t17\tSIMD-BP128 with D4 deltas" << endl << endl;
+
+        exit(1);
+}
+
+int
+__read_encID(const char *arg)
+{
+        int     encID;
+        char    *end;
+
+        errno = 0;
+        encID = strtol(arg, &end, 10);
+
+        if ((*end != '\0') || (encID < 0) ||
+                        (encID >= NUMENCODERS) ||(errno == ERANGE))
+                __usage("EncoderID '%s' invalid", arg);
+
+        return encID;
+}
+
+void
+__open_segment(struct __segment &sg, int decID, const char *ifile)
+{
+        char    sfile[NFILENAME + 2 * NEXTNAME];
+
+        strncpy(sfile, ifile, NFILENAME);
+        sfile[NFILENAME - 1] = '\0';
+
+        strcat(sfile, dec_ext[decID]);
+        sg.rd = new TOCReader(sfile, decID == D_VSEREST || decID == D_VSEHYB);
+
+        if (sg.rd == NULL)
+                eoutput("Can't allocate memory");
+
+        sg.cmp_addr = sg.rd->cmpAddr();
+
+        /* A single thread decodes sub-blocks, which are encoded again */
+        sg.par = NULL;
+
+        if (sg.rd->flags & TOC_SUBBLOCKS) {
+                if (!__dec_parallel(decID))
+                        eoutput("Sub-blocks are only decoded by PForDelta, OPTPForDelta, and VSEncodingBlocks");
+
+                sg.par = new ParallelList(1);
+
+                if (sg.par == NULL)
+                        eoutput("Can't allocate memory");
+        }
+
+        sg.vals = NULL;
+        sg.vals_cap = 0;
+}
+
+void
+__close_segment(struct __segment &sg)
+{
+        delete sg.rd;
+        delete[] sg.vals;
+        delete sg.par;
+}
+
+void
+__seek_segment(struct __segment &sg, uint32_t j)
+{
+        sg.num = sg.rd->num(j);
+        sg.first = sg.rd->first(j);
+        sg.last = sg.rd->last(j);
+        sg.pos = sg.rd->pos(j);
+
+        if (sg.pos & TOC_SHORT)
+                sg.next_pos = sg.pos;
+        else
+                sg.next_pos = sg.rd->nextPos(j);
+}
+
+/* A current list of n values, or its chunk, is in sub-blocks */
+bool
+__in_subblocks(struct __segment &sg, uint32_t n)
+{
+        return sg.par != NULL && !(sg.pos & TOC_SHORT) && n > PLIST_SUBLEN;
+}
+
+/*
+ * It decodes num - 1 values of a current list into sg.vals. Values
+ * of a short list are made absolute for coders taking docIDs.
+ */
+void
+__read_values(struct __segment &sg, int encID, int decID)
+{
+        uint32_t        i;
+        uint32_t        n;
+        uint32_t        d;
+        uint32_t        nchunk;
+        uint32_t        csize;
+        uint32_t        *gaps;
+        uint64_t        pos;
+
+        n = sg.num - 1;
+        sg.vals = int_utils::reserve_array(sg.vals,
+                        sg.vals_cap, n + TAIL_MERGIN);
+
+        if (sg.pos & TOC_SHORT) {
+                gaps = sg.sb.read(sg.cmp_addr, sg.pos);
+
+                if (!__enc_absolute(encID)) {
+                        memcpy(sg.vals, gaps, n * sizeof(uint32_t));
+                } else {
+                        for (i = 0, d = sg.first; i < n; i++) {
+                                d += gaps[i] + 1;
+                                sg.vals[i] = d;
+                        }
+                }
+
+                return;
+        }
+
+        if (__likely(n <= CHUNKLEN)) {
+                if (__in_subblocks(sg, n))
+                        sg.par->decodeArray(decoders[decID], sg.cmp_addr + sg.pos,
+                                        sg.next_pos - sg.pos, sg.vals, n);
+                else
+                        (decoders[decID])(sg.cmp_addr + sg.pos,
+                                        sg.next_pos - sg.pos, sg.vals, n);
+                return;
+        }
+
+        for (i = 0, pos = sg.pos; i < n; i += nchunk, pos += csize) {
+                nchunk = (n - i < CHUNKLEN)? n - i : CHUNKLEN;
+                csize = sg.cmp_addr[pos++];
+
+                if (__in_subblocks(sg, nchunk))
+                        sg.par->decodeArray(decoders[decID], sg.cmp_addr + pos,
+                                        csize, sg.vals + i, nchunk);
+                else
+                        (decoders[decID])(sg.cmp_addr + pos, csize,
+                                        sg.vals + i, nchunk);
+        }
+}
+
+/* Merged lists are not in sub-blocks */
+TOCWriter *
+__open_stream(int encID, const char *ofile)
+{
+        char            sfile[NFILENAME + 2 * NEXTNAME];
+        TOCWriter       *out;
+
+        strncpy(sfile, ofile, NFILENAME);
+        sfile[NFILENAME - 1] = '\0';
+
+        strcat(sfile, enc_ext[encID]);
+        out = new TOCWriter(sfile, 0);
+
+        if (out == NULL)
+                eoutput("Can't allocate memory");
+
+        return out;
+}
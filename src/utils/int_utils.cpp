@@ -14,12 +14,20 @@
 
 #include "utils/int_utils.hpp"
 
+using namespace std;
+
 int
 int_utils::get_msb(uint32_t v)
 {
         return (v != 0)? __log2_uint32(v) : 0;
 }
 
+int
+int_utils::get_msb(uint64_t v)
+{
+        return (v != 0)? __log2_uint64(v) : 0;
+}
+
 uint32_t
 int_utils::div_roundup(uint32_t v, uint32_t div)
 {
@@ -44,12 +52,26 @@ int_utils::get_time(void)
         return (utime + stime);
 }
 
+double
+int_utils::get_wall_time(void)
+{
+        struct timeval  tv;
+
+        gettimeofday(&tv, NULL);
+
+        return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
 uint32_t
 *int_utils::open_and_mmap_file(char *filen,
-                bool write, uint64_t &len) {
+                bool write, uint64_t &len, uint32_t opts) {
         int             file;
         int             ret;
+        int             prot;
+        int             flags;
         uint32_t        *addr;
+        char            *hint;
+        uint64_t        pgsz;
         struct stat     sb;
 
         if (write)
@@ -69,16 +91,66 @@ uint32_t
 
         __fadvise_sequential(file, len);
 
-        if (write)
-                addr = (uint32_t *)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
-        else
-                addr = (uint32_t *)mmap(NULL, len, PROT_READ, MAP_PRIVATE, file, 0);
+        pgsz = sysconf(_SC_PAGESIZE);
+
+        prot = (write)? PROT_READ | PROT_WRITE : PROT_READ;
+        flags = MAP_PRIVATE;
+
+        if (opts & MMAP_PREFAULT)
+                flags |= MAP_POPULATE;
+
+        /*
+         * Huge pages are only used for 2MiB-aligned ranges, and so the
+         * file is mapped into an aligned space reserved in advance.
+         */
+        hint = NULL;
+
+        if (opts & MMAP_HUGEPAGE) {
+                char            *rsv;
+                uint64_t        head;
+                uint64_t        mlen;
+
+                mlen = (len + pgsz - 1) & ~(pgsz - 1);
+
+                rsv = (char *)mmap(NULL, mlen + HUGEPAGE_SZ,
+                                PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (rsv == MAP_FAILED)
+                        eoutput("mmap(): Can't reserve aligned space");
+
+                hint = (char *)(((uintptr_t)rsv + HUGEPAGE_SZ - 1) & ~(HUGEPAGE_SZ - 1));
+                head = hint - rsv;
+
+                if (head != 0)
+                        munmap(rsv, head);
+
+                munmap(hint + mlen, HUGEPAGE_SZ - head);
+
+                flags |= MAP_FIXED;
+        }
+
+        addr = (uint32_t *)mmap(hint, len, prot, flags, file, 0);
 
         if (addr == MAP_FAILED)
                 eoutput("mmap(): Can't map the file to memory");
 
         close(file);
 
+        /* Hints below are not fatal, e.g., THP disabled or RLIMIT_MEMLOCK */
+        if ((opts & MMAP_HUGEPAGE) && madvise(addr, len, MADV_HUGEPAGE) == -1)
+                cerr << "madvise(): MADV_HUGEPAGE not applied: " << strerror(errno) << endl;
+
+        if ((opts & MMAP_MLOCK) && mlock(addr, len) == -1)
+                cerr << "mlock(): Can't lock pages: " << strerror(errno) << endl;
+
+        if (opts & MMAP_WARMUP) {
+                volatile uint32_t       sum;
+
+                for (uint64_t i = 0; i < len; i += pgsz)
+                        sum = addr[i >> 2];
+
+                (void)sum;
+        }
+
         return addr;
 }
 
@@ -88,3 +160,24 @@ int_utils::close_file(uint32_t *adr, uint64_t len)
         munmap(adr, len);
 }
 
+
+uint32_t *
+int_utils::reserve_array(uint32_t *adr, uint64_t &cap, uint64_t need)
+{
+        if (__likely(need <= cap && adr != NULL))
+                return adr;
+
+        if (cap << 1 > need)
+                need = cap << 1;
+
+        delete[] adr;
+
+        adr = new uint32_t[need];
+
+        if (adr == NULL)
+                eoutput("Can't allocate memory");
+
+        cap = need;
+
+        return adr;
+}
@@ -0,0 +1,163 @@
+/*-----------------------------------------------------------------------------
+ *  numa_utils.cpp - Utilities to place memory and threads on NUMA nodes
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "utils/numa_utils.hpp"
+
+#include <sched.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+using namespace std;
+
+static bool __read_list(const char *path, uint64_t *mask, uint32_t nbits);
+
+uint32_t
+numa_utils::num_nodes(void)
+{
+        uint32_t        i;
+        uint32_t        n;
+        uint64_t        mask[NUMA_MAXNODES / 64];
+
+        if (!__read_list(NUMA_SYSFS "/online", mask, NUMA_MAXNODES))
+                return 1;
+
+        /* Nodes are numbered from 0 without holes in most machines */
+        for (i = 0, n = 0; i < NUMA_MAXNODES; i++) {
+                if (mask[i / 64] & (1ULL << (i % 64)))
+                        n = i + 1;
+        }
+
+        return (n > 0)? n : 1;
+}
+
+bool
+numa_utils::pin_thread(uint32_t node)
+{
+        uint32_t        i;
+        uint32_t        ncpus;
+        uint64_t        mask[CPU_SETSIZE / 64];
+        char            path[NFILENAME];
+        cpu_set_t       set;
+
+        snprintf(path, sizeof(path), NUMA_SYSFS "/node%u/cpulist", node);
+
+        if (!__read_list(path, mask, CPU_SETSIZE))
+                return false;
+
+        CPU_ZERO(&set);
+
+        for (i = 0, ncpus = 0; i < CPU_SETSIZE; i++) {
+                if (mask[i / 64] & (1ULL << (i % 64))) {
+                        CPU_SET(i, &set);
+                        ncpus++;
+                }
+        }
+
+        if (ncpus == 0)
+                return false;
+
+        return pthread_setaffinity_np(pthread_self(),
+                        sizeof(set), &set) == 0;
+}
+
+uint32_t *
+numa_utils::alloc_on_node(uint64_t len, uint32_t node)
+{
+        void            *adr;
+        uint64_t        mask[NUMA_MAXNODES / 64];
+
+        if (node >= NUMA_MAXNODES)
+                eoutput("Invalid node: %u", node);
+
+        adr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (adr == MAP_FAILED)
+                eoutput("mmap(): Can't allocate memory");
+
+        memset(mask, 0x00, sizeof(mask));
+        mask[node / 64] = 1ULL << (node % 64);
+
+        /* Not fatal, e.g., mbind() is disabled in a container */
+        if (syscall(__NR_mbind, adr, len, MPOL_BIND,
+                                mask, NUMA_MAXNODES + 1, 0) == -1 &&
+                        num_nodes() > 1)
+                cerr << "mbind(): Can't bind memory to node " << node <<
+                        ": " << strerror(errno) << endl;
+
+        return (uint32_t *)adr;
+}
+
+void
+numa_utils::free_on_node(uint32_t *adr, uint64_t len)
+{
+        munmap(adr, len);
+}
+
+int
+numa_utils::node_of(void *adr)
+{
+        int     node;
+
+        if (syscall(__NR_get_mempolicy, &node, NULL, 0,
+                                adr, MPOL_F_NODE | MPOL_F_ADDR) == -1)
+                return -1;
+
+        return node;
+}
+
+/* --- Intra functions below --- */
+
+/* It reads a sysfs list of ranges, e.g., "0-3,8,10-11" into a bit mask */
+bool
+__read_list(const char *path, uint64_t *mask, uint32_t nbits)
+{
+        FILE            *fp;
+        char            *p;
+        char            *end;
+        char            buf[4096];
+        unsigned long   lo;
+        unsigned long   hi;
+
+        memset(mask, 0x00, nbits / 8);
+
+        fp = fopen(path, "r");
+
+        if (fp == NULL)
+                return false;
+
+        p = fgets(buf, sizeof(buf), fp);
+        fclose(fp);
+
+        if (p == NULL)
+                return false;
+
+        while (*p != '\0' && *p != '\n') {
+                lo = hi = strtoul(p, &end, 10);
+
+                if (end == p)
+                        return false;
+
+                if (*end == '-')
+                        hi = strtoul(end + 1, &end, 10);
+
+                for (; lo <= hi && lo < nbits; lo++)
+                        mask[lo / 64] |= 1ULL << (lo % 64);
+
+                p = (*end == ',')? end + 1 : end;
+        }
+
+        return true;
+}
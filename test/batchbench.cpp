@@ -0,0 +1,219 @@
+/*-----------------------------------------------------------------------------
+ *  batchbench.cpp - A benchmark for BatchDecoder. Queries decode lists
+ *      of some terms picked at random from lists larger than caches,
+ *      so each list starts with cache misses. Lists are decoded one by
+ *      one, with prefetches, and in turn a block at a time.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "encoders.hpp"
+#include "decoders.hpp"
+
+using namespace std;
+
+/* Compressed lists are placed in 256MiB, larger than a last-level cache */
+#define CMPWORDS        (1U << 26)
+
+/* Lengths of short to mid-size lists, where heads of lists matter */
+#define MINLEN          32
+#define MAXLEN          512
+
+#define MAX_TERMS       BATCH_MAXWAYS
+#define NQUERIES        20000
+#define NTRIALS         3
+
+static void __usage(const char *msg, ...);
+
+struct __coders_list {
+        const char      *name;
+        int             encID;
+        int             decID;
+};
+
+/* Coders with block decoders */
+static __coders_list __clist[] = {
+        {"simple16", E_SIMPLE16, D_SIMPLE16},
+        {"p4delta", E_P4D, D_P4D},
+        {"vsesimple-v2", E_VSESIMPLEV2, D_VSESIMPLEV2}
+};
+
+/* Ways of decoding a batch */
+#define MODE_PLAIN      0
+#define MODE_PREFETCH   1
+#define MODE_INTERLEAVE 2
+
+static const char *__modes[] = {
+        "plain", "prefetch", "interleave"
+};
+
+int
+main(int argc, char **argv)
+{
+        char            *end;
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        m;
+        uint32_t        q;
+        uint32_t        t;
+        uint32_t        T;
+        uint32_t        nlists;
+        uint32_t        cpos;
+        uint32_t        csize;
+        uint64_t        nints;
+        uint32_t        *gaps;
+        uint32_t        *tmp;
+        uint32_t        *cmp;
+        uint32_t        *outs;
+        uint32_t        *check;
+        uint32_t        *lpos;
+        uint32_t        *llen;
+        double          st;
+        double          best;
+        BatchList       lists[MAX_TERMS];
+
+        T = 16;
+
+        if (argc > 2)
+                __usage(NULL);
+
+        if (argc == 2) {
+                T = strtol(argv[1], &end, 10);
+
+                if (T == 0 || T > MAX_TERMS)
+                        __usage("Invalid # of terms: %d\n", T);
+        }
+
+        gaps = new uint32_t[MAXLEN + TAIL_MERGIN];
+        tmp = new uint32_t[__cmp_bound(MAXLEN)];
+        cmp = new uint32_t[CMPWORDS];
+        outs = new uint32_t[MAX_TERMS * (MAXLEN + TAIL_MERGIN)];
+        check = new uint32_t[MAX_TERMS * (MAXLEN + TAIL_MERGIN)];
+        lpos = new uint32_t[CMPWORDS / MINLEN];
+        llen = new uint32_t[CMPWORDS / MINLEN];
+
+        if (gaps == NULL || tmp == NULL || cmp == NULL || outs == NULL ||
+                        check == NULL || lpos == NULL || llen == NULL)
+                eoutput("Can't allocate memory");
+
+        cout << "# coder terms mode ns/int" << endl;
+
+        for (i = 0; i < __array_size(__clist); i++) {
+                srand(0);
+
+                /* Fill the area with lists of d-gaps mostly small */
+                for (nlists = 0, cpos = 0; ; nlists++) {
+                        llen[nlists] = MINLEN + rand() % (MAXLEN - MINLEN);
+
+                        for (k = 0; k < llen[nlists]; k++)
+                                gaps[k] = (rand() % 8 == 0)?
+                                        rand() & 0xfff : rand() & 0x3f;
+
+                        (encoders[__clist[i].encID])(gaps,
+                                        llen[nlists], tmp, csize);
+
+                        if (cpos + csize > CMPWORDS)
+                                break;
+
+                        memcpy(cmp + cpos, tmp, csize * sizeof(uint32_t));
+                        lpos[nlists] = cpos;
+                        cpos += csize;
+                }
+
+                for (m = MODE_PLAIN; m <= MODE_INTERLEAVE; m++) {
+                        for (t = 0, best = 0.0; t < NTRIALS; t++) {
+                                /* Queries differ in trials not to hit caches */
+                                srand(1 + t + m * NTRIALS);
+
+                                for (q = 0, st = 0.0, nints = 0; q < NQUERIES; q++) {
+                                        for (j = 0; j < T; j++) {
+                                                k = rand() % nlists;
+
+                                                lists[j].in = cmp + lpos[k];
+                                                lists[j].csize = ((k + 1 < nlists)?
+                                                        lpos[k + 1] : cpos) - lpos[k];
+                                                lists[j].num = llen[k];
+                                                lists[j].out = outs + j * (MAXLEN + TAIL_MERGIN);
+                                                nints += llen[k];
+                                        }
+
+                                        st -= int_utils::get_time();
+
+                                        if (m == MODE_INTERLEAVE)
+                                                BatchDecoder::decodeInterleaved(
+                                                        blockDecoders[__clist[i].decID],
+                                                        lists, T, BATCH_NWAYS);
+                                        else
+                                                BatchDecoder::decodeLists(
+                                                        decoders[__clist[i].decID],
+                                                        lists, T, (m == MODE_PLAIN)?
+                                                        0 : BATCH_PFDIST);
+
+                                        st += int_utils::get_time();
+
+                                        /* A last batch is validated with a plain decoder */
+                                        if (q == NQUERIES - 1) {
+                                                for (j = 0; j < T; j++) {
+                                                        (decoders[__clist[i].decID])(
+                                                                lists[j].in, lists[j].csize,
+                                                                check, lists[j].num);
+
+                                                        if (memcmp(check, lists[j].out,
+                                                                lists[j].num * sizeof(uint32_t)) != 0)
+                                                                cerr << "Decoding Exception: " <<
+                                                                        __modes[m] << endl;
+                                                }
+                                        }
+                                }
+
+                                st = st * 1.0e9 / nints;
+
+                                if (t == 0 || st < best)
+                                        best = st;
+                        }
+
+                        cout << __clist[i].name << " " << T << " " << __modes[m] <<
+                                " " << fixed << setprecision(3) << best << endl;
+                        cout.unsetf(ios::fixed);
+                }
+        }
+
+        delete[] gaps;
+        delete[] tmp;
+        delete[] cmp;
+        delete[] outs;
+        delete[] check;
+        delete[] lpos;
+        delete[] llen;
+
+        return EXIT_SUCCESS;
+}
+
+/*--- Intra functions below ---*/
+
+void
+__usage(const char *msg, ...)
+{
+        cout << "Usage: batchbench [<# of terms>]" << endl;
+
+        if (msg != NULL) {
+                va_list vargs;
+
+                va_start(vargs, msg);
+                vfprintf(stdout, msg, vargs);
+                va_end(vargs);
+
+                cout << endl;
+        }
+
+        exit(1);
+}
@@ -0,0 +1,195 @@
+/*-----------------------------------------------------------------------------
+ *  cursorbench.cpp - A benchmark for PostingCursor against decodeArray().
+ *      A query looks for a first docID not less than a target at some
+ *      fraction of a list, so a cursor stops early while decodeArray()
+ *      expands the whole list.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "encoders.hpp"
+#include "decoders.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+#define MAX_N           100000000
+#define MIN_N           1024
+#define NTRIALS         5
+
+/* # of integers decoded in a trial, so that short lists are repeated */
+#define NTRIAL_INTS     (1U << 24)
+
+static void __usage(const char *msg, ...);
+
+struct __coders_list {
+        const char      *name;
+        int             encID;
+        int             decID;
+};
+
+/* Coders with block decoders */
+static __coders_list __clist[] = {
+        {"simple9", E_SIMPLE9, D_SIMPLE9},
+        {"simple16", E_SIMPLE16, D_SIMPLE16},
+        {"p4delta", E_P4D, D_P4D},
+        {"optp4delta", E_OPTP4D, D_OPTP4D},
+        {"vsesimple-v1", E_VSESIMPLEV1, D_VSESIMPLEV1},
+        {"vsesimple-v2", E_VSESIMPLEV2, D_VSESIMPLEV2}
+};
+
+/* Fractions of a list where targets are */
+static double __fracs[] = {
+        0.01, 0.1, 1.0
+};
+
+int
+main(int argc, char **argv)
+{
+        char            *end;
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        t;
+        uint32_t        r;
+        uint32_t        N;
+        uint32_t        R;
+        uint32_t        d;
+        uint32_t        res;
+        uint32_t        prev;
+        uint32_t        *docs;
+        uint32_t        *gaps;
+        uint32_t        *list;
+        uint32_t        *cmp_array;
+        uint32_t        cmp_size;
+        double          st;
+        double          full;
+        double          lazy;
+
+        N = 1 << 20;
+
+        if (argc > 2)
+                __usage(NULL);
+
+        if (argc == 2) {
+                N = strtol(argv[1], &end, 10);
+
+                if (N >= MAX_N || N < MIN_N)
+                        __usage("Invalid N: %d\n", N);
+        }
+
+        docs = new uint32_t[N];
+        gaps = new uint32_t[N + TAIL_MERGIN];
+        list = new uint32_t[N + TAIL_MERGIN];
+        cmp_array = new uint32_t[__cmp_bound(N)];
+
+        if (docs == NULL || gaps == NULL ||
+                        list == NULL || cmp_array == NULL)
+                eoutput("Can't allocate memory");
+
+        srand(0);
+
+        /* d-gaps of docIDs are mostly small with a few large ones */
+        for (i = 0, docs[0] = 0; i < N - 1; i++) {
+                gaps[i] = (rand() % 16 == 0)? rand() & 0xfff : rand() & 0xf;
+                docs[i + 1] = docs[i] + gaps[i] + 1;
+        }
+
+        R = (N < NTRIAL_INTS)? NTRIAL_INTS / N : 1;
+
+        cout << "# coder fraction full(ns/query) cursor(ns/query)" << endl;
+
+        for (i = 0; i < __array_size(__clist); i++) {
+                (encoders[__clist[i].encID])(gaps, N - 1, cmp_array, cmp_size);
+
+                for (j = 0; j < __array_size(__fracs); j++) {
+                        d = docs[(uint32_t)((N - 1) * __fracs[j])];
+
+                        /* Decode a whole list, and search a target */
+                        for (t = 0, full = 0.0; t < NTRIALS; t++) {
+                                st = int_utils::get_time();
+
+                                for (r = 0; r < R; r++) {
+                                        (decoders[__clist[i].decID])(cmp_array,
+                                                        cmp_size, list, N - 1);
+
+                                        for (k = 0, prev = docs[0]; k < N - 1; k++) {
+                                                prev += list[k] + 1;
+                                                list[k] = prev;
+                                        }
+
+                                        res = *lower_bound(list, list + N - 1, d);
+                                }
+
+                                st = int_utils::get_time() - st;
+
+                                if (t == 0 || st < full)
+                                        full = st;
+                        }
+
+                        if (res != d)
+                                cerr << "Search Exception: " << res << " != " << d << endl;
+
+                        /* A cursor decodes blocks up to a target */
+                        for (t = 0, lazy = 0.0; t < NTRIALS; t++) {
+                                st = int_utils::get_time();
+
+                                for (r = 0; r < R; r++) {
+                                        PostingCursor   cur(blockDecoders[__clist[i].decID],
+                                                        cmp_array, N, docs[0]);
+
+                                        res = cur.nextGEQ(d);
+                                }
+
+                                st = int_utils::get_time() - st;
+
+                                if (t == 0 || st < lazy)
+                                        lazy = st;
+                        }
+
+                        if (res != d)
+                                cerr << "Cursor Exception: " << res << " != " << d << endl;
+
+                        cout << __clist[i].name << " " << __fracs[j] << " " <<
+                                fixed << setprecision(1) <<
+                                full * 1.0e9 / R << " " << lazy * 1.0e9 / R << endl;
+                        cout.unsetf(ios::fixed);
+                }
+        }
+
+        delete[] docs;
+        delete[] gaps;
+        delete[] list;
+        delete[] cmp_array;
+
+        return EXIT_SUCCESS;
+}
+
+/*--- Intra functions below ---*/
+
+void
+__usage(const char *msg, ...)
+{
+        cout << "Usage: cursorbench [<N>]" << endl;
+
+        if (msg != NULL) {
+                va_list vargs;
+
+                va_start(vargs, msg);
+                vfprintf(stdout, msg, vargs);
+                va_end(vargs);
+
+                cout << endl;
+        }
+
+        exit(1);
+}
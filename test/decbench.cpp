@@ -57,7 +57,11 @@ static __coders_list __clist[] = {
         {"vserest", E_VSEREST, D_VSEREST},
         {"vsehybrid", E_VSEHYB, D_VSEHYB},
         {"vsesimple-v1", E_VSESIMPLEV1, D_VSESIMPLEV1},
-        {"vsesimple-v2", E_VSESIMPLEV2, D_VSESIMPLEV2}
+        {"vsesimple-v2", E_VSESIMPLEV2, D_VSESIMPLEV2},
+        {"eliasfano", E_EF, D_EF},
+        {"p-eliasfano", E_PEF, D_PEF},
+        {"vseblocks-ans", E_VSEBLOCKSANS, D_VSEBLOCKSANS},
+        {"simdbp128", E_SIMDBP128, D_SIMDBP128}
 };
 
 static int32_t _init_rand;
@@ -104,12 +108,12 @@ main(int argc, char **argv)
         /* Generate test data sets */
         list1 = new uint32_t[N + TAIL_MERGIN];
         list2 = new uint32_t[N + TAIL_MERGIN];
-        cmp_array = new uint32_t[MAXLEN + TAIL_MERGIN];
+        cmp_array = new uint32_t[__cmp_bound(N)];
 
         if (list1 == NULL || list2 == NULL || cmp_array == NULL)
                 eoutput("Can't allocate memory");
 
-        if (__clist[nlist].encID != E_BINARYIPL) {
+        if (!__enc_absolute(__clist[nlist].encID)) {
                 for (i = 0; i < N; i++)
                         list1[i] = __get_random(L);
         } else {
@@ -0,0 +1,180 @@
+/*-----------------------------------------------------------------------------
+ *  numabench.cpp - A benchmark for decoding lists local and remote to
+ *      a thread on NUMA nodes. Lists larger than caches are placed on
+ *      each node in turn, and a thread pinned to each node decodes them
+ *      in order and at random, so bandwidth and latency across nodes
+ *      are seen.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "encoders.hpp"
+#include "decoders.hpp"
+#include "utils/numa_utils.hpp"
+
+using namespace std;
+
+/* Compressed lists are placed in 128MiB, larger than a last-level cache */
+#define CMPWORDS        (1U << 25)
+
+/* Lengths of short to mid-size lists */
+#define MINLEN          32
+#define MAXLEN          512
+
+#define NRANDOM         (1U << 18)
+#define NTRIALS         3
+
+struct __coders_list {
+        const char      *name;
+        int             encID;
+        int             decID;
+};
+
+static __coders_list __clist[] = {
+        {"p4delta", E_P4D, D_P4D},
+        {"vsesimple-v2", E_VSESIMPLEV2, D_VSESIMPLEV2}
+};
+
+int
+main(int argc, char **argv)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        r;
+        uint32_t        t;
+        uint32_t        c;
+        uint32_t        m;
+        uint32_t        nnodes;
+        uint32_t        nlists;
+        uint32_t        cpos;
+        uint32_t        csize;
+        uint64_t        nints;
+        uint32_t        *gaps;
+        uint32_t        *tmp;
+        uint32_t        *cmp;
+        uint32_t        *local;
+        uint32_t        *out;
+        uint32_t        *lpos;
+        uint32_t        *llen;
+        uint32_t        *order;
+        double          st;
+        double          seq;
+        double          rnd;
+
+        nnodes = numa_utils::num_nodes();
+
+        gaps = new uint32_t[MAXLEN + TAIL_MERGIN];
+        tmp = new uint32_t[__cmp_bound(MAXLEN)];
+        cmp = new uint32_t[CMPWORDS + 1];
+        out = new uint32_t[MAXLEN + TAIL_MERGIN];
+        lpos = new uint32_t[CMPWORDS / MINLEN + 1];
+        llen = new uint32_t[CMPWORDS / MINLEN];
+        order = new uint32_t[NRANDOM];
+
+        if (gaps == NULL || tmp == NULL || cmp == NULL || out == NULL ||
+                        lpos == NULL || llen == NULL || order == NULL)
+                eoutput("Can't allocate memory");
+
+        cout << "# " << nnodes << " node(s)" << endl;
+        cout << "# coder cpu_node mem_node seq(ns/int) random(ns/int)" << endl;
+
+        for (i = 0; i < __array_size(__clist); i++) {
+                srand(0);
+
+                for (nlists = 0, cpos = 0; ; nlists++) {
+                        llen[nlists] = MINLEN + rand() % (MAXLEN - MINLEN);
+
+                        for (k = 0; k < llen[nlists]; k++)
+                                gaps[k] = (rand() % 8 == 0)?
+                                        rand() & 0xfff : rand() & 0x3f;
+
+                        (encoders[__clist[i].encID])(gaps,
+                                        llen[nlists], tmp, csize);
+
+                        if (cpos + csize > CMPWORDS)
+                                break;
+
+                        memcpy(cmp + cpos, tmp, csize * sizeof(uint32_t));
+                        lpos[nlists] = cpos;
+                        cpos += csize;
+                }
+
+                lpos[nlists] = cpos;
+
+                for (r = 0; r < NRANDOM; r++)
+                        order[r] = rand() % nlists;
+
+                for (c = 0; c < nnodes; c++) {
+                        if (!numa_utils::pin_thread(c))
+                                continue;
+
+                        for (m = 0; m < nnodes; m++) {
+                                local = numa_utils::alloc_on_node(
+                                                (cpos + TAIL_MERGIN) * sizeof(uint32_t), m);
+                                memcpy(local, cmp, cpos * sizeof(uint32_t));
+
+                                if (numa_utils::node_of(local) != (int)m)
+                                        cerr << "Memory not on node " << m << endl;
+
+                                /* Lists in order, where bandwidth matters */
+                                for (t = 0, seq = 0.0; t < NTRIALS; t++) {
+                                        st = int_utils::get_wall_time();
+
+                                        for (k = 0, nints = 0; k < nlists; k++) {
+                                                (decoders[__clist[i].decID])(local + lpos[k],
+                                                        lpos[k + 1] - lpos[k], out, llen[k]);
+                                                nints += llen[k];
+                                        }
+
+                                        st = (int_utils::get_wall_time() - st) * 1.0e9 / nints;
+
+                                        if (t == 0 || st < seq)
+                                                seq = st;
+                                }
+
+                                /* Lists at random, where latency matters */
+                                for (t = 0, rnd = 0.0; t < NTRIALS; t++) {
+                                        st = int_utils::get_wall_time();
+
+                                        for (r = 0, nints = 0; r < NRANDOM; r++) {
+                                                k = order[(r + t * (NRANDOM / NTRIALS)) % NRANDOM];
+
+                                                (decoders[__clist[i].decID])(local + lpos[k],
+                                                        lpos[k + 1] - lpos[k], out, llen[k]);
+                                                nints += llen[k];
+                                        }
+
+                                        st = (int_utils::get_wall_time() - st) * 1.0e9 / nints;
+
+                                        if (t == 0 || st < rnd)
+                                                rnd = st;
+                                }
+
+                                cout << __clist[i].name << " " << c << " " << m << " " <<
+                                        fixed << setprecision(3) << seq << " " << rnd << endl;
+                                cout.unsetf(ios::fixed);
+
+                                numa_utils::free_on_node(local,
+                                                (cpos + TAIL_MERGIN) * sizeof(uint32_t));
+                        }
+                }
+        }
+
+        delete[] gaps;
+        delete[] tmp;
+        delete[] cmp;
+        delete[] out;
+        delete[] lpos;
+        delete[] llen;
+        delete[] order;
+
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,307 @@
+/*-----------------------------------------------------------------------------
+ *  partbench.cpp - A benchmark to measure decoding costs of partitions
+ *      in VSE coders. A cost of a partition is a slope of decoding time
+ *      over # of partitions in lists of alternating runs of 0 and 32-bit
+ *      integers, and a cost of an integer per width is what remains in
+ *      a list of integers of the width. They are printed in the order
+ *      of setDecodeCost() in the coders.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "encoders.hpp"
+#include "decoders.hpp"
+
+#include <getopt.h>
+
+using namespace std;
+
+/* A single block of VSEncodingBlocks, so that descriptors are found */
+#define N               VSENCODING_BLOCKSZ
+#define NTRIALS         5
+
+/* # of integers decoded in a trial */
+#define NTRIAL_INTS     (1U << 22)
+
+/* Lengths of runs in lists to measure costs of partitions */
+#define MINRUN          1
+#define MAXRUN          256
+
+/* Widths of partitions in VSE coders */
+static uint32_t __widths[] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 16, 20, 32
+};
+
+static void __usage(const char *msg, ...);
+static uint32_t __parts_vseblocks(uint32_t *cmp, uint32_t csize);
+static uint32_t __parts_vseans(uint32_t *cmp, uint32_t csize);
+static uint32_t __parts_vsesimplev1(uint32_t *cmp, uint32_t csize);
+static uint32_t __parts_vsesimplev2(uint32_t *cmp, uint32_t csize);
+static double __measure(int encID, int decID,
+                uint32_t *list, uint32_t *cmp, uint32_t *out, uint32_t &csize);
+
+struct __coders_list {
+        const char      *name;
+        int             encID;
+        int             decID;
+
+        /* # of partitions from 8-bit descriptors in a compressed list */
+        uint32_t        (*parts)(uint32_t *cmp, uint32_t csize);
+        void            (*setcost)(double lambda, double partNs, double *intNs);
+};
+
+static __coders_list __clist[] = {
+        {"vseblocks", E_VSEBLOCKS, D_VSEBLOCKS,
+                __parts_vseblocks, VSEncodingBlocks::setDecodeCost},
+        {"vseblocks-ans", E_VSEBLOCKSANS, D_VSEBLOCKSANS,
+                __parts_vseans, VSEncodingBlocks::setDecodeCost},
+        {"vsesimple-v1", E_VSESIMPLEV1, D_VSESIMPLEV1,
+                __parts_vsesimplev1, VSEncodingSimpleV1::setDecodeCost},
+        {"vsesimple-v2", E_VSESIMPLEV2, D_VSESIMPLEV2,
+                __parts_vsesimplev2, VSEncodingSimpleV2::setDecodeCost}
+};
+
+int
+main(int argc, char **argv)
+{
+        int             opt;
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        K;
+        uint32_t        b;
+        uint32_t        P;
+        uint32_t        npts;
+        uint32_t        *list1;
+        uint32_t        *list2;
+        uint32_t        *cmp_array;
+        uint32_t        cmp_size;
+        double          lambda;
+        double          x;
+        double          y;
+        double          sx;
+        double          sy;
+        double          sxx;
+        double          sxy;
+        double          partNs;
+        double          t;
+        double          intNs[__array_size(__widths)];
+
+        lambda = -1.0;
+
+        while ((opt = getopt(argc, argv, "l:")) != -1) {
+                switch (opt) {
+                case 'l':
+                        lambda = atof(optarg);
+
+                        if (lambda < 0.0)
+                                __usage("Invalid weight: %s", optarg);
+                        break;
+                default:
+                        __usage(NULL);
+                }
+        }
+
+        if (optind != argc)
+                __usage(NULL);
+
+        list1 = new uint32_t[N + TAIL_MERGIN];
+        list2 = new uint32_t[N + TAIL_MERGIN];
+        cmp_array = new uint32_t[__cmp_bound(N)];
+
+        if (list1 == NULL || list2 == NULL || cmp_array == NULL)
+                eoutput("Can't allocate memory");
+
+        srand(0);
+
+        for (i = 0; i < __array_size(__clist); i++) {
+                /*
+                 * Runs of 0 and 32-bit integers form partitions by
+                 * themselves if long enough, and shorter runs merged
+                 * into 32-bit partitions are out of the fit.
+                 */
+                for (K = MINRUN, npts = 0, sx = sy = sxx = sxy = 0.0;
+                                K <= MAXRUN; K <<= 1) {
+                        for (k = 0; k < N; k++)
+                                list1[k] = ((k / K) & 1)? 0x80000000U | rand() : 0;
+
+                        t = __measure(__clist[i].encID, __clist[i].decID,
+                                        list1, cmp_array, list2, cmp_size);
+                        P = (__clist[i].parts)(cmp_array, cmp_size);
+
+                        if ((uint64_t)P * K < N - 4 * K)
+                                continue;
+
+                        x = (double)P / N;
+                        y = t / N;
+
+                        sx += x;
+                        sy += y;
+                        sxx += x * x;
+                        sxy += x * y;
+                        npts++;
+                }
+
+                if (npts < 2)
+                        eoutput("Too few points to fit: %s", __clist[i].name);
+
+                partNs = (sxy - sx * sy / npts) / (sxx - sx * sx / npts);
+
+                if (partNs < 0.0)
+                        partNs = 0.0;
+
+                /* What remains of lists with a single width */
+                for (j = 0; j < __array_size(__widths); j++) {
+                        b = __widths[j];
+
+                        for (k = 0; k < N; k++)
+                                list1[k] = (b == 0)? 0 : (1U << (b - 1)) |
+                                        (rand() & ((1U << (b - 1)) - 1));
+
+                        t = __measure(__clist[i].encID, __clist[i].decID,
+                                        list1, cmp_array, list2, cmp_size);
+                        P = (__clist[i].parts)(cmp_array, cmp_size);
+
+                        intNs[j] = (t - P * partNs) / N;
+
+                        if (intNs[j] < 0.0)
+                                intNs[j] = 0.0;
+                }
+
+                cout << "# " << __clist[i].name << ": part_ns int_ns[widths]" << endl;
+                cout << __clist[i].name << " " << fixed << setprecision(3) << partNs;
+
+                for (j = 0; j < __array_size(__widths); j++)
+                        cout << " " << intNs[j];
+
+                cout << endl;
+
+                if (lambda < 0.0)
+                        continue;
+
+                /*
+                 * Show a trade-off with the costs above in d-gaps of
+                 * mixed widths, where small partitions pay off in size.
+                 */
+                for (k = 0; k < N; k++) {
+                        b = rand() % 4;
+                        b = (b == 0)? rand() % 24 : rand() % 4;
+                        list1[k] = rand() & ((1U << b) - 1);
+                }
+
+                for (j = 0; j < 2; j++) {
+                        (__clist[i].setcost)((j == 0)? 0.0 : lambda,
+                                        partNs, intNs);
+
+                        t = __measure(__clist[i].encID, __clist[i].decID,
+                                        list1, cmp_array, list2, cmp_size);
+                        P = (__clist[i].parts)(cmp_array, cmp_size);
+
+                        cout << "# lambda=" << ((j == 0)? 0.0 : lambda) <<
+                                " bits/int=" << 32.0 * cmp_size / N <<
+                                " ns/int=" << t / N << " parts=" << P << endl;
+                }
+
+                (__clist[i].setcost)(0.0, partNs, intNs);
+        }
+
+        delete[] list1;
+        delete[] list2;
+        delete[] cmp_array;
+
+        return EXIT_SUCCESS;
+}
+
+/*--- Intra functions below ---*/
+
+void
+__usage(const char *msg, ...)
+{
+        cout << "Usage: partbench [-l Weight]" << endl;
+        cout << "  -l: show sizes and speeds with costs weighted in bits per ns" << endl;
+
+        if (msg != NULL) {
+                va_list vargs;
+
+                va_start(vargs, msg);
+                vfprintf(stdout, msg, vargs);
+                va_end(vargs);
+
+                cout << endl;
+        }
+
+        exit(1);
+}
+
+/* Descriptors follow integers in a block */
+uint32_t
+__parts_vseblocks(uint32_t *cmp, uint32_t csize)
+{
+        return 4 * (csize - VSEncodingBlocks::descOffset(cmp));
+}
+
+/* # of words for descriptors is in the upper 16 bits of a header */
+uint32_t
+__parts_vseans(uint32_t *cmp, uint32_t csize)
+{
+        return 4 * (cmp[0] >> 16);
+}
+
+/* A first word is # of words for descriptors */
+uint32_t
+__parts_vsesimplev1(uint32_t *cmp, uint32_t csize)
+{
+        return 4 * cmp[0];
+}
+
+/* Two words point to 4-bit Bs and 8-bit Ks, and Ks go up to the second */
+uint32_t
+__parts_vsesimplev2(uint32_t *cmp, uint32_t csize)
+{
+        return 4 * (cmp[1] - cmp[0]);
+}
+
+/* The best time in ns to decode a list, which is validated */
+double
+__measure(int encID, int decID,
+                uint32_t *list, uint32_t *cmp, uint32_t *out, uint32_t &csize)
+{
+        uint32_t        k;
+        uint32_t        r;
+        uint32_t        t;
+        double          st;
+        double          et;
+        double          best;
+
+        (encoders[encID])(list, N, cmp, csize);
+
+        for (t = 0, best = 0.0; t < NTRIALS; t++) {
+                st = int_utils::get_time();
+
+                for (r = 0; r < NTRIAL_INTS / N; r++)
+                        (decoders[decID])(cmp, csize, out, N);
+
+                et = int_utils::get_time();
+
+                if (t == 0 || et - st < best)
+                        best = et - st;
+        }
+
+        for (k = 0; k < N; k++) {
+                if (list[k] != out[k]) {
+                        cerr << "Decoding Exception(" << k << "): "
+                                << list[k] << " != " << out[k] << endl;
+                        break;
+                }
+        }
+
+        return best * 1.0e9 / (NTRIAL_INTS / N);
+}
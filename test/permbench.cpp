@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------------
+ *  permbench.cpp - A benchmark for the two stages of decoding a block in
+ *      VSEncodingBlocks, i.e., unpacking integers into buckets per width
+ *      and permuting them along descriptors. Blocks have runs of random
+ *      widths, whose max length controls # of partitions. Run it with and
+ *      without OPEN_CODERS_NO_AVX512 in the environment to compare the
+ *      permutation kernels.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "compress/VSEncodingBlocks.hpp"
+
+using namespace std;
+
+#define N               VSENCODING_BLOCKSZ
+#define NTRIALS         5
+
+/* # of integers decoded in a trial */
+#define NTRIAL_INTS     (1U << 24)
+
+/* Max lengths of runs of the same width */
+static uint32_t __maxruns[] = {
+        1, 4, 16, 64, 256
+};
+
+static void __usage(const char *msg, ...);
+
+int
+main(int argc, char **argv)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        m;
+        uint32_t        t;
+        uint32_t        r;
+        uint32_t        b;
+        uint32_t        R;
+        uint32_t        run;
+        uint32_t        csize;
+        uint32_t        *list;
+        uint32_t        *out;
+        uint32_t        *aux;
+        uint32_t        *cmp;
+        uint32_t        *desc;
+        uint32_t        *pblk[VSEBLOCKS_NBUCKETS];
+        uint32_t        *pblk0[VSEBLOCKS_NBUCKETS];
+        double          st;
+        double          et;
+        double          best[3];
+
+        if (argc > 1)
+                __usage(NULL);
+
+        list = new uint32_t[N + TAIL_MERGIN];
+        out = new uint32_t[N + TAIL_MERGIN];
+        aux = new uint32_t[__vseblocks_auxlen(N)];
+        cmp = new uint32_t[__cmp_bound(N)];
+
+        if (list == NULL || out == NULL || aux == NULL || cmp == NULL)
+                eoutput("Can't allocate memory");
+
+        srand(0);
+
+        R = NTRIAL_INTS / N;
+
+        cout << "# AVX-512 kernels: " <<
+                (AVX512Unpack::available()? "on" : "off") << endl;
+        cout << "# maxrun unpack(ns/int) permute(ns/int) decode(ns/int) permute(%)" << endl;
+
+        for (m = 0; m < __array_size(__maxruns); m++) {
+                /* Runs of widths in [0, 20], where a quarter are zeros */
+                for (i = 0; i < N; ) {
+                        run = 1 + rand() % __maxruns[m];
+                        b = (rand() % 4 == 0)? 0 : 1 + rand() % 20;
+
+                        for (k = 0; k < run && i < N; k++, i++)
+                                list[i] = (b == 0)? 0 :
+                                        (1U << (b - 1)) | (rand() & ((1U << (b - 1)) - 1));
+                }
+
+                VSEncodingBlocks::encodeVS(N, list, csize, cmp);
+
+                desc = VSEncodingBlocks::unpackVS(cmp, aux, pblk0);
+
+                for (t = 0, best[0] = best[1] = best[2] = 0.0; t < NTRIALS; t++) {
+                        st = int_utils::get_time();
+
+                        for (r = 0; r < R; r++)
+                                VSEncodingBlocks::unpackVS(cmp, aux, pblk);
+
+                        et = int_utils::get_time();
+
+                        if (t == 0 || et - st < best[0])
+                                best[0] = et - st;
+
+                        st = int_utils::get_time();
+
+                        for (r = 0; r < R; r++) {
+                                memcpy(pblk, pblk0, sizeof(pblk));
+                                VSEncodingBlocks::permuteVS(N, desc, pblk, out);
+                        }
+
+                        et = int_utils::get_time();
+
+                        if (t == 0 || et - st < best[1])
+                                best[1] = et - st;
+
+                        st = int_utils::get_time();
+
+                        for (r = 0; r < R; r++)
+                                VSEncodingBlocks::decodeVS(N, cmp, out, aux);
+
+                        et = int_utils::get_time();
+
+                        if (t == 0 || et - st < best[2])
+                                best[2] = et - st;
+                }
+
+                /* Validation check */
+                for (k = 0; k < N; k++) {
+                        if (list[k] != out[k]) {
+                                cerr << "Decoding Exception(" << k << "): "
+                                        << list[k] << " != " << out[k] << endl;
+                                break;
+                        }
+                }
+
+                cout << __maxruns[m] << " " << fixed << setprecision(3) <<
+                        best[0] * 1.0e9 / N / R << " " <<
+                        best[1] * 1.0e9 / N / R << " " <<
+                        best[2] * 1.0e9 / N / R << " " << setprecision(1) <<
+                        100.0 * best[1] / (best[0] + best[1]) << endl;
+                cout.unsetf(ios::fixed);
+        }
+
+        delete[] list;
+        delete[] out;
+        delete[] aux;
+        delete[] cmp;
+
+        return EXIT_SUCCESS;
+}
+
+/*--- Intra functions below ---*/
+
+void
+__usage(const char *msg, ...)
+{
+        cout << "Usage: permbench" << endl;
+
+        if (msg != NULL) {
+                va_list vargs;
+
+                va_start(vargs, msg);
+                vfprintf(stdout, msg, vargs);
+                va_end(vargs);
+
+                cout << endl;
+        }
+
+        exit(1);
+}
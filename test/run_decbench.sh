@@ -26,6 +26,10 @@ N="8 128 2048 131072"
 #       vsehybrid: VSEncodingBlocksHybrid, VSEncodingBlocksHybrid
 #       vsesimple-v1: VSEncodingSimpleV1, VSEncodingSimpleV2
 #       vsesimple-v2: VSEncodingSimpleV1, VSEncodingSimpleV2
+#       eliasfano: Elias-Fano, Elias-Fano
+#       p-eliasfano: Partitioned Elias-Fano, Partitioned Elias-Fano
+#       vseblocks-ans: VSEncodingBlocksANS, VSEncodingBlocksANS
+#       simdbp128: SIMDBP128, SIMDBP128
 I="vseblocks vse-r vsesimple-v1 vsesimple-v2"
 
 if [ ! -x ./test/decbench ]; then
@@ -0,0 +1,198 @@
+/*-----------------------------------------------------------------------------
+ *  tocbench.cpp - A benchmark for CompactTOC. A TOC of millions of lists
+ *      with Zipf-like lengths, most of which are short lists in shared
+ *      blocks, is compacted, and the latency of looking up an entry and
+ *      a next position is compared with a raw TOC at random and in order.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "open_coders.hpp"
+#include "compress/CompactTOC.hpp"
+
+#include <cmath>
+
+using namespace std;
+
+#define NLOOKUPS        (1U << 22)
+#define NTRIALS         3
+
+static void __usage(const char *msg, ...);
+
+/* Lookups at random, and a scan of all the lists in order */
+#define MODE_RANDOM     0
+#define MODE_SEQ        1
+
+static const char *__modes[] = {
+        "random", "sequential"
+};
+
+int
+main(int argc, char **argv)
+{
+        char            *end;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        m;
+        uint32_t        t;
+        uint32_t        n;
+        uint32_t        num;
+        uint32_t        first;
+        uint32_t        off;
+        uint32_t        nlook;
+        uint32_t        *toc;
+        uint32_t        *idx;
+        uint64_t        pos;
+        uint64_t        blk;
+        uint64_t        cmplen;
+        uint64_t        sum;
+        uint64_t        rsum;
+        double          u;
+        double          st;
+        double          best[2];
+        CompactTOC      *ctoc;
+
+        n = 8;
+
+        if (argc > 2)
+                __usage(NULL);
+
+        if (argc == 2) {
+                n = strtol(argv[1], &end, 10);
+
+                if (n == 0 || n > 256)
+                        __usage("Invalid # of lists in millions: %d\n", n);
+        }
+
+        n *= 1000000;
+
+        toc = new uint32_t[(uint64_t)n * EACH_HEADER_TOC_SZ];
+        idx = new uint32_t[NLOOKUPS];
+
+        if (toc == NULL || idx == NULL)
+                eoutput("Can't allocate memory");
+
+        srand(0);
+
+        /* Entries laid out as encoders write them */
+        for (j = 0, cmplen = 0, off = 0, blk = 0; j < n; j++) {
+                u = (rand() + 1.0) / (RAND_MAX + 1.0);
+                num = 1 + (uint32_t)std::min(1.0e7, 1.0 / pow(u, 1.2));
+                first = rand() % 50000000;
+
+                if (num <= SKIP) {
+                        if (off == 0 || off + num > SHRBLKLEN) {
+                                blk = cmplen;
+                                cmplen += 1 + num;
+                                off = 0;
+                        }
+
+                        pos = __toc_short(blk, off);
+                        off += num;
+                } else {
+                        pos = cmplen;
+                        cmplen += num / 3;
+                        off = 0;
+                }
+
+                __toc_put(toc, j, num, first, first + num, pos);
+        }
+
+        for (k = 0; k < NLOOKUPS; k++)
+                idx[k] = ((uint32_t)rand() * (RAND_MAX + 1U) + rand()) % n;
+
+        st = int_utils::get_time();
+        ctoc = new CompactTOC(toc, n, cmplen);
+
+        if (ctoc == NULL)
+                eoutput("Can't allocate memory");
+
+        cout << "Lists: " << n << endl;
+        cout << "Build: " << int_utils::get_time() - st << " Secs" << endl;
+        cout << "Raw: " << (uint64_t)n * EACH_HEADER_TOC_SZ * sizeof(uint32_t) <<
+                " bytes, " << EACH_HEADER_TOC_SZ * sizeof(uint32_t) * 8.0 <<
+                " bits/entry" << endl;
+        cout << "Compact: " << ctoc->sizeInBytes() << " bytes, " <<
+                ctoc->sizeInBytes() * 8.0 / n << " bits/entry" << endl;
+
+        cout << "# mode raw(ns/lookup) compact(ns/lookup)" << endl;
+
+        for (m = MODE_RANDOM; m <= MODE_SEQ; m++) {
+                nlook = (m == MODE_RANDOM)? NLOOKUPS : n;
+
+                for (t = 0; t < NTRIALS; t++) {
+                        /* An entry and a next position, as decoders read */
+                        st = int_utils::get_time();
+
+                        for (k = 0, rsum = 0; k < nlook; k++) {
+                                j = (m == MODE_RANDOM)? idx[k] : k;
+
+                                rsum += __toc_num(toc, j) + __toc_first(toc, j) +
+                                        __toc_pos(toc, j);
+
+                                rsum += (j + 1 < n)?
+                                        __toc_blkpos(__toc_pos(toc, j + 1)) : cmplen;
+                        }
+
+                        st = (int_utils::get_time() - st) * 1.0e9 / nlook;
+
+                        if (t == 0 || st < best[0])
+                                best[0] = st;
+
+                        st = int_utils::get_time();
+
+                        for (k = 0, sum = 0; k < nlook; k++) {
+                                j = (m == MODE_RANDOM)? idx[k] : k;
+
+                                ctoc->get(j, num, first, pos);
+                                sum += num + first + pos + ctoc->blkPos(j + 1);
+                        }
+
+                        st = (int_utils::get_time() - st) * 1.0e9 / nlook;
+
+                        if (t == 0 || st < best[1])
+                                best[1] = st;
+
+                        if (sum != rsum)
+                                cerr << "Lookup Exception: " << __modes[m] << endl;
+                }
+
+                cout << __modes[m] << " " << fixed << setprecision(3) <<
+                        best[0] << " " << best[1] << endl;
+                cout.unsetf(ios::fixed);
+        }
+
+        delete ctoc;
+        delete[] toc;
+        delete[] idx;
+
+        return EXIT_SUCCESS;
+}
+
+/*--- Intra functions below ---*/
+
+void
+__usage(const char *msg, ...)
+{
+        cout << "Usage: tocbench [<# of lists in millions>]" << endl;
+
+        if (msg != NULL) {
+                va_list vargs;
+
+                va_start(vargs, msg);
+                vfprintf(stdout, msg, vargs);
+                va_end(vargs);
+
+                cout << endl;
+        }
+
+        exit(1);
+}
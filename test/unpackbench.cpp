@@ -0,0 +1,185 @@
+/*-----------------------------------------------------------------------------
+ *  unpackbench.cpp - A micro-benchmark for unpacking functions per width.
+ *      Each list is filled with integers of the same bit width, so that
+ *      decoders spend most of time in unpacking functions of the width.
+ *      Run it with and without OPEN_CODERS_NO_BMI2/OPEN_CODERS_NO_AVX512
+ *      in the environment to compare SIMD kernels with the original ones.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include "encoders.hpp"
+#include "decoders.hpp"
+#include "compress/BMI2Unpack.hpp"
+#include "compress/AVX512Unpack.hpp"
+
+using namespace std;
+
+#define MAX_N           100000000
+#define MIN_N           32
+#define NTRIALS         5
+
+/* # of integers decoded in a trial, so that short lists are repeated */
+#define NTRIAL_INTS     (1U << 24)
+
+/* Widths of unpacking functions below 32 */
+#define __w(b)          (1U << (b))
+#define WIDTHS_ALL      (__w(1) | __w(2) | __w(3) | __w(4) | __w(5) | \
+                        __w(6) | __w(7) | __w(8) | __w(9) | __w(10) | \
+                        __w(11) | __w(12) | __w(16) | __w(20))
+
+static void __usage(const char *msg, ...);
+
+struct __coders_list {
+        const char      *name;
+        int             encID;
+        int             decID;
+        uint32_t        hb;
+        uint32_t        exc;
+        uint32_t        widths;
+};
+
+/*
+ * A coder list to test with widths of unpacking functions. VSE-R drops
+ * leading ones from integers, so they are one bit wider than a given
+ * width. If exc is set, about 1/exc of integers are 8-bit wider than
+ * the others to make PForDelta patch exceptions.
+ */
+static __coders_list __clist[] = {
+        {"p4delta", E_P4D, D_P4D, 0, 0, WIDTHS_ALL | __w(13)},
+        {"p4delta-exc", E_P4D, D_P4D, 0, 10, WIDTHS_ALL | __w(13)},
+        {"vseblocks", E_VSEBLOCKS, D_VSEBLOCKS, 0, 0, WIDTHS_ALL},
+        {"vse-r", E_VSER, D_VSER, 1, 0, WIDTHS_ALL | __w(13)},
+        {"vsesimple-v2", E_VSESIMPLEV2, D_VSESIMPLEV2, 0, 0, WIDTHS_ALL}
+};
+
+int
+main(int argc, char **argv)
+{
+        char            *end;
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        t;
+        uint32_t        r;
+        uint32_t        b;
+        uint32_t        N;
+        uint32_t        R;
+        uint32_t        *list1;
+        uint32_t        *list2;
+        uint32_t        *cmp_array;
+        uint32_t        cmp_size;
+        double          st;
+        double          et;
+        double          best;
+
+        N = 1 << 20;
+
+        if (argc > 2)
+                __usage(NULL);
+
+        if (argc == 2) {
+                N = strtol(argv[1], &end, 10);
+
+                if (N >= MAX_N || N < MIN_N)
+                        __usage("Invalid N: %d\n", N);
+        }
+
+        list1 = new uint32_t[N + TAIL_MERGIN];
+        list2 = new uint32_t[N + TAIL_MERGIN];
+        cmp_array = new uint32_t[__cmp_bound(N)];
+
+        if (list1 == NULL || list2 == NULL || cmp_array == NULL)
+                eoutput("Can't allocate memory");
+
+        srand(0);
+
+        R = (N < NTRIAL_INTS)? NTRIAL_INTS / N : 1;
+
+        cout << "# BMI2 kernels: " <<
+                (BMI2Unpack::available()? "on" : "off") << endl;
+        cout << "# AVX-512 kernels: " <<
+                (AVX512Unpack::available()? "on" : "off") << endl;
+        cout << "# coder width ns/int" << endl;
+
+        for (i = 0; i < __array_size(__clist); i++) {
+                for (j = 1; j < 32; j++) {
+                        if (!(__clist[i].widths & __w(j)))
+                                continue;
+
+                        b = j + __clist[i].hb;
+
+                        /* Integers in [2^(b - 1), 2^b) */
+                        for (k = 0; k < N; k++) {
+                                list1[k] = (1U << (b - 1)) |
+                                        (rand() & ((1U << (b - 1)) - 1));
+
+                                if (__clist[i].exc != 0 &&
+                                                rand() % __clist[i].exc == 0)
+                                        list1[k] <<= 8;
+                        }
+
+                        (encoders[__clist[i].encID])(list1, N,
+                                        cmp_array, cmp_size);
+
+                        for (t = 0, best = 0.0; t < NTRIALS; t++) {
+                                st = int_utils::get_time();
+
+                                for (r = 0; r < R; r++)
+                                        (decoders[__clist[i].decID])(cmp_array,
+                                                        cmp_size, list2, N);
+
+                                et = int_utils::get_time();
+
+                                if (t == 0 || et - st < best)
+                                        best = et - st;
+                        }
+
+                        /* Validation check */
+                        for (k = 0; k < N; k++) {
+                                if (list1[k] != list2[k]) {
+                                        cerr << "Decoding Exception(" << k << "): "
+                                                << list1[k] << " != " << list2[k] << endl;
+                                        break;
+                                }
+                        }
+
+                        cout << __clist[i].name << " " << j << " "
+                                << setprecision(3) << best * 1.0e9 / N / R << endl;
+                }
+        }
+
+        delete[] list1;
+        delete[] list2;
+        delete[] cmp_array;
+
+        return EXIT_SUCCESS;
+}
+
+/*--- Intra functions below ---*/
+
+void
+__usage(const char *msg, ...)
+{
+        cout << "Usage: unpackbench [<N>]" << endl;
+
+        if (msg != NULL) {
+                va_list vargs;
+
+                va_start(vargs, msg);
+                vfprintf(stdout, msg, vargs);
+                va_end(vargs);
+
+                cout << endl;
+        }
+
+        exit(1);
+}
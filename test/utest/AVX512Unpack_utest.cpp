@@ -0,0 +1,89 @@
+/*-----------------------------------------------------------------------------
+ *  AVX512Unpack_utest.cpp - A unit test for AVX-512 unpacking kernels.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/AVX512Unpack.hpp"
+
+#define NVALUES         128
+
+template <uint32_t B>
+static void __avx512_unpack(uint32_t *out, uint32_t *in, uint32_t n)
+        __avx512_target;
+
+template <uint32_t B>
+void
+__avx512_unpack(uint32_t *out, uint32_t *in, uint32_t n)
+{
+        AVX512Unpack::unpack<B>(out, in, n);
+}
+
+/* Pack n values MSB-first, and check unpacked ones */
+template <uint32_t B>
+static void
+__avx512_check(uint32_t n)
+{
+        uint32_t        i;
+        uint32_t        pos;
+        uint32_t        input[NVALUES];
+        uint32_t        output[NVALUES + 1];
+        uint32_t        cdata[B * NVALUES / 32 + 1];
+
+        memset(cdata, 0, sizeof(cdata));
+
+        for (i = 0, pos = 0; i < n; i++, pos += B) {
+                input[i] = (i * 0x9e3779b9U) >> (32 - B);
+
+                if ((pos & 31) + B <= 32) {
+                        cdata[pos >> 5] |= input[i] << (32 - B - (pos & 31));
+                } else {
+                        cdata[pos >> 5] |= input[i] >> ((pos & 31) + B - 32);
+                        cdata[(pos >> 5) + 1] |= input[i] << (64 - B - (pos & 31));
+                }
+        }
+
+        /* Neither a word nor a value out of n should be touched */
+        cdata[(pos + 31) / 32] = ~0U;
+        output[n] = 0xdeadbeef;
+
+        __avx512_unpack<B>(output, cdata, n);
+
+        for (i = 0; i < n; i++)
+                EXPECT_EQ(input[i], output[i]);
+
+        EXPECT_EQ(0xdeadbeef, output[n]);
+}
+
+TEST(AVX512UnpackTest, ValidationUnpackWidths) {
+        if (!AVX512Unpack::available())
+                return;
+
+        __avx512_check<1>(NVALUES);
+        __avx512_check<3>(NVALUES);
+        __avx512_check<8>(NVALUES);
+        __avx512_check<13>(NVALUES);
+        __avx512_check<16>(NVALUES);
+        __avx512_check<20>(NVALUES);
+        __avx512_check<25>(NVALUES);
+}
+
+TEST(AVX512UnpackTest, ValidationUnpackTails) {
+        if (!AVX512Unpack::available())
+                return;
+
+        __avx512_check<5>(1);
+        __avx512_check<7>(17);
+        __avx512_check<11>(45);
+        __avx512_check<20>(99);
+        __avx512_check<25>(127);
+}
@@ -0,0 +1,210 @@
+/*-----------------------------------------------------------------------------
+ *  AppendList_utest.cpp - A unit test for AppendList.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/AppendList.hpp"
+#include "compress/Simple16.hpp"
+#include "compress/PForDelta.hpp"
+#include "compress/VSEncodingBlocks.hpp"
+#include "compress/VSEncodingSimpleV2.hpp"
+
+#define NUM     20000
+
+struct __append_coder {
+        pt2Enc          enc;
+        pt2Dec          dec;
+};
+
+static __append_coder __coders[] = {
+        {Simple16::encodeArray, Simple16::decodeArray},
+        {PForDelta::encodeArray, PForDelta::decodeArray},
+        {VSEncodingBlocks::encodeArray, VSEncodingBlocks::decodeArray},
+        {VSEncodingSimpleV2::encodeArray, VSEncodingSimpleV2::decodeArray}
+};
+
+static void
+__make_docs(uint32_t *docs)
+{
+        uint32_t        i;
+
+        docs[0] = 3;
+
+        for (i = 1; i < NUM; i++)
+                docs[i] = docs[i - 1] + 1 +
+                        ((i % 53 == 0)? rand() & 0xfffff : rand() & 0x3f);
+}
+
+/* A snapshot has the first num docIDs */
+static void
+__check_snapshot(AppendSnapshot &snap, uint32_t *docs,
+                uint32_t num, uint32_t *out)
+{
+        uint32_t        i;
+        uint32_t        d;
+
+        ASSERT_EQ(num, snap.size());
+        ASSERT_EQ(docs[0], snap.firstDoc());
+
+        snap.decodeArray(out);
+
+        for (i = 0, d = docs[0]; i < num - 1; i++) {
+                d += out[i] + 1;
+                ASSERT_EQ(docs[i + 1], d);
+        }
+}
+
+TEST(AppendListTest, Append) {
+        uint32_t        i;
+        uint32_t        *docs = new uint32_t[NUM];
+        uint32_t        *out = new uint32_t[NUM + TAIL_MERGIN];
+        AppendSnapshot  snap;
+
+        srand(0);
+
+        for (int c = 0; c < (int)(sizeof(__coders) / sizeof(__coders[0])); c++) {
+                __make_docs(docs);
+
+                AppendList      list(__coders[c].enc, __coders[c].dec, docs[0]);
+
+                /* Snapshots around block boundaries, and in between */
+                for (i = 1; i < NUM; i++) {
+                        list.append(docs[i]);
+
+                        if (i % APPEND_BLOCKSZ <= 1 || i % 1009 == 0) {
+                                list.snapshot(snap);
+                                __check_snapshot(snap, docs, i + 1, out);
+                        }
+                }
+
+                ASSERT_EQ((uint32_t)NUM, list.size());
+        }
+
+        delete[] docs;
+        delete[] out;
+}
+
+TEST(AppendListTest, OldSnapshot) {
+        uint32_t        *docs = new uint32_t[NUM];
+        uint32_t        *out = new uint32_t[NUM + TAIL_MERGIN];
+        AppendSnapshot  snap;
+
+        srand(0);
+        __make_docs(docs);
+
+        AppendList      list(PForDelta::encodeArray,
+                        PForDelta::decodeArray, docs[0]);
+
+        list.append(docs + 1, 3 * APPEND_BLOCKSZ + 7);
+        list.snapshot(snap);
+
+        /* Sealed blocks are moved to a larger area while growing */
+        list.append(docs + 3 * APPEND_BLOCKSZ + 8, NUM - 3 * APPEND_BLOCKSZ - 8);
+
+        __check_snapshot(snap, docs, 3 * APPEND_BLOCKSZ + 8, out);
+
+        list.snapshot(snap);
+        __check_snapshot(snap, docs, NUM, out);
+
+        EXPECT_LT(snap.sizeInWords(), (uint64_t)NUM);
+
+        delete[] docs;
+        delete[] out;
+}
+
+/* Blocks after a snapshot leave room for its decoders to read past */
+TEST(AppendListTest, SlackAfterSnapshot) {
+        uint64_t        len;
+        uint32_t        *docs = new uint32_t[NUM];
+        uint32_t        *out = new uint32_t[NUM + TAIL_MERGIN];
+        AppendSnapshot  snap;
+
+        srand(0);
+        __make_docs(docs);
+
+        AppendList      list(Simple16::encodeArray,
+                        Simple16::decodeArray, docs[0]);
+
+        list.append(docs + 1, 2 * APPEND_BLOCKSZ);
+        list.snapshot(snap);
+        len = snap.sizeInWords();
+
+        /* A slack record is placed once between blocks */
+        list.snapshot(snap);
+        ASSERT_EQ(len + 1 + TAIL_MERGIN, snap.sizeInWords());
+
+        list.snapshot(snap);
+        ASSERT_EQ(len + 1 + TAIL_MERGIN, snap.sizeInWords());
+        __check_snapshot(snap, docs, 2 * APPEND_BLOCKSZ + 1, out);
+
+        list.append(docs + 2 * APPEND_BLOCKSZ + 1, APPEND_BLOCKSZ);
+        list.snapshot(snap);
+
+        EXPECT_LT(len + 1 + TAIL_MERGIN + 1, snap.sizeInWords());
+        __check_snapshot(snap, docs, 3 * APPEND_BLOCKSZ + 1, out);
+
+        delete[] docs;
+        delete[] out;
+}
+
+/* A writer and a reader are in other threads */
+struct __append_arg {
+        AppendList      *list;
+        uint32_t        *docs;
+};
+
+static void *
+__append_writer(void *arg)
+{
+        uint32_t        i;
+        __append_arg    *a;
+
+        a = (__append_arg *)arg;
+
+        for (i = 1; i < NUM; i += 7)
+                a->list->append(a->docs + i, (i + 7 < NUM)? 7 : NUM - i);
+
+        return NULL;
+}
+
+TEST(AppendListTest, ConcurrentReader) {
+        uint32_t        n;
+        uint32_t        *docs = new uint32_t[NUM];
+        uint32_t        *out = new uint32_t[NUM + TAIL_MERGIN];
+        pthread_t       th;
+        __append_arg    arg;
+        AppendSnapshot  snap;
+
+        srand(0);
+        __make_docs(docs);
+
+        AppendList      list(VSEncodingBlocks::encodeArray,
+                        VSEncodingBlocks::decodeArray, docs[0]);
+
+        arg.list = &list;
+        arg.docs = docs;
+
+        ASSERT_EQ(0, pthread_create(&th, NULL, __append_writer, &arg));
+
+        do {
+                list.snapshot(snap);
+                n = snap.size();
+
+                __check_snapshot(snap, docs, n, out);
+        } while (n < NUM);
+
+        pthread_join(th, NULL);
+
+        delete[] docs;
+        delete[] out;
+}
@@ -0,0 +1,80 @@
+/*-----------------------------------------------------------------------------
+ *  BMI2Unpack_utest.cpp - A unit test for BMI2 unpacking kernels.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/BMI2Unpack.hpp"
+
+template <uint32_t B>
+static void __bmi2_unpack(uint32_t *out, uint32_t *in, uint32_t hb) __bmi2_target;
+
+template <uint32_t B>
+void
+__bmi2_unpack(uint32_t *out, uint32_t *in, uint32_t hb)
+{
+        BMI2Unpack::unpack32<B>(out, in, hb);
+}
+
+/* Pack 32 values MSB-first, and check unpacked ones */
+template <uint32_t B>
+static void
+__bmi2_check(uint32_t hb)
+{
+        uint32_t        i;
+        uint32_t        pos;
+        uint32_t        input[32];
+        uint32_t        output[32];
+        uint32_t        cdata[B + 1];
+
+        memset(cdata, 0, sizeof(cdata));
+
+        for (i = 0, pos = 0; i < 32; i++, pos += B) {
+                input[i] = (i * 0x9e3779b9U) >> (32 - B);
+
+                if ((pos & 31) + B <= 32) {
+                        cdata[pos >> 5] |= input[i] << (32 - B - (pos & 31));
+                } else {
+                        cdata[pos >> 5] |= input[i] >> ((pos & 31) + B - 32);
+                        cdata[(pos >> 5) + 1] |= input[i] << (64 - B - (pos & 31));
+                }
+        }
+
+        /* No word out of a group should be read */
+        cdata[B] = ~0U;
+
+        __bmi2_unpack<B>(output, cdata, hb);
+
+        for (i = 0; i < 32; i++)
+                EXPECT_EQ(input[i] | hb, output[i]);
+}
+
+TEST(BMI2UnpackTest, ValidationUnpackOddWidths) {
+        if (!BMI2Unpack::available())
+                return;
+
+        __bmi2_check<3>(0);
+        __bmi2_check<5>(0);
+        __bmi2_check<7>(0);
+        __bmi2_check<9>(0);
+        __bmi2_check<11>(0);
+        __bmi2_check<13>(0);
+}
+
+TEST(BMI2UnpackTest, ValidationUnpackLeadingOnes) {
+        if (!BMI2Unpack::available())
+                return;
+
+        __bmi2_check<3>(1U << 3);
+        __bmi2_check<7>(1U << 7);
+        __bmi2_check<13>(1U << 13);
+}
@@ -0,0 +1,130 @@
+/*-----------------------------------------------------------------------------
+ *  BatchDecoder_utest.cpp - A unit test for BatchDecoder.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/BatchDecoder.hpp"
+#include "compress/Simple16.hpp"
+#include "compress/PForDelta.hpp"
+#include "compress/VSEncodingSimpleV2.hpp"
+
+#define NLISTS  50
+#define MAXLEN  3000
+
+struct __batch_coder {
+        void            (*enc)(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+        pt2Dec          dec;
+        pt2Block        blk;
+};
+
+static __batch_coder __coders[] = {
+        {Simple16::encodeArray, Simple16::decodeArray, Simple16::decodeBlock},
+        {PForDelta::encodeArray, PForDelta::decodeArray, PForDelta::decodeBlock},
+        {VSEncodingSimpleV2::encodeArray, VSEncodingSimpleV2::decodeArray,
+                VSEncodingSimpleV2::decodeBlock}
+};
+
+/* Lists of various lengths, including empty ones, placed back to back */
+static void
+__make_lists(BatchList *lists, uint32_t *gaps, uint32_t *cdata,
+                uint32_t *outs, int c)
+{
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        cpos;
+
+        for (i = 0, cpos = 0; i < NLISTS; i++) {
+                lists[i].num = (i % 7 == 3)? 0 : rand() % MAXLEN;
+                lists[i].in = cdata + cpos;
+                lists[i].out = outs + i * (MAXLEN + TAIL_MERGIN);
+                lists[i].csize = 0;
+
+                for (j = 0; j < lists[i].num; j++)
+                        gaps[i * MAXLEN + j] = (j % 31 == 0)?
+                                rand() & 0xffff : rand() & 0x3f;
+
+                if (lists[i].num > 0)
+                        (__coders[c].enc)(gaps + i * MAXLEN, lists[i].num,
+                                        lists[i].in, lists[i].csize);
+
+                cpos += lists[i].csize;
+        }
+}
+
+static void
+__check_lists(BatchList *lists, uint32_t *gaps)
+{
+        uint32_t        i;
+        uint32_t        j;
+
+        for (i = 0; i < NLISTS; i++) {
+                for (j = 0; j < lists[i].num; j++)
+                        ASSERT_EQ(gaps[i * MAXLEN + j], lists[i].out[j]);
+        }
+}
+
+TEST(BatchDecoderTest, DecodeLists) {
+        uint32_t        dist;
+        BatchList       lists[NLISTS];
+        uint32_t        *gaps = new uint32_t[NLISTS * MAXLEN];
+        uint32_t        *cdata = new uint32_t[NLISTS * __cmp_bound(MAXLEN)];
+        uint32_t        *outs = new uint32_t[NLISTS * (MAXLEN + TAIL_MERGIN)];
+
+        srand(0);
+
+        for (int c = 0; c < (int)(sizeof(__coders) / sizeof(__coders[0])); c++) {
+                __make_lists(lists, gaps, cdata, outs, c);
+
+                for (dist = 0; dist <= NLISTS; dist += 7) {
+                        memset(outs, 0xff, NLISTS * (MAXLEN + TAIL_MERGIN) *
+                                        sizeof(uint32_t));
+
+                        BatchDecoder::decodeLists(__coders[c].dec,
+                                        lists, NLISTS, dist);
+                        __check_lists(lists, gaps);
+                }
+        }
+
+        delete[] gaps;
+        delete[] cdata;
+        delete[] outs;
+}
+
+TEST(BatchDecoderTest, DecodeInterleaved) {
+        uint32_t        nways;
+        BatchList       lists[NLISTS];
+        uint32_t        *gaps = new uint32_t[NLISTS * MAXLEN];
+        uint32_t        *cdata = new uint32_t[NLISTS * __cmp_bound(MAXLEN)];
+        uint32_t        *outs = new uint32_t[NLISTS * (MAXLEN + TAIL_MERGIN)];
+
+        srand(0);
+
+        for (int c = 0; c < (int)(sizeof(__coders) / sizeof(__coders[0])); c++) {
+                __make_lists(lists, gaps, cdata, outs, c);
+
+                /* More ways than lists are also fine */
+                for (nways = 0; nways <= 2 * NLISTS; nways += 9) {
+                        memset(outs, 0xff, NLISTS * (MAXLEN + TAIL_MERGIN) *
+                                        sizeof(uint32_t));
+
+                        BatchDecoder::decodeInterleaved(__coders[c].blk,
+                                        lists, NLISTS, nways);
+                        __check_lists(lists, gaps);
+                }
+        }
+
+        delete[] gaps;
+        delete[] cdata;
+        delete[] outs;
+}
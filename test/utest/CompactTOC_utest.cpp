@@ -0,0 +1,118 @@
+/*-----------------------------------------------------------------------------
+ *  CompactTOC_utest.cpp - A unit test for CompactTOC.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/CompactTOC.hpp"
+
+#define NENTRIES        100000
+
+/*
+ * Entries as encoders write them: runs of short lists share a block
+ * at a position, and a long list takes words after a pending block.
+ */
+static uint64_t
+__make_toc(uint32_t *toc, uint32_t n)
+{
+        uint32_t        j;
+        uint32_t        num;
+        uint32_t        first;
+        uint32_t        off;
+        uint64_t        pos;
+        uint64_t        blk;
+
+        for (j = 0, pos = 0, off = 0, blk = 0; j < n; j++) {
+                num = (rand() % 3 == 0)? SKIP + 1 + rand() % 100000 :
+                                1 + rand() % SKIP;
+                first = rand() % 50000000;
+
+                if (num <= SKIP) {
+                        if (off == 0 || off + num > SHRBLKLEN) {
+                                blk = pos;
+                                pos += 1 + rand() % 64;
+                                off = 0;
+                        }
+
+                        __toc_put(toc, j, num, first, first + num,
+                                        __toc_short(blk, off));
+                        off += num;
+                } else {
+                        __toc_put(toc, j, num, first, first + num, pos);
+                        pos += num / 4;
+                        off = 0;
+                }
+        }
+
+        return pos;
+}
+
+TEST(CompactTOCTest, GetEntries) {
+        uint32_t        j;
+        uint32_t        num;
+        uint32_t        first;
+        uint64_t        pos;
+        uint64_t        cmplen;
+        uint32_t        *toc = new uint32_t[NENTRIES * EACH_HEADER_TOC_SZ];
+
+        srand(0);
+
+        cmplen = __make_toc(toc, NENTRIES);
+
+        CompactTOC      ctoc(toc, NENTRIES, cmplen);
+
+        ASSERT_EQ((uint32_t)NENTRIES, ctoc.size());
+        ASSERT_LT(ctoc.sizeInBytes(),
+                (uint64_t)NENTRIES * EACH_HEADER_TOC_SZ * sizeof(uint32_t));
+
+        for (j = 0; j < NENTRIES; j++) {
+                ctoc.get(j, num, first, pos);
+
+                ASSERT_EQ(__toc_num(toc, j), num) << "entry " << j;
+                ASSERT_EQ(__toc_first(toc, j), first) << "entry " << j;
+                ASSERT_EQ(__toc_pos(toc, j), pos) << "entry " << j;
+                ASSERT_EQ(__toc_blkpos(pos), ctoc.blkPos(j));
+        }
+
+        ASSERT_EQ(cmplen, ctoc.blkPos(NENTRIES));
+
+        delete[] toc;
+}
+
+/* A few entries with the same values, and a large base of positions */
+TEST(CompactTOCTest, SmallTOC) {
+        uint32_t        j;
+        uint32_t        num;
+        uint32_t        first;
+        uint64_t        pos;
+        uint32_t        toc[3 * EACH_HEADER_TOC_SZ];
+        uint64_t        base = 5ULL << 32;
+
+        for (j = 0; j < 3; j++)
+                __toc_put(toc, j, SKIP + 1, 7, 8 + SKIP, base + j);
+
+        CompactTOC      ctoc(toc, 3, base + 3);
+
+        for (j = 0; j < 3; j++) {
+                ctoc.get(j, num, first, pos);
+
+                EXPECT_EQ((uint32_t)SKIP + 1, num);
+                EXPECT_EQ(7U, first);
+                EXPECT_EQ(base + j, pos);
+        }
+
+        EXPECT_EQ(base + 3, ctoc.blkPos(3));
+
+        CompactTOC      empty(toc, 0, 11);
+
+        EXPECT_EQ(11U, empty.blkPos(0));
+}
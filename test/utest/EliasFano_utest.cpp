@@ -0,0 +1,85 @@
+/*-----------------------------------------------------------------------------
+ *  EliasFano_utest.cpp - A unit test for EliasFano.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/EliasFano.hpp"
+
+TEST(EliasFanoTest, ValidationEncode1b) {
+        int             i;
+        uint32_t        len;
+        uint32_t        input[32];
+        uint32_t        output[32];
+        uint32_t        cdata[64 + TAIL_MERGIN];
+
+        for (i = 0; i < 32; i++)
+                input[i] = 1;
+
+        EliasFano::encodeArray(&input[0], 32U, &cdata[0], len);
+        EliasFano::decodeArray(&cdata[0], len, &output[0], 32U);
+
+        for (i = 0; i < 32; i++)
+                EXPECT_EQ(1U, output[i]);
+}
+
+TEST(EliasFanoTest, ValidationEncodeMixed) {
+        int             i;
+        uint32_t        len;
+        uint32_t        input[4096];
+        uint32_t        output[4096];
+        uint32_t        cdata[8192 + TAIL_MERGIN];
+
+        /* Dense and sparse runs are mixed */
+        for (i = 0; i < 4096; i++)
+                input[i] = (i < 1024)? 0 : (i < 2048)? i % 7 : (i * 2654435761U) % 100000;
+
+        EliasFano::encodeArray(&input[0], 4096U, &cdata[0], len);
+        EliasFano::decodeArray(&cdata[0], len, &output[0], 4096U);
+
+        for (i = 0; i < 4096; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(EliasFanoTest, AccessAndNextGEQ) {
+        int             i;
+        uint32_t        len;
+        uint32_t        idx;
+        uint32_t        v;
+        uint32_t        input[4096];
+        uint32_t        vals[4096];
+        uint32_t        cdata[8192 + TAIL_MERGIN];
+
+        for (i = 0, v = 0; i < 4096; i++) {
+                input[i] = (i < 1024)? 0 : (i * 2654435761U) % 3000;
+                v += input[i];
+                vals[i] = v++;
+        }
+
+        EliasFano::encodeArray(&input[0], 4096U, &cdata[0], len);
+
+        for (i = 0; i < 4096; i++)
+                EXPECT_EQ(vals[i], EliasFano::access(&cdata[0], 4096U, i));
+
+        for (i = 0; i < 4096; i++) {
+                /* A value just after a previous one hits the i-th one */
+                v = EliasFano::nextGEQ(&cdata[0], 4096U,
+                                (i == 0)? 0 : vals[i - 1] + 1, idx);
+
+                EXPECT_EQ((uint32_t)i, idx);
+                EXPECT_EQ(vals[i], v);
+        }
+
+        EliasFano::nextGEQ(&cdata[0], 4096U, vals[4095] + 1, idx);
+
+        EXPECT_EQ(4096U, idx);
+}
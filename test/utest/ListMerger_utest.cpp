@@ -0,0 +1,247 @@
+/*-----------------------------------------------------------------------------
+ *  ListMerger_utest.cpp - A unit test for ListMerger.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/ListMerger.hpp"
+#include "compress/Simple9.hpp"
+#include "compress/Simple16.hpp"
+#include "compress/PForDelta.hpp"
+#include "compress/OPTPForDelta.hpp"
+#include "compress/VSEncodingSimpleV1.hpp"
+#include "compress/VSEncodingSimpleV2.hpp"
+#include "compress/VSEncodingBlocks.hpp"
+
+#define MAXLEN  5000
+
+static MergeCoder __coders[] = {
+        {MERGE_WORDS, Simple9::encodeArray, Simple9::decodeArray,
+                Simple9::decodeBlock, Simple9::skipBlock},
+        {MERGE_WORDS, Simple16::encodeArray, Simple16::decodeArray,
+                Simple16::decodeBlock, Simple16::skipBlock},
+        {MERGE_BLOCKS, PForDelta::encodeArray, PForDelta::decodeArray,
+                PForDelta::decodeBlock, PForDelta::skipBlock},
+        {MERGE_BLOCKS, OPTPForDelta::encodeArray, OPTPForDelta::decodeArray,
+                OPTPForDelta::decodeBlock, PForDelta::skipBlock},
+        {MERGE_PARTS, VSEncodingSimpleV1::encodeArray,
+                VSEncodingSimpleV1::decodeArray,
+                VSEncodingSimpleV1::decodeBlock, NULL,
+                VSEncodingSimpleV1::mergeArray},
+        {MERGE_PARTS, VSEncodingSimpleV2::encodeArray,
+                VSEncodingSimpleV2::decodeArray,
+                VSEncodingSimpleV2::decodeBlock, NULL,
+                VSEncodingSimpleV2::mergeArray},
+        {MERGE_REENCODE, VSEncodingBlocks::encodeArray,
+                VSEncodingBlocks::decodeArray, NULL, NULL, NULL}
+};
+
+/* Lengths around words and blocks at a boundary */
+static uint32_t __lens[] = {
+        0, 1, 27, 31, 32, 33, 63, 64, 95, 100, 1000, 4999
+};
+
+/* Runs of small integers, where words of Simple9/16 are long */
+static void
+__make_gaps(uint32_t *gaps, uint32_t n)
+{
+        uint32_t        i;
+
+        for (i = 0; i < n; i++)
+                gaps[i] = (i % 97 < 40)? rand() & 0x1 :
+                        (rand() % 16 == 0)? rand() & 0xfffff : rand() & 0x3f;
+}
+
+/* Integers of a list are decoded by a coder, and by blocks as well */
+static void
+__expect_decoded(MergeCoder &mc, uint32_t *in, uint32_t len,
+                uint32_t *gaps, uint32_t num)
+{
+        uint32_t        k;
+        uint32_t        p;
+        uint32_t        *data;
+        uint32_t        *dec = new uint32_t[num + TAIL_MERGIN];
+
+        (mc.dec)(in, len, dec, num);
+        EXPECT_EQ(0, memcmp(gaps, dec, num * sizeof(uint32_t)));
+
+        if (mc.blk != NULL) {
+                memset(dec, 0, num * sizeof(uint32_t));
+
+                for (k = 0, p = 0, data = NULL; k < num; )
+                        k += (mc.blk)(in, 1, num - k, p, data, dec + k);
+
+                EXPECT_EQ(0, memcmp(gaps, dec, num * sizeof(uint32_t)));
+        }
+
+        delete[] dec;
+}
+
+/*
+ * A merged list is the same as the one encoding all the integers, or
+ * decoded to them with short blocks or partitions.
+ */
+TEST(ListMergerTest, MergeArray) {
+        uint32_t        a;
+        uint32_t        b;
+        uint32_t        numA;
+        uint32_t        numB;
+        uint32_t        lenA;
+        uint32_t        lenB;
+        uint32_t        len;
+        uint32_t        nvalue;
+        uint64_t        nre;
+        uint32_t        *gaps = new uint32_t[2 * MAXLEN + 1 + TAIL_MERGIN];
+        uint32_t        *cmpA = new uint32_t[__cmp_bound(MAXLEN)];
+        uint32_t        *cmpB = new uint32_t[__cmp_bound(MAXLEN)];
+        uint32_t        *cmp = new uint32_t[__cmp_bound(2 * MAXLEN + 1)];
+        uint32_t        *out = new uint32_t[__cmp_bound(2 * MAXLEN + 1) +
+                                        2 * __cmp_bound(MAXLEN)];
+
+        srand(0);
+
+        for (int c = 0; c < (int)(sizeof(__coders) / sizeof(__coders[0])); c++) {
+                MergeCoder      &mc = __coders[c];
+
+                for (a = 0; a < sizeof(__lens) / sizeof(__lens[0]); a++) {
+                        for (b = 0; b < sizeof(__lens) / sizeof(__lens[0]); b++) {
+                                numA = __lens[a];
+                                numB = __lens[b];
+
+                                __make_gaps(gaps, numA + 1 + numB);
+
+                                (mc.enc)(gaps, numA, cmpA, lenA);
+                                (mc.enc)(gaps + numA + 1, numB, cmpB, lenB);
+                                (mc.enc)(gaps, numA + 1 + numB, cmp, len);
+
+                                nre = ListMerger::mergeArray(mc,
+                                                cmpA, lenA, numA, gaps[numA],
+                                                cmpB, lenB, numB, out, nvalue);
+
+                                ASSERT_LE(nre, (uint64_t)numA + 1 + numB);
+
+                                if (mc.type == MERGE_BLOCKS)
+                                        ASSERT_LE(nre, (uint64_t)PFORDELTA_BLOCKSZ);
+
+                                /* A tail is a partition of up to 256 and val */
+                                if (mc.type == MERGE_PARTS)
+                                        ASSERT_LE(nre, 257ULL);
+
+                                if (mc.type == MERGE_BLOCKS ||
+                                                mc.type == MERGE_PARTS) {
+                                        __expect_decoded(mc, out, nvalue,
+                                                        gaps, numA + 1 + numB);
+                                        continue;
+                                }
+
+                                ASSERT_EQ(len, nvalue);
+                                ASSERT_EQ(0, memcmp(cmp, out, len * sizeof(uint32_t))) <<
+                                        "coder " << c << ", " << numA << " + " << numB;
+                        }
+                }
+        }
+
+        delete[] gaps;
+        delete[] cmpA;
+        delete[] cmpB;
+        delete[] cmp;
+        delete[] out;
+}
+
+/* A list with short blocks or partitions is merged again as A */
+TEST(ListMergerTest, MergeShortBlocks) {
+        uint32_t        i;
+        uint32_t        num;
+        uint32_t        numB;
+        uint32_t        lenA;
+        uint32_t        lenB;
+        uint32_t        nvalue;
+        uint32_t        *tmp;
+        uint32_t        *gaps = new uint32_t[2 * MAXLEN + 1 + TAIL_MERGIN];
+        uint32_t        *cmpA = new uint32_t[4 * __cmp_bound(MAXLEN)];
+        uint32_t        *cmpB = new uint32_t[__cmp_bound(MAXLEN)];
+        uint32_t        *out = new uint32_t[4 * __cmp_bound(MAXLEN)];
+
+        srand(0);
+        __make_gaps(gaps, 2 * MAXLEN + 1);
+
+        for (int c = 0; c < (int)(sizeof(__coders) / sizeof(__coders[0])); c++) {
+                MergeCoder      &mc = __coders[c];
+
+                if (mc.type != MERGE_BLOCKS && mc.type != MERGE_PARTS)
+                        continue;
+
+                num = 5;
+                (mc.enc)(gaps, num, cmpA, lenA);
+
+                for (i = 0; i < sizeof(__lens) / sizeof(__lens[0]) - 2; i++) {
+                        numB = __lens[i];
+
+                        (mc.enc)(gaps + num + 1, numB, cmpB, lenB);
+                        ListMerger::mergeArray(mc, cmpA, lenA, num,
+                                        gaps[num], cmpB, lenB, numB,
+                                        out, nvalue);
+
+                        num += 1 + numB;
+                        __expect_decoded(mc, out, nvalue, gaps, num);
+
+                        tmp = cmpA;
+                        cmpA = out;
+                        out = tmp;
+                        lenA = nvalue;
+                }
+        }
+
+        delete[] gaps;
+        delete[] cmpA;
+        delete[] cmpB;
+        delete[] out;
+}
+
+/* Words and blocks of B are copied, not encoded again */
+TEST(ListMergerTest, CopyFollowingList) {
+        uint32_t        lenA;
+        uint32_t        lenB;
+        uint32_t        nvalue;
+        uint32_t        *gaps = new uint32_t[2 * MAXLEN + 1 + TAIL_MERGIN];
+        uint32_t        *cmpA = new uint32_t[__cmp_bound(MAXLEN)];
+        uint32_t        *cmpB = new uint32_t[__cmp_bound(MAXLEN)];
+        uint32_t        *out = new uint32_t[__cmp_bound(2 * MAXLEN + 1) +
+                                        2 * __cmp_bound(MAXLEN)];
+
+        srand(0);
+        __make_gaps(gaps, 2 * MAXLEN + 1);
+
+        Simple16::encodeArray(gaps, MAXLEN, cmpA, lenA);
+        Simple16::encodeArray(gaps + MAXLEN + 1, MAXLEN, cmpB, lenB);
+
+        EXPECT_LT(ListMerger::mergeArray(__coders[1], cmpA, lenA, MAXLEN,
+                        gaps[MAXLEN], cmpB, lenB, MAXLEN, out, nvalue),
+                        (uint64_t)MAXLEN / 2);
+
+        PForDelta::encodeArray(gaps, 31 * PFORDELTA_BLOCKSZ - 5, cmpA, lenA);
+        PForDelta::encodeArray(gaps + 31 * PFORDELTA_BLOCKSZ - 4,
+                        MAXLEN, cmpB, lenB);
+
+        EXPECT_EQ((uint64_t)PFORDELTA_BLOCKSZ - 4,
+                        ListMerger::mergeArray(__coders[2], cmpA, lenA,
+                                31 * PFORDELTA_BLOCKSZ - 5,
+                                gaps[31 * PFORDELTA_BLOCKSZ - 5],
+                                cmpB, lenB, MAXLEN, out, nvalue));
+        EXPECT_EQ(0, memcmp(out + nvalue - (lenB - 1), cmpB + 1,
+                        (lenB - 1) * sizeof(uint32_t)));
+
+        delete[] gaps;
+        delete[] cmpA;
+        delete[] cmpB;
+        delete[] out;
+}
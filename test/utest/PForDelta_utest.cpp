@@ -35,3 +35,68 @@ TEST(PForDeltaTest, ValidationEncode1b) {
                 EXPECT_EQ(1U, output[i]);
 }
 
+TEST(PForDeltaTest, ValidationEncode64b) {
+        int             i;
+        uint32_t        len;
+        uint64_t        input[64];
+        uint64_t        output[64 + TAIL_MERGIN];
+        uint32_t        cdata[128 + TAIL_MERGIN];
+
+        for (i = 0; i < 64; i++)
+                input[i] = (i % 8 == 0)? (1ULL << 40) + i : i;
+
+        PForDelta::encodeArray(&input[0], 64U, &cdata[0], len);
+        PForDelta::decodeArray(&cdata[0], len, &output[0], 64U);
+
+        for (i = 0; i < 64; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(PForDeltaTest, ValidationEncode64bMaxExcept) {
+        int             i;
+        uint32_t        j;
+        uint32_t        b;
+        uint32_t        len;
+        uint64_t        input[64];
+        uint64_t        output[64 + TAIL_MERGIN];
+        uint32_t        cdata[256 + TAIL_MERGIN];
+        uint32_t        bs[] = {1, 4, 8, 13, 16, 20, 32};
+
+        for (j = 0; j < sizeof(bs) / sizeof(bs[0]); j++) {
+                b = bs[j];
+
+                /*
+                 * In the first block, exceptions are just at the limit
+                 * of Simple16 with b. In the second one, they are over
+                 * the limit, and so b must be rejected in tryB().
+                 */
+                for (i = 0; i < 64; i++)
+                        input[i] = (b < 32)? (1ULL << b) - 1 : i;
+
+                input[3] = (1ULL << 28) << b;
+                input[17] = ((1ULL << 28) << b) + 1;
+
+                if (b < 32) {
+                        input[32 + 3] = ((1ULL << 28) + 1) << b;
+                        input[32 + 17] = (((1ULL << 28) + 1) << b) + 1;
+                }
+
+                PForDelta::encodeArray(&input[0], 64U, &cdata[0], len);
+
+                /*
+                 * A first word is # of blocks, and a header of each
+                 * block has b in upper 6 bits and the size of
+                 * exceptions in lower 16 bits.
+                 */
+                EXPECT_EQ(b, cdata[1] >> 26);
+
+                if (b < 32) {
+                        EXPECT_LT(b, cdata[2 + (cdata[1] & 0xffff) + b] >> 26);
+                }
+
+                PForDelta::decodeArray(&cdata[0], len, &output[0], 64U);
+
+                for (i = 0; i < 64; i++)
+                        EXPECT_EQ(input[i], output[i]);
+        }
+}
@@ -0,0 +1,129 @@
+/*-----------------------------------------------------------------------------
+ *  ParallelList_utest.cpp - A unit test for ParallelList.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/ParallelList.hpp"
+#include "compress/PForDelta.hpp"
+#include "compress/OPTPForDelta.hpp"
+
+#define MAXLEN  (3 * PLIST_SUBLEN + 17)
+
+static pt2Enc __encs[] = {
+        VSEncodingBlocks::encodeArray,
+        PForDelta::encodeArray,
+        OPTPForDelta::encodeArray
+};
+
+static pt2Dec __decs[] = {
+        VSEncodingBlocks::decodeArray,
+        PForDelta::decodeArray,
+        OPTPForDelta::decodeArray
+};
+
+/* Lengths around sub-blocks */
+static uint32_t __lens[] = {
+        1, 100, PLIST_SUBLEN - 1, PLIST_SUBLEN,
+        PLIST_SUBLEN + 1, 2 * PLIST_SUBLEN, MAXLEN
+};
+
+static uint32_t __nthreads[] = {1, 2, 5};
+
+/* Lists and docIDs are restored with any # of threads */
+TEST(ParallelListTest, EncodeDecode) {
+        uint32_t        c;
+        uint32_t        l;
+        uint32_t        t;
+        uint32_t        i;
+        uint32_t        len;
+        uint32_t        nvalue;
+        uint32_t        doc;
+        uint32_t        *gaps = new uint32_t[MAXLEN + TAIL_MERGIN];
+        uint32_t        *docs = new uint32_t[MAXLEN + TAIL_MERGIN];
+        uint32_t        *out = new uint32_t[MAXLEN + TAIL_MERGIN];
+        uint32_t        *cmp = new uint32_t[ParallelList::bound(MAXLEN)];
+
+        srand(0);
+
+        for (i = 0, doc = 7; i < MAXLEN; i++) {
+                gaps[i] = (rand() % 8 == 0)? rand() & 0xffff : rand() & 0x7;
+                doc += gaps[i] + 1;
+                docs[i] = doc;
+        }
+
+        for (t = 0; t < sizeof(__nthreads) / sizeof(__nthreads[0]); t++) {
+                ParallelList    pl(__nthreads[t]);
+
+                for (c = 0; c < sizeof(__encs) / sizeof(__encs[0]); c++) {
+                        for (l = 0; l < sizeof(__lens) / sizeof(__lens[0]); l++) {
+                                len = __lens[l];
+
+                                pl.encodeArray(__encs[c], gaps, len, cmp, nvalue);
+
+                                ASSERT_EQ(ParallelList::numSubBlocks(len), cmp[0]);
+                                ASSERT_LE((uint64_t)nvalue, ParallelList::bound(len));
+
+                                pl.decodeArray(__decs[c], cmp, nvalue, out, len);
+                                ASSERT_EQ(0, memcmp(gaps, out, len * sizeof(uint32_t))) <<
+                                        "coder " << c << ", len " << len <<
+                                        ", threads " << __nthreads[t];
+
+                                pl.decodeDocs(__decs[c], cmp, nvalue, out, len, 7);
+                                ASSERT_EQ(0, memcmp(docs, out, len * sizeof(uint32_t))) <<
+                                        "coder " << c << ", len " << len <<
+                                        ", threads " << __nthreads[t];
+                        }
+                }
+        }
+
+        delete[] gaps;
+        delete[] docs;
+        delete[] out;
+        delete[] cmp;
+}
+
+/* A directory has offsets of sub-blocks and docIDs before them */
+TEST(ParallelListTest, Directory) {
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        base;
+        uint32_t        nvalue;
+        uint32_t        csize;
+        uint32_t        *gaps = new uint32_t[MAXLEN + TAIL_MERGIN];
+        uint32_t        *cmp = new uint32_t[ParallelList::bound(MAXLEN)];
+        uint32_t        *blk = new uint32_t[__cmp_bound(PLIST_SUBLEN)];
+        ParallelList    pl(3);
+
+        for (i = 0; i < MAXLEN; i++)
+                gaps[i] = i % 3;
+
+        pl.encodeArray(PForDelta::encodeArray, gaps, MAXLEN, cmp, nvalue);
+
+        ASSERT_EQ(4U, cmp[0]);
+
+        for (i = 0, base = 0; i < 4; i++) {
+                EXPECT_EQ(base, cmp[2 + 2 * i]);
+
+                for (k = 0; k < PLIST_SUBLEN && i * PLIST_SUBLEN + k < MAXLEN; k++)
+                        base += gaps[i * PLIST_SUBLEN + k] + 1;
+
+                PForDelta::encodeArray(gaps + i * PLIST_SUBLEN,
+                                (i < 3)? PLIST_SUBLEN : 17, blk, csize);
+                EXPECT_EQ(0, memcmp(blk, cmp + 9 + cmp[1 + 2 * i],
+                                csize * sizeof(uint32_t)));
+        }
+
+        delete[] gaps;
+        delete[] cmp;
+        delete[] blk;
+}
@@ -0,0 +1,105 @@
+/*-----------------------------------------------------------------------------
+ *  PartitionedEliasFano_utest.cpp - A unit test for PartitionedEliasFano.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/PartitionedEliasFano.hpp"
+
+TEST(PartitionedEliasFanoTest, ValidationEncode1b) {
+        int             i;
+        uint32_t        len;
+        uint32_t        input[32];
+        uint32_t        output[32];
+        uint32_t        cdata[64 + TAIL_MERGIN];
+
+        for (i = 0; i < 32; i++)
+                input[i] = 1;
+
+        PartitionedEliasFano::encodeArray(&input[0], 32U, &cdata[0], len);
+        PartitionedEliasFano::decodeArray(&cdata[0], len, &output[0], 32U);
+
+        for (i = 0; i < 32; i++)
+                EXPECT_EQ(1U, output[i]);
+}
+
+TEST(PartitionedEliasFanoTest, ValidationEncodeMixed) {
+        int             i;
+        uint32_t        len;
+        uint32_t        input[4096];
+        uint32_t        output[4096];
+        uint32_t        cdata[8192 + TAIL_MERGIN];
+
+        /* Dense and sparse runs are mixed */
+        for (i = 0; i < 4096; i++)
+                input[i] = (i < 1024)? 0 : (i < 2048)? i % 7 : (i * 2654435761U) % 100000;
+
+        PartitionedEliasFano::encodeArray(&input[0], 4096U, &cdata[0], len);
+        PartitionedEliasFano::decodeArray(&cdata[0], len, &output[0], 4096U);
+
+        for (i = 0; i < 4096; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(PartitionedEliasFanoTest, FastPartition) {
+        int             i;
+        uint32_t        len;
+        uint32_t        input[4096];
+        uint32_t        output[4096];
+        uint32_t        cdata[8192 + TAIL_MERGIN];
+
+        for (i = 0; i < 4096; i++)
+                input[i] = (i < 1024)? 0 : (i < 2048)? i % 7 : (i * 2654435761U) % 100000;
+
+        PartitionedEliasFano::setFastPartition(true);
+        PartitionedEliasFano::encodeArray(&input[0], 4096U, &cdata[0], len);
+        PartitionedEliasFano::setFastPartition(false);
+
+        PartitionedEliasFano::decodeArray(&cdata[0], len, &output[0], 4096U);
+
+        for (i = 0; i < 4096; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(PartitionedEliasFanoTest, AccessAndNextGEQ) {
+        int             i;
+        uint32_t        len;
+        uint32_t        idx;
+        uint32_t        v;
+        uint32_t        input[4096];
+        uint32_t        vals[4096];
+        uint32_t        cdata[8192 + TAIL_MERGIN];
+
+        for (i = 0, v = 0; i < 4096; i++) {
+                input[i] = (i < 1024)? 0 : (i * 2654435761U) % 3000;
+                v += input[i];
+                vals[i] = v++;
+        }
+
+        PartitionedEliasFano::encodeArray(&input[0], 4096U, &cdata[0], len);
+
+        for (i = 0; i < 4096; i++)
+                EXPECT_EQ(vals[i], PartitionedEliasFano::access(&cdata[0], 4096U, i));
+
+        for (i = 0; i < 4096; i++) {
+                /* A value just after a previous one hits the i-th one */
+                v = PartitionedEliasFano::nextGEQ(&cdata[0], 4096U,
+                                (i == 0)? 0 : vals[i - 1] + 1, idx);
+
+                EXPECT_EQ((uint32_t)i, idx);
+                EXPECT_EQ(vals[i], v);
+        }
+
+        PartitionedEliasFano::nextGEQ(&cdata[0], 4096U, vals[4095] + 1, idx);
+
+        EXPECT_EQ(4096U, idx);
+}
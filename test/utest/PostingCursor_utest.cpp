@@ -0,0 +1,116 @@
+/*-----------------------------------------------------------------------------
+ *  PostingCursor_utest.cpp - A unit test for PostingCursor.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#include "compress/PostingCursor.hpp"
+#include "compress/Simple9.hpp"
+#include "compress/Simple16.hpp"
+#include "compress/PForDelta.hpp"
+#include "compress/OPTPForDelta.hpp"
+#include "compress/VSEncodingSimpleV1.hpp"
+#include "compress/VSEncodingSimpleV2.hpp"
+
+#define NUM     10000
+
+struct __cursor_coder {
+        void            (*enc)(uint32_t *in, uint32_t len,
+                                uint32_t *out, uint32_t &nvalue);
+        pt2Block        dec;
+};
+
+static __cursor_coder __coders[] = {
+        {Simple9::encodeArray, Simple9::decodeBlock},
+        {Simple16::encodeArray, Simple16::decodeBlock},
+        {PForDelta::encodeArray, PForDelta::decodeBlock},
+        {OPTPForDelta::encodeArray, OPTPForDelta::decodeBlock},
+        {VSEncodingSimpleV1::encodeArray, VSEncodingSimpleV1::decodeBlock},
+        {VSEncodingSimpleV2::encodeArray, VSEncodingSimpleV2::decodeBlock}
+};
+
+/* Make docIDs with d-gaps of mixed widths, and encode the gaps */
+static void
+__make_list(uint32_t *docs, uint32_t *gaps, uint32_t *cdata, int c)
+{
+        uint32_t        i;
+        uint32_t        len;
+
+        docs[0] = 7;
+
+        for (i = 0; i < NUM - 1; i++) {
+                gaps[i] = (i % 97 == 0)? rand() & 0xfffff : rand() & 0x1f;
+                docs[i + 1] = docs[i] + gaps[i] + 1;
+        }
+
+        (__coders[c].enc)(gaps, NUM - 1, cdata, len);
+}
+
+TEST(PostingCursorTest, Next) {
+        uint32_t        i;
+        uint32_t        docs[NUM];
+        uint32_t        gaps[NUM];
+        uint32_t        cdata[2 * NUM + TAIL_MERGIN];
+
+        srand(0);
+
+        for (int c = 0; c < (int)(sizeof(__coders) / sizeof(__coders[0])); c++) {
+                __make_list(docs, gaps, cdata, c);
+
+                PostingCursor   cur(__coders[c].dec, cdata, NUM, docs[0]);
+
+                EXPECT_EQ(docs[0], cur.docid());
+
+                for (i = 1; i < NUM; i++) {
+                        EXPECT_EQ(docs[i], cur.next());
+                        EXPECT_EQ(docs[i], cur.docid());
+                }
+
+                EXPECT_EQ(PCURSOR_END, cur.next());
+                EXPECT_EQ(PCURSOR_END, cur.docid());
+        }
+}
+
+TEST(PostingCursorTest, NextGEQ) {
+        uint32_t        d;
+        uint32_t        *p;
+        uint32_t        docs[NUM];
+        uint32_t        gaps[NUM];
+        uint32_t        cdata[2 * NUM + TAIL_MERGIN];
+
+        srand(0);
+
+        for (int c = 0; c < (int)(sizeof(__coders) / sizeof(__coders[0])); c++) {
+                __make_list(docs, gaps, cdata, c);
+
+                PostingCursor   cur(__coders[c].dec, cdata, NUM, docs[0]);
+
+                /* Targets jump over blocks, or stay in a block */
+                for (d = 0; d <= docs[NUM - 1]; d += rand() % 2000) {
+                        p = std::lower_bound(docs, docs + NUM, d);
+                        EXPECT_EQ(*p, cur.nextGEQ(d));
+                }
+
+                EXPECT_EQ(PCURSOR_END, cur.nextGEQ(docs[NUM - 1] + 1));
+        }
+}
+
+TEST(PostingCursorTest, SingleDoc) {
+        uint32_t        cdata[TAIL_MERGIN];
+
+        PostingCursor   cur(PForDelta::decodeBlock, cdata, 1U, 100U);
+
+        EXPECT_EQ(100U, cur.nextGEQ(50U));
+        EXPECT_EQ(PCURSOR_END, cur.nextGEQ(101U));
+}
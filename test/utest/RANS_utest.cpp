@@ -0,0 +1,78 @@
+/*-----------------------------------------------------------------------------
+ *  RANS_utest.cpp - A unit test for a rANS coder.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/RANS.hpp"
+
+#define NSYMBOLS        10007
+
+TEST(RANSTest, ValidationSkewedSymbols) {
+        uint32_t        i;
+        uint32_t        len;
+        uint8_t         input[NSYMBOLS];
+        uint8_t         output[NSYMBOLS];
+        uint32_t        cdata[__rans_bound(NSYMBOLS)];
+
+        /* About a half of symbols are 0, and the rest are rare */
+        for (i = 0; i < NSYMBOLS; i++)
+                input[i] = (i % 2 == 0)? 0 : __builtin_ctz(i * 2654435761U) * 7;
+
+        RANS::encode(&input[0], NSYMBOLS, &cdata[0], len);
+
+        EXPECT_GT(NSYMBOLS / 4U, len);
+
+        RANS::decode(&cdata[0], &output[0], NSYMBOLS);
+
+        for (i = 0; i < NSYMBOLS; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(RANSTest, ValidationFewSymbols) {
+        uint32_t        i;
+        uint32_t        n;
+        uint32_t        len;
+        uint8_t         input[8];
+        uint8_t         output[8];
+        uint32_t        cdata[__rans_bound(8)];
+
+        /* Any # of symbols in interleaved states, and a single symbol */
+        for (n = 1; n <= 8; n++) {
+                for (i = 0; i < n; i++)
+                        input[i] = (n == 8)? 255 : i * 31;
+
+                RANS::encode(&input[0], n, &cdata[0], len);
+                RANS::decode(&cdata[0], &output[0], n);
+
+                for (i = 0; i < n; i++)
+                        EXPECT_EQ(input[i], output[i]);
+        }
+}
+
+TEST(RANSTest, ValidationAllSymbols) {
+        uint32_t        i;
+        uint32_t        len;
+        uint8_t         input[NSYMBOLS];
+        uint8_t         output[NSYMBOLS];
+        uint32_t        cdata[__rans_bound(NSYMBOLS)];
+
+        /* All 256 symbols with a single dominant one */
+        for (i = 0; i < NSYMBOLS; i++)
+                input[i] = (i < 256)? i : 17;
+
+        RANS::encode(&input[0], NSYMBOLS, &cdata[0], len);
+        RANS::decode(&cdata[0], &output[0], NSYMBOLS);
+
+        for (i = 0; i < NSYMBOLS; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
@@ -0,0 +1,79 @@
+/*-----------------------------------------------------------------------------
+ *  SIMDBP128_utest.cpp - A unit test for SIMDBP128.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/SIMDBP128.hpp"
+
+TEST(SIMDBP128Test, ValidationEncodeConsecutive) {
+        uint32_t        len;
+        uint32_t        input[256];
+        uint32_t        output[256 + TAIL_MERGIN];
+        uint32_t        cdata[8 + TAIL_MERGIN];
+
+        for (int i = 0; i < 256; i++)
+                input[i] = 1000 + i;
+
+        /* Any D4 delta is 0, so only widths are written */
+        SIMDBP128::encodeArray(&input[0], 256U, &cdata[0], len);
+
+        EXPECT_EQ(2U, len);
+
+        SIMDBP128::decodeArray(&cdata[0], len, &output[0], 256U);
+
+        for (int i = 0; i < 256; i++)
+                EXPECT_EQ(1000U + i, output[i]);
+}
+
+TEST(SIMDBP128Test, ValidationEncodeWidths) {
+        uint32_t        b;
+        uint32_t        i;
+        uint32_t        n;
+        uint32_t        len;
+        uint32_t        input[1000];
+        uint32_t        output[1000 + TAIL_MERGIN];
+        uint32_t        cdata[2000 + TAIL_MERGIN];
+
+        /* Gaps up to 2^b with a partial block in the end */
+        for (b = 0; b < 24; b++) {
+                n = 1000 - b * 17;
+
+                for (i = 0; i < n; i++)
+                        input[i] = ((i > 0)? input[i - 1] : 0) + 1 +
+                                ((uint64_t)((i + b) * 2654435761U) >> (33 - b));
+
+                SIMDBP128::encodeArray(&input[0], n, &cdata[0], len);
+                SIMDBP128::decodeArray(&cdata[0], len, &output[0], n);
+
+                for (i = 0; i < n; i++)
+                        EXPECT_EQ(input[i], output[i]);
+        }
+}
+
+TEST(SIMDBP128Test, ValidationEncodeLargeValues) {
+        uint32_t        i;
+        uint32_t        len;
+        uint32_t        input[300];
+        uint32_t        output[300 + TAIL_MERGIN];
+        uint32_t        cdata[600 + TAIL_MERGIN];
+
+        /* 32-bit D4 deltas */
+        for (i = 0; i < 300; i++)
+                input[i] = (i < 150)? i : 0xf0000000U + i;
+
+        SIMDBP128::encodeArray(&input[0], 300U, &cdata[0], len);
+        SIMDBP128::decodeArray(&cdata[0], len, &output[0], 300U);
+
+        for (i = 0; i < 300; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
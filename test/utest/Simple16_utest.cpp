@@ -55,3 +55,112 @@ TEST(Simple16Test, ValidationEncode2b) {
                 EXPECT_EQ(1U << 1, output[i]);
 }
 
+TEST(Simple16Test, ValidationEncode64b) {
+        int             i;
+        uint32_t        len;
+        uint64_t        input[28];
+        uint64_t        output[28 + TAIL_MERGIN];
+        uint32_t        cdata[28];
+
+        for (i = 0; i < 28; i++)
+                input[i] = i;
+
+        Simple16::encodeArray(&input[0], 28U, &cdata[0], len);
+        Simple16::decodeArray(&cdata[0], len, &output[0], 28U);
+
+        for (i = 0; i < 28; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(Simple16Test, ValidationEncode64bMax) {
+        int             i;
+        uint32_t        len;
+        uint32_t        len32;
+        uint64_t        input[56];
+        uint32_t        input32[56];
+        uint64_t        output[56 + TAIL_MERGIN];
+        uint32_t        cdata[56];
+        uint32_t        cdata32[56];
+
+        /* Values near the 28-bit payload limit */
+        for (i = 0; i < 56; i++) {
+                input32[i] = (i % 4 == 0)? (1U << 28) - 1 :
+                                (1U << (i % 28)) - 1;
+                input[i] = input32[i];
+        }
+
+        Simple16::encodeArray(&input[0], 56U, &cdata[0], len);
+        Simple16::encodeArray(&input32[0], 56U, &cdata32[0], len32);
+
+        ASSERT_EQ(len32, len);
+
+        for (i = 0; i < (int)len; i++)
+                EXPECT_EQ(cdata32[i], cdata[i]);
+
+        Simple16::decodeArray(&cdata[0], len, &output[0], 56U);
+
+        for (i = 0; i < 56; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(Simple16Test, ValidationEncode64bOutOfRange) {
+        int             i;
+        uint32_t        len;
+        uint64_t        input[28];
+        uint32_t        cdata[28];
+
+        for (i = 0; i < 28; i++)
+                input[i] = i;
+
+        input[27] = 1ULL << 28;
+
+        /* eoutput() exits, so a child re-executes the test */
+        ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+        EXPECT_EXIT(Simple16::encodeArray(&input[0], 28U, &cdata[0], len),
+                        ::testing::ExitedWithCode(EXIT_FAILURE), "out of range");
+
+        /* Upper bits must not be dropped silently */
+        input[27] = (1ULL << 32) + 1;
+
+        EXPECT_EXIT(Simple16::encodeArray(&input[0], 28U, &cdata[0], len),
+                        ::testing::ExitedWithCode(EXIT_FAILURE), "out of range");
+}
+
+TEST(Simple16Test, ValidationEncodeMixed) {
+        int             i;
+        uint32_t        len;
+        uint32_t        input[28];
+        uint32_t        output[28 + TAIL_MERGIN];
+        uint32_t        cdata[8];
+
+        /* 7 1-bit, 7 2-bit, and 7 1-bit integers (Descripter Number: 2) */
+        for (i = 0; i < 21; i++)
+                input[i] = (i < 7)? 1U : (i < 14)? 3U : 0U;
+
+        Simple16::encodeArray(&input[0], 21U, &cdata[0], len);
+
+        EXPECT_EQ(1U, len);
+        EXPECT_EQ(0x2fffff80U, cdata[0]);
+
+        /* 1 10-bit and 2 9-bit integers (Descripter Number: 13) */
+        input[0] = 1023U;
+        input[1] = 511U;
+        input[2] = 0U;
+
+        Simple16::encodeArray(&input[0], 3U, &cdata[0], len);
+
+        EXPECT_EQ(1U, len);
+        EXPECT_EQ(0xdffffe00U, cdata[0]);
+
+        /* A tail shorter than a layout is padded with 0s */
+        input[0] = 3U;
+
+        Simple16::encodeArray(&input[0], 1U, &cdata[0], len);
+
+        EXPECT_EQ(1U, len);
+        EXPECT_EQ(0x1c000000U, cdata[0]);
+
+        Simple16::decodeArray(&cdata[0], len, &output[0], 1U);
+        EXPECT_EQ(3U, output[0]);
+}
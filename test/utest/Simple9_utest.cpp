@@ -55,3 +55,74 @@ TEST(Simple9Test, ValidationEncode2b) {
                 EXPECT_EQ(1U << 1, output[i]);
 }
 
+TEST(Simple9Test, ValidationEncode64b) {
+        int             i;
+        uint32_t        len;
+        uint64_t        input[28];
+        uint64_t        output[28 + TAIL_MERGIN];
+        uint32_t        cdata[28];
+
+        for (i = 0; i < 28; i++)
+                input[i] = i;
+
+        Simple9::encodeArray(&input[0], 28U, &cdata[0], len);
+        Simple9::decodeArray(&cdata[0], len, &output[0], 28U);
+
+        for (i = 0; i < 28; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(Simple9Test, ValidationEncode64bMax) {
+        int             i;
+        uint32_t        len;
+        uint32_t        len32;
+        uint64_t        input[56];
+        uint32_t        input32[56];
+        uint64_t        output[56 + TAIL_MERGIN];
+        uint32_t        cdata[56];
+        uint32_t        cdata32[56];
+
+        /* Values near the 28-bit payload limit */
+        for (i = 0; i < 56; i++) {
+                input32[i] = (i % 4 == 0)? (1U << 28) - 1 :
+                                (1U << (i % 28)) - 1;
+                input[i] = input32[i];
+        }
+
+        Simple9::encodeArray(&input[0], 56U, &cdata[0], len);
+        Simple9::encodeArray(&input32[0], 56U, &cdata32[0], len32);
+
+        ASSERT_EQ(len32, len);
+
+        for (i = 0; i < (int)len; i++)
+                EXPECT_EQ(cdata32[i], cdata[i]);
+
+        Simple9::decodeArray(&cdata[0], len, &output[0], 56U);
+
+        for (i = 0; i < 56; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(Simple9Test, ValidationEncode64bOutOfRange) {
+        int             i;
+        uint32_t        len;
+        uint64_t        input[28];
+        uint32_t        cdata[28];
+
+        for (i = 0; i < 28; i++)
+                input[i] = i;
+
+        input[27] = 1ULL << 28;
+
+        /* eoutput() exits, so a child re-executes the test */
+        ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+        EXPECT_EXIT(Simple9::encodeArray(&input[0], 28U, &cdata[0], len),
+                        ::testing::ExitedWithCode(EXIT_FAILURE), "out of range");
+
+        /* Upper bits must not be dropped silently */
+        input[27] = (1ULL << 32) + 1;
+
+        EXPECT_EXIT(Simple9::encodeArray(&input[0], 28U, &cdata[0], len),
+                        ::testing::ExitedWithCode(EXIT_FAILURE), "out of range");
+}
@@ -0,0 +1,69 @@
+/*-----------------------------------------------------------------------------
+ *  VSEncodingBlocksANS_utest.cpp - A unit test for VSEncodingBlocksANS.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/VSEncodingBlocksANS.hpp"
+
+TEST(VSEncodingBlocksANSTest, ValidationEncodeRaw) {
+        uint32_t        len;
+        uint32_t        input[32];
+        uint32_t        output[32 + TAIL_MERGIN];
+        uint32_t        cdata[5 + TAIL_MERGIN];
+
+        for (int i = 0; i < 32; i++)
+                input[i] = 1;
+
+        /* Descriptors are too few to be coded */
+        VSEncodingBlocksANS::encodeArray(&input[0], 32U, &cdata[0], len);
+
+        EXPECT_EQ(5U, len);
+        EXPECT_EQ(0U, cdata[0] & 0xffff);
+
+        VSEncodingBlocksANS::decodeArray(&cdata[0], 5U, &output[0], 32U);
+
+        for (int i = 0; i < 32; i++)
+                EXPECT_EQ(1U, output[i]);
+}
+
+TEST(VSEncodingBlocksANSTest, ValidationEncodeSkewed) {
+        uint32_t        i;
+        uint32_t        len;
+        uint32_t        blen;
+        uint32_t        *input;
+        uint32_t        *output;
+        uint32_t        *cdata;
+
+        input = new uint32_t[100000];
+        output = new uint32_t[100000 + TAIL_MERGIN];
+        cdata = new uint32_t[200000 + TAIL_MERGIN];
+
+        /* Over two blocks, with many short partitions */
+        for (i = 0; i < 100000; i++)
+                input[i] = ((i * 2654435761U) >> 28 == 0)?
+                        (i * 2654435761U) & 0xfff : (i % 7) & 3;
+
+        VSEncodingBlocks::encodeArray(input, 100000U, cdata, blen);
+        VSEncodingBlocksANS::encodeArray(input, 100000U, cdata, len);
+
+        EXPECT_GT(blen, len);
+
+        VSEncodingBlocksANS::decodeArray(cdata, len, output, 100000U);
+
+        for (i = 0; i < 100000; i++)
+                EXPECT_EQ(input[i], output[i]);
+
+        delete[] input;
+        delete[] output;
+        delete[] cdata;
+}
@@ -585,3 +585,62 @@ TEST(VSEncodingBlocksTest, ValidationEncode32b_2p) {
                 EXPECT_EQ(214483648U, output[i]);
 }
 
+
+TEST(VSEncodingBlocksTest, DecodeCost) {
+        uint32_t        len;
+        uint32_t        nd;
+        uint32_t        input[128];
+        uint32_t        output[128];
+        uint32_t        cdata[128 + TAIL_MERGIN];
+        double          intNs[16] = {0.0};
+
+        /* Runs of 4 integers form partitions by themselves */
+        for (int i = 0; i < 128; i++)
+                input[i] = ((i / 4) & 1)? 1U << 19 : 0;
+
+        VSEncodingBlocks::encodeArray(&input[0], 128U, &cdata[0], len);
+        nd = len - VSEncodingBlocks::descOffset(&cdata[0]);
+
+        EXPECT_EQ(8U, nd);
+
+        /* Costly partitions are merged, though they are larger */
+        VSEncodingBlocks::setDecodeCost(100.0, 10.0, intNs);
+        VSEncodingBlocks::encodeArray(&input[0], 128U, &cdata[0], len);
+        VSEncodingBlocks::setDecodeCost(0.0);
+
+        EXPECT_GT(nd, len - VSEncodingBlocks::descOffset(&cdata[0]));
+
+        VSEncodingBlocks::decodeArray(&cdata[0], len, &output[0], 128U);
+
+        for (int i = 0; i < 128; i++)
+                EXPECT_EQ(input[i], output[i]);
+
+        VSEncodingBlocks::encodeArray(&input[0], 128U, &cdata[0], len);
+
+        EXPECT_EQ(nd, len - VSEncodingBlocks::descOffset(&cdata[0]));
+}
+
+TEST(VSEncodingBlocksTest, FastPartition) {
+        uint32_t        len;
+        uint32_t        flen;
+        uint32_t        input[1000];
+        uint32_t        output[1000];
+        uint32_t        cdata[2000 + TAIL_MERGIN];
+
+        for (int i = 0; i < 1000; i++)
+                input[i] = (i % 37 < 9)? 0 : (i * 2654435761U) >> (5 + i % 27);
+
+        VSEncodingBlocks::encodeArray(&input[0], 1000U, &cdata[0], len);
+
+        /* Not smaller than the optimal partitions, and restored */
+        VSEncodingBlocks::setFastPartition(true);
+        VSEncodingBlocks::encodeArray(&input[0], 1000U, &cdata[0], flen);
+        VSEncodingBlocks::setFastPartition(false);
+
+        EXPECT_GE(flen, len);
+
+        VSEncodingBlocks::decodeArray(&cdata[0], flen, &output[0], 1000U);
+
+        for (int i = 0; i < 1000; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
@@ -35,3 +35,48 @@ TEST(VSEncodingSimpleV1Test, ValidationEncode1b) {
                 EXPECT_EQ(1U, output[i]);
 }
 
+
+TEST(VSEncodingSimpleV1Test, ValidationEncode10b_12) {
+        int             i;
+        uint32_t        len;
+        uint32_t        input[13];
+        uint32_t        output[13 + TAIL_MERGIN];
+        uint32_t        cdata[16 + TAIL_MERGIN];
+
+        /* A partition of 12 integers with 10 bits is followed by another */
+        for (i = 0; i < 13; i++)
+                input[i] = (i < 12)? 1000 : 0x80000000U;
+
+        VSEncodingSimpleV1::encodeArray(&input[0], 13U, &cdata[0], len);
+        VSEncodingSimpleV1::decodeArray(&cdata[0], len, &output[0], 13U);
+
+        for (i = 0; i < 13; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(VSEncodingSimpleV1Test, RandomAccess) {
+        int             i;
+        uint32_t        len;
+        uint32_t        isize;
+        uint32_t        *idx;
+        uint32_t        input[4096];
+        uint32_t        output[4096];
+        uint32_t        cdata[8192 + TAIL_MERGIN];
+
+        for (i = 0; i < 4096; i++)
+                input[i] = (i * 2654435761U) >> (i % 29 + 3);
+
+        VSEncodingSimpleV1::encodeArray(&input[0], 4096U, &cdata[0], len);
+
+        idx = VSEncodingSimpleV1::buildIndex(&cdata[0], 4096U, isize);
+
+        for (i = 0; i < 4096; i++)
+                EXPECT_EQ(input[i], VSEncodingSimpleV1::get(&cdata[0], idx, isize, i));
+
+        VSEncodingSimpleV1::decodeRange(&cdata[0], idx, isize, 1000U, 3001U, &output[0]);
+
+        for (i = 1000; i < 3001; i++)
+                EXPECT_EQ(input[i], output[i - 1000]);
+
+        delete[] idx;
+}
@@ -19,7 +19,7 @@ TEST(VSEncodingSimpleV2Test, ValidationEncode1b) {
         int             i;
         uint32_t        len;
         uint32_t        input[256];
-        uint32_t        output[256];
+        uint32_t        output[256 + TAIL_MERGIN];
         uint32_t        cdata[2 + TAIL_MERGIN];
 
         for (i = 0; i < 256; i++)
@@ -35,3 +35,101 @@ TEST(VSEncodingSimpleV2Test, ValidationEncode1b) {
                 EXPECT_EQ(1U, output[i]);
 }
 
+TEST(VSEncodingSimpleV2Test, ValidationEncode64b) {
+        int             i;
+        uint32_t        len;
+        uint64_t        input[256];
+        uint64_t        output[256 + TAIL_MERGIN];
+        uint32_t        cdata[512 + TAIL_MERGIN];
+
+        for (i = 0; i < 256; i++)
+                input[i] = (i < 128)? i : (1ULL << 48) + i;
+
+        VSEncodingSimpleV2::encodeArray(&input[0], 256U, &cdata[0], len);
+        VSEncodingSimpleV2::decodeArray(&cdata[0], len, &output[0], 256U);
+
+        for (i = 0; i < 256; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(VSEncodingSimpleV2Test, RandomAccess) {
+        int             i;
+        uint32_t        len;
+        uint32_t        isize;
+        uint32_t        *idx;
+        uint32_t        input[4096];
+        uint32_t        output[4096];
+        uint32_t        cdata[8192 + TAIL_MERGIN];
+
+        for (i = 0; i < 4096; i++)
+                input[i] = (i * 2654435761U) >> (i % 29 + 3);
+
+        VSEncodingSimpleV2::encodeArray(&input[0], 4096U, &cdata[0], len);
+
+        idx = VSEncodingSimpleV2::buildIndex(&cdata[0], 4096U, isize);
+
+        for (i = 0; i < 4096; i++)
+                EXPECT_EQ(input[i], VSEncodingSimpleV2::get(&cdata[0], idx, isize, i));
+
+        VSEncodingSimpleV2::decodeRange(&cdata[0], idx, isize, 1000U, 3001U, &output[0]);
+
+        for (i = 1000; i < 3001; i++)
+                EXPECT_EQ(input[i], output[i - 1000]);
+
+        delete[] idx;
+}
+
+TEST(VSEncodingSimpleV2Test, DecodeCost) {
+        int             i;
+        uint32_t        len;
+        uint32_t        np;
+        uint32_t        input[512];
+        uint32_t        output[512];
+        uint32_t        cdata[1024 + TAIL_MERGIN];
+        double          intNs[16] = {0.0};
+
+        for (i = 0; i < 512; i++)
+                input[i] = ((i / 64) & 1)? 0x80000000U | i : 0;
+
+        /* Words for 8-bit Ks tell # of partitions */
+        VSEncodingSimpleV2::encodeArray(&input[0], 512U, &cdata[0], len);
+        np = cdata[1] - cdata[0];
+
+        EXPECT_EQ(2U, np);
+
+        VSEncodingSimpleV2::setDecodeCost(100.0, 20.0, intNs);
+        VSEncodingSimpleV2::encodeArray(&input[0], 512U, &cdata[0], len);
+        VSEncodingSimpleV2::setDecodeCost(0.0);
+
+        EXPECT_GT(np, cdata[1] - cdata[0]);
+
+        VSEncodingSimpleV2::decodeArray(&cdata[0], len, &output[0], 512U);
+
+        for (i = 0; i < 512; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
+
+TEST(VSEncodingSimpleV2Test, FastPartition) {
+        int             i;
+        uint32_t        len;
+        uint32_t        flen;
+        uint32_t        input[1000];
+        uint32_t        output[1000];
+        uint32_t        cdata[2000 + TAIL_MERGIN];
+
+        for (i = 0; i < 1000; i++)
+                input[i] = (i % 37 < 9)? 0 : (i * 2654435761U) >> (5 + i % 27);
+
+        VSEncodingSimpleV2::encodeArray(&input[0], 1000U, &cdata[0], len);
+
+        VSEncodingSimpleV2::setFastPartition(true);
+        VSEncodingSimpleV2::encodeArray(&input[0], 1000U, &cdata[0], flen);
+        VSEncodingSimpleV2::setFastPartition(false);
+
+        EXPECT_GE(flen, len);
+
+        VSEncodingSimpleV2::decodeArray(&cdata[0], flen, &output[0], 1000U);
+
+        for (i = 0; i < 1000; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
@@ -0,0 +1,160 @@
+/*-----------------------------------------------------------------------------
+ *  VSEncoding_utest.cpp - A unit test for VSEncoding.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "compress/VSEncoding.hpp"
+
+#define N               20000
+#define FIXCOST         8
+
+/* The same lengths as VSEncodingBlocks */
+static uint32_t __lens[] = {
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+};
+
+static uint32_t __zlens[] = {
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 16, 32
+};
+
+/* Widths in runs, as logs of d-gaps in a list */
+static void
+__make_logs(uint32_t *logs, uint32_t n)
+{
+        uint32_t        i;
+        uint32_t        k;
+        uint32_t        b;
+        uint32_t        run;
+
+        for (i = 0; i < n; ) {
+                run = 1 + rand() % 40;
+                b = (rand() % 3 == 0)? 0 : rand() % 20;
+
+                for (k = 0; k < run && i < n; k++, i++)
+                        logs[i] = (b == 0)? 0 : b - rand() % ((b + 1) / 2);
+        }
+}
+
+/* A size of a partition, which fails if a block is impossible */
+static uint64_t
+__part_cost(uint32_t *logs, uint32_t *part, uint32_t psize,
+                uint32_t *lens, uint32_t *zlens, uint32_t nlens, bool aligned)
+{
+        uint32_t        i;
+        uint32_t        j;
+        uint32_t        k;
+        uint32_t        n;
+        uint32_t        maxB;
+        uint32_t        *poss;
+        uint64_t        cost;
+
+        for (i = 0, cost = 0; i < psize; i++) {
+                n = part[i + 1] - part[i];
+
+                for (j = part[i], maxB = 0; j < part[i + 1]; j++)
+                        maxB = std::max(maxB, logs[j]);
+
+                poss = (zlens != NULL && maxB == 0)? zlens : lens;
+
+                for (k = 0; k < nlens && poss[k] != n; k++) ;
+                EXPECT_LT(k, nlens) << "block of " << n << " at " << part[i];
+
+                cost += ((aligned)? int_utils::div_roundup(n * maxB, 32) :
+                                n * maxB) + FIXCOST;
+        }
+
+        return cost;
+}
+
+/* Sizes in the fast mode are within the bound from the optimal ones */
+TEST(VSEncodingTest, FastPartition) {
+        uint32_t        i;
+        uint32_t        psize;
+        uint32_t        fsize;
+        uint32_t        *part;
+        uint32_t        *fpart;
+        uint64_t        opt;
+        uint64_t        cost;
+        uint32_t        logs[N];
+
+        srand(0);
+        __make_logs(logs, N);
+
+        VSEncoding      vse(__lens, __zlens, 16, false);
+
+        part = vse.compute_OptPartition(logs, N, FIXCOST, psize);
+
+        vse.setFastMode(true);
+        fpart = vse.compute_OptPartition(logs, N, FIXCOST, fsize);
+
+        ASSERT_EQ(0U, fpart[0]);
+        ASSERT_EQ((uint32_t)N, fpart[fsize]);
+
+        for (i = 0; i < fsize; i++)
+                ASSERT_LT(fpart[i], fpart[i + 1]);
+
+        opt = __part_cost(logs, part, psize, __lens, __zlens, 16, false);
+        cost = __part_cost(logs, fpart, fsize, __lens, __zlens, 16, false);
+
+        EXPECT_GE(cost, opt);
+        EXPECT_LE(cost, opt + (uint64_t)psize * 5 * FIXCOST);
+
+        /* Back to the exact one */
+        vse.setFastMode(false);
+
+        delete[] fpart;
+        fpart = vse.compute_OptPartition(logs, N, FIXCOST, fsize);
+
+        ASSERT_EQ(psize, fsize);
+        EXPECT_EQ(0, memcmp(part, fpart, (psize + 1) * sizeof(uint32_t)));
+
+        delete[] part;
+        delete[] fpart;
+}
+
+/* Aligned sizes with 1 to 256 integers, as VSEncodingSimpleV2 */
+TEST(VSEncodingTest, FastPartitionAligned) {
+        uint32_t        i;
+        uint32_t        psize;
+        uint32_t        fsize;
+        uint32_t        *part;
+        uint32_t        *fpart;
+        uint64_t        opt;
+        uint64_t        cost;
+        uint32_t        lens[256];
+        uint32_t        logs[N];
+
+        for (i = 0; i < 256; i++)
+                lens[i] = i + 1;
+
+        srand(1);
+        __make_logs(logs, N);
+
+        VSEncoding      vse(lens, NULL, 256, true);
+
+        part = vse.compute_OptPartition(logs, N, FIXCOST, psize);
+
+        vse.setFastMode(true);
+        fpart = vse.compute_OptPartition(logs, N, FIXCOST, fsize);
+
+        ASSERT_EQ((uint32_t)N, fpart[fsize]);
+
+        opt = __part_cost(logs, part, psize, lens, NULL, 256, true);
+        cost = __part_cost(logs, fpart, fsize, lens, NULL, 256, true);
+
+        EXPECT_GE(cost, opt);
+        EXPECT_LE(cost, opt + (uint64_t)psize * 8 * (FIXCOST + 1));
+
+        delete[] part;
+        delete[] fpart;
+}
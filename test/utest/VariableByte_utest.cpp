@@ -55,3 +55,19 @@ TEST(VariableByteTest, ValidationEncode2b) {
                 EXPECT_EQ(1U << 1, output[i]);
 }
 
+TEST(VariableByteTest, ValidationEncode64b) {
+        int             i;
+        uint32_t        len;
+        uint64_t        input[8];
+        uint64_t        output[8];
+        uint32_t        cdata[20];
+
+        for (i = 0; i < 8; i++)
+                input[i] = (1ULL << (8 * i + 6)) + i;
+
+        VariableByte::encodeArray(&input[0], 8U, &cdata[0], len);
+        VariableByte::decodeArray(&cdata[0], len, &output[0], 8U);
+
+        for (i = 0; i < 8; i++)
+                EXPECT_EQ(input[i], output[i]);
+}
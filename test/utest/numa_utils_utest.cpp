@@ -0,0 +1,59 @@
+/*-----------------------------------------------------------------------------
+ *  numa_utils_utest.cpp - A unit test for numa_utils.
+ *
+ *  Coding-Style:
+ *      emacs) Mode: C, tab-width: 8, c-basic-offset: 8, indent-tabs-mode: nil
+ *      vi) tabstop: 8, expandtab
+ *
+ *  Authors:
+ *      Takeshi Yamamuro <linguin.m.s_at_gmail.com>
+ *      Fabrizio Silvestri <fabrizio.silvestri_at_isti.cnr.it>
+ *      Rossano Venturini <rossano.venturini_at_isti.cnr.it>
+ *-----------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "utils/numa_utils.hpp"
+
+#define LEN     (1U << 20)
+
+TEST(NumaUtilsTest, AllocOnNode) {
+        uint32_t        i;
+        uint32_t        node;
+        uint32_t        *adr;
+
+        ASSERT_GE(numa_utils::num_nodes(), 1U);
+
+        for (node = 0; node < numa_utils::num_nodes(); node++) {
+                adr = numa_utils::alloc_on_node(LEN * sizeof(uint32_t), node);
+
+                for (i = 0; i < LEN; i++)
+                        adr[i] = i;
+
+                /* It is unknown if get_mempolicy() is not permitted */
+                if (numa_utils::node_of(adr) != -1) {
+                        EXPECT_EQ((int)node, numa_utils::node_of(adr + LEN - 1));
+                }
+
+                for (i = 0; i < LEN; i++)
+                        ASSERT_EQ(i, adr[i]);
+
+                numa_utils::free_on_node(adr, LEN * sizeof(uint32_t));
+        }
+}
+
+TEST(NumaUtilsTest, PinThread) {
+        cpu_set_t       set;
+
+        /* Affinity is restored for tests after this one */
+        ASSERT_EQ(0, pthread_getaffinity_np(pthread_self(), sizeof(set), &set));
+
+        EXPECT_FALSE(numa_utils::pin_thread(NUMA_MAXNODES));
+
+        /* Node 0 exists with CPUs if sysfs has nodes */
+        if (access(NUMA_SYSFS "/node0/cpulist", R_OK) == 0) {
+                EXPECT_TRUE(numa_utils::pin_thread(0));
+        }
+
+        EXPECT_EQ(0, pthread_setaffinity_np(pthread_self(), sizeof(set), &set));
+}